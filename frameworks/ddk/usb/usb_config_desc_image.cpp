@@ -0,0 +1,355 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "usb_config_desc_image.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+#include "edm_errors.h"
+#include "hilog_wrapper.h"
+#include "usb_config_desc_parser.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+constexpr uint32_t USB_CONFIG_IMAGE_MAGIC = 0x47464355; // "UCFG"
+constexpr uint16_t USB_CONFIG_IMAGE_VERSION = 1;
+constexpr uint8_t USB_CONFIG_IMAGE_LITTLE_ENDIAN = 1;
+constexpr uint8_t USB_CONFIG_IMAGE_BIG_ENDIAN = 2;
+constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325;
+constexpr uint64_t FNV_PRIME = 0x100000001b3;
+
+// The file starts with the header, followed by the arena of the configuration as laid out by the parser: the
+// configuration, the descriptor arrays and the raw descriptors. A pointer in the file holds its offset in the arena plus
+// one, so that zero still stands for a null pointer. The image is only valid for the pointer size and byte order of
+// the writer.
+struct alignas(alignof(std::max_align_t)) UsbConfigImageHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint8_t pointerSize;
+    uint8_t byteOrder;
+    int32_t parseResult;
+    uint32_t rawLen;
+    uint64_t arenaSize;
+    // FNV-1a of the arena as stored in the file
+    uint64_t checksum;
+};
+
+static uint8_t HostByteOrder()
+{
+    return __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ ? USB_CONFIG_IMAGE_LITTLE_ENDIAN : USB_CONFIG_IMAGE_BIG_ENDIAN;
+}
+
+static uint64_t Checksum(const uint8_t *data, size_t len)
+{
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (size_t i = 0; i < len; ++i) {
+        hash = (hash ^ data[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+template <typename T>
+static void StoreOffset(T *&field, const uint8_t *base)
+{
+    uintptr_t offset =
+        field == nullptr ? 0 : static_cast<uintptr_t>(reinterpret_cast<const uint8_t *>(field) - base) + 1;
+    field = reinterpret_cast<T *>(offset);
+}
+
+// Replaces every pointer in a parsed configuration by its offset in the arena. The children are converted before the
+// pointer to them.
+static void ConvertToOffsets(uint8_t *base)
+{
+    auto config = reinterpret_cast<UsbDdkConfigDescriptor *>(base);
+    for (uint8_t i = 0; i < config->configDescriptor.bNumInterfaces; ++i) {
+        UsbDdkInterface &usbInterface = config->interface[i];
+        for (uint8_t j = 0; j < usbInterface.numAltsetting; ++j) {
+            UsbDdkInterfaceDescriptor &altsetting = usbInterface.altsetting[j];
+            for (uint8_t k = 0; k < altsetting.interfaceDescriptor.bNumEndpoints; ++k) {
+                StoreOffset(altsetting.endPoint[k].extra, base);
+            }
+            StoreOffset(altsetting.endPoint, base);
+            StoreOffset(altsetting.extra, base);
+        }
+        StoreOffset(usbInterface.altsetting, base);
+    }
+    StoreOffset(config->interface, base);
+    StoreOffset(config->extra, base);
+}
+
+// Turns the offsets of a mapped image back into pointers. The image comes from a file, so every offset is checked
+// against the arena before it is followed, and the descriptor arrays must not overlap, which would relocate a pointer
+// twice. The checks run as a separate pass, so that a rejected image is never modified.
+class UsbConfigImageRelocator final {
+public:
+    UsbConfigImageRelocator(uint8_t *base, size_t arenaSize, size_t rawLen)
+        : base_(base), rawOffset_(arenaSize - rawLen), arenaSize_(arenaSize)
+    {
+    }
+
+    bool Check()
+    {
+        relocate_ = false;
+        if (!Walk()) {
+            return false;
+        }
+        std::sort(arrays_.begin(), arrays_.end());
+        for (size_t i = 1; i < arrays_.size(); ++i) {
+            if (arrays_[i - 1].second > arrays_[i].first) {
+                EDM_LOGE(MODULE_USB_DDK, "overlapping arrays at offset %{public}zu", arrays_[i].first);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void Relocate()
+    {
+        relocate_ = true;
+        (void)Walk();
+    }
+
+private:
+    bool Walk()
+    {
+        valid_ = true;
+        arrays_.clear();
+        auto config = reinterpret_cast<UsbDdkConfigDescriptor *>(base_);
+        arrays_.emplace_back(0, sizeof(UsbDdkConfigDescriptor));
+        ResolveBytes(config->extra, config->extraLength);
+        UsbDdkInterface *interfaces = ResolveArray(config->interface, config->configDescriptor.bNumInterfaces);
+        for (uint8_t i = 0; valid_ && i < config->configDescriptor.bNumInterfaces; ++i) {
+            UsbDdkInterfaceDescriptor *altsettings =
+                ResolveArray(interfaces[i].altsetting, interfaces[i].numAltsetting);
+            for (uint8_t j = 0; valid_ && j < interfaces[i].numAltsetting; ++j) {
+                UsbDdkInterfaceDescriptor &altsetting = altsettings[j];
+                ResolveBytes(altsetting.extra, altsetting.extraLength);
+                UsbDdkEndpointDescriptor *endPoints =
+                    ResolveArray(altsetting.endPoint, altsetting.interfaceDescriptor.bNumEndpoints);
+                for (uint8_t k = 0; valid_ && k < altsetting.interfaceDescriptor.bNumEndpoints; ++k) {
+                    ResolveBytes(endPoints[k].extra, endPoints[k].extraLength);
+                }
+            }
+        }
+        return valid_;
+    }
+
+    // Returns the array of count elements whose offset is stored in field, which must lie before the raw descriptors.
+    template <typename T>
+    T *ResolveArray(T *&field, size_t count)
+    {
+        uintptr_t offset = reinterpret_cast<uintptr_t>(field);
+        if (offset == 0) {
+            valid_ = valid_ && count == 0;
+            return nullptr;
+        }
+        size_t start = offset - 1;
+        if (start % alignof(T) != 0 || start > rawOffset_ || count > (rawOffset_ - start) / sizeof(T)) {
+            EDM_LOGE(MODULE_USB_DDK, "invalid array offset %{public}zu, count = %{public}zu", start, count);
+            valid_ = false;
+            return nullptr;
+        }
+        T *result = reinterpret_cast<T *>(base_ + start);
+        if (relocate_) {
+            field = result;
+        } else if (count > 0) {
+            arrays_.emplace_back(start, start + count * sizeof(T));
+        }
+        return result;
+    }
+
+    // Extra descriptors are runs of the raw descriptors at the end of the arena.
+    void ResolveBytes(const uint8_t *&field, uint32_t length)
+    {
+        uintptr_t offset = reinterpret_cast<uintptr_t>(field);
+        if (offset == 0) {
+            valid_ = valid_ && length == 0;
+            return;
+        }
+        size_t start = offset - 1;
+        if (start < rawOffset_ || start > arenaSize_ || length > arenaSize_ - start) {
+            EDM_LOGE(MODULE_USB_DDK, "invalid extra offset %{public}zu, length = %{public}u", start, length);
+            valid_ = false;
+            return;
+        }
+        if (relocate_) {
+            field = base_ + start;
+        }
+    }
+
+    uint8_t *base_;
+    size_t rawOffset_;
+    size_t arenaSize_;
+    bool relocate_ {false};
+    bool valid_ {true};
+    // [start, end) of every descriptor array, gathered by the check
+    std::vector<std::pair<size_t, size_t>> arrays_;
+};
+
+static bool WriteAll(int32_t fd, const uint8_t *data, size_t len)
+{
+    while (len > 0) {
+        ssize_t written = write(fd, data, len);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            EDM_LOGE(MODULE_USB_DDK, "write failed, errno=%{public}d", errno);
+            return false;
+        }
+        data += written;
+        len -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+int32_t WriteUsbConfigImage(int32_t fd, const std::vector<uint8_t> &configBuffer)
+{
+    std::vector<uint8_t> arena;
+    int32_t ret = ParseUsbConfigDescriptorToArena(configBuffer, arena);
+    if (ret < 0) {
+        return ret;
+    }
+    ConvertToOffsets(arena.data());
+
+    UsbConfigImageHeader header = {};
+    header.magic = USB_CONFIG_IMAGE_MAGIC;
+    header.version = USB_CONFIG_IMAGE_VERSION;
+    header.pointerSize = sizeof(void *);
+    header.byteOrder = HostByteOrder();
+    header.parseResult = ret;
+    header.rawLen = static_cast<uint32_t>(configBuffer.size());
+    header.arenaSize = arena.size();
+    header.checksum = Checksum(arena.data(), arena.size());
+    if (!WriteAll(fd, reinterpret_cast<const uint8_t *>(&header), sizeof(header)) ||
+        !WriteAll(fd, arena.data(), arena.size())) {
+        return USB_DDK_FAILED;
+    }
+    return EDM_OK;
+}
+
+int32_t WriteUsbConfigImage(const std::string &path, const std::vector<uint8_t> &configBuffer)
+{
+    std::string tmpPath = path + ".XXXXXX";
+    int32_t fd = mkstemp(tmpPath.data());
+    if (fd < 0) {
+        EDM_LOGE(MODULE_USB_DDK, "mkstemp failed, errno=%{public}d", errno);
+        return USB_DDK_FAILED;
+    }
+    int32_t ret = WriteUsbConfigImage(fd, configBuffer);
+    if (close(fd) != 0 && ret == EDM_OK) {
+        EDM_LOGE(MODULE_USB_DDK, "close failed, errno=%{public}d", errno);
+        ret = USB_DDK_FAILED;
+    }
+    if (ret == EDM_OK && rename(tmpPath.c_str(), path.c_str()) != 0) {
+        EDM_LOGE(MODULE_USB_DDK, "rename failed, errno=%{public}d", errno);
+        ret = USB_DDK_FAILED;
+    }
+    if (ret != EDM_OK) {
+        (void)unlink(tmpPath.c_str());
+    }
+    return ret;
+}
+
+static bool IsValidHeader(const UsbConfigImageHeader &header, size_t fileSize)
+{
+    if (header.magic != USB_CONFIG_IMAGE_MAGIC || header.version != USB_CONFIG_IMAGE_VERSION ||
+        header.pointerSize != sizeof(void *) || header.byteOrder != HostByteOrder()) {
+        EDM_LOGE(MODULE_USB_DDK, "unsupported config image, version = %{public}hu", header.version);
+        return false;
+    }
+    if (header.parseResult < 0 || header.arenaSize != fileSize - sizeof(header) ||
+        header.arenaSize % alignof(UsbDdkConfigDescriptor) != 0 ||
+        header.arenaSize < sizeof(UsbDdkConfigDescriptor) + static_cast<uint64_t>(header.rawLen)) {
+        EDM_LOGE(MODULE_USB_DDK, "invalid config image, arenaSize = %{public}" PRIu64, header.arenaSize);
+        return false;
+    }
+    return true;
+}
+
+int32_t MapUsbConfigImage(int32_t fd, UsbConfigImage &image)
+{
+    struct stat st = {};
+    if (fstat(fd, &st) != 0) {
+        EDM_LOGE(MODULE_USB_DDK, "fstat failed, errno=%{public}d", errno);
+        return USB_DDK_FAILED;
+    }
+    if (st.st_size < static_cast<off_t>(sizeof(UsbConfigImageHeader) + sizeof(UsbDdkConfigDescriptor))) {
+        EDM_LOGE(MODULE_USB_DDK, "config image too short, size = %{public}lld", static_cast<long long>(st.st_size));
+        return USB_DDK_INVALID_OPERATION;
+    }
+
+    // a private mapping, so that only the pages holding pointers become copies when they are relocated
+    size_t size = static_cast<size_t>(st.st_size);
+    auto base = static_cast<uint8_t *>(mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0));
+    if (base == MAP_FAILED) {
+        EDM_LOGE(MODULE_USB_DDK, "mmap failed, errno=%{public}d", errno);
+        return USB_DDK_MEMORY_ERROR;
+    }
+    auto header = reinterpret_cast<const UsbConfigImageHeader *>(base);
+    uint8_t *arena = base + sizeof(UsbConfigImageHeader);
+    bool valid = IsValidHeader(*header, size) && Checksum(arena, header->arenaSize) == header->checksum;
+    UsbConfigImageRelocator relocator(arena, header->arenaSize, header->rawLen);
+    if (!valid || !relocator.Check()) {
+        EDM_LOGE(MODULE_USB_DDK, "config image rejected");
+        (void)munmap(base, size);
+        return USB_DDK_INVALID_OPERATION;
+    }
+    relocator.Relocate();
+    if (mprotect(base, size, PROT_READ) != 0) {
+        EDM_LOGW(MODULE_USB_DDK, "mprotect failed, errno=%{public}d", errno);
+    }
+
+    image.config = reinterpret_cast<UsbDdkConfigDescriptor *>(arena);
+    image.parseResult = header->parseResult;
+    image.raw = arena + header->arenaSize - header->rawLen;
+    image.rawLen = header->rawLen;
+    return EDM_OK;
+}
+
+int32_t MapUsbConfigImage(const std::string &path, UsbConfigImage &image)
+{
+    int32_t fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        // no image has been written for this configuration yet
+        return USB_DDK_FAILED;
+    }
+    int32_t ret = MapUsbConfigImage(fd, image);
+    // the mapping keeps the file alive
+    (void)close(fd);
+    return ret;
+}
+
+void UnmapUsbConfigImage(UsbDdkConfigDescriptor * const config)
+{
+    if (config == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "config is nullptr");
+        return;
+    }
+    auto base = reinterpret_cast<uint8_t *>(config) - sizeof(UsbConfigImageHeader);
+    size_t size = sizeof(UsbConfigImageHeader) + reinterpret_cast<const UsbConfigImageHeader *>(base)->arenaSize;
+    if (munmap(base, size) != 0) {
+        EDM_LOGE(MODULE_USB_DDK, "munmap failed, errno=%{public}d", errno);
+    }
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
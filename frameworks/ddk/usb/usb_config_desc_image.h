@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef USB_CONFIG_DESC_IMAGE_H
+#define USB_CONFIG_DESC_IMAGE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "usb_ddk_types.h"
+namespace OHOS {
+namespace ExternalDeviceManager {
+// A configuration image is a parsed configuration stored as a file, so that it can be mapped instead of being loaded
+// from the DDK service and parsed again. The pointers in the file are offsets into the image, which are relocated when
+// it is mapped; the raw descriptors at the end of the image stay shared with the page cache.
+struct UsbConfigImage {
+    UsbDdkConfigDescriptor *config;
+    // result of parsing, a positive value is the number of bytes that were not parsed
+    int32_t parseResult;
+    // the raw descriptors inside the image
+    const uint8_t *raw;
+    size_t rawLen;
+};
+
+int32_t WriteUsbConfigImage(int32_t fd, const std::vector<uint8_t> &configBuffer);
+// Writes the image to a temporary file that is renamed to path, so that readers never map a partial image.
+int32_t WriteUsbConfigImage(const std::string &path, const std::vector<uint8_t> &configBuffer);
+// Maps an image read-only. The configuration must be released by UnmapUsbConfigImage.
+int32_t MapUsbConfigImage(int32_t fd, UsbConfigImage &image);
+int32_t MapUsbConfigImage(const std::string &path, UsbConfigImage &image);
+void UnmapUsbConfigImage(UsbDdkConfigDescriptor * const config);
+} // namespace ExternalDeviceManager
+} // namespace OHOS
+#endif // USB_CONFIG_DESC_IMAGE_H
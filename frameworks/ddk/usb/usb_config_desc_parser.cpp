@@ -14,9 +14,17 @@
  */
 #include "usb_config_desc_parser.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <string_view>
+#include <unordered_map>
+
 #include "edm_errors.h"
 #include "hilog_wrapper.h"
 #include "securec.h"
+#include "usb_ddk_descriptor_traits.h"
 #include "usb_ddk_types.h"
 
 namespace OHOS {
@@ -26,89 +34,78 @@ struct UsbDescriptorHeader {
     uint8_t bDescriptorType;
 } __attribute__((packed));
 
-enum UsbDdkDescriptorType {
-    USB_DDK_CONFIG_DESCRIPTOR_TYPE,
-    USB_DDK_INTERFACE_DESCRIPTOR_TYPE,
-    USB_DDK_ENDPOINT_DESCRIPTOR_TYPE,
-    USB_DDK_AUDIO_ENDPOINT_DESCRIPTOR_TYPE,
-};
-
 constexpr int32_t USB_MAXENDPOINTS = 32;
 constexpr int32_t USB_MAXALTSETTING = 128;
 constexpr int32_t DESC_HEADER_LENGTH = 2;
 constexpr int32_t USB_MAXINTERFACES = 32;
-constexpr int32_t USB_DDK_DT_CONFIG_SIZE = 0x09;
-constexpr int32_t USB_DDK_DT_INTERFACE_SIZE = 0x09;
-constexpr int32_t USB_DDK_DT_ENDPOINT_SIZE = 0x07;
-constexpr int32_t USB_DDK_DT_CONFIG = 0x02;
-constexpr int32_t USB_DDK_DT_INTERFACE = 0x04;
-constexpr int32_t USB_DDK_DT_ENDPOINT = 0x05;
-
-static uint16_t Le16ToHost(uint16_t number)
-{
-    uint8_t *addr = reinterpret_cast<uint8_t *>(&number);
-    uint16_t result = static_cast<uint16_t>(addr[1] << 8) | addr[0];
-    return result;
-}
-
-static int32_t GetDescriptorLength(UsbDdkDescriptorType descriptorType)
-{
-    switch (descriptorType) {
-        case USB_DDK_CONFIG_DESCRIPTOR_TYPE:
-            return USB_DDK_DT_CONFIG_SIZE;
-        case USB_DDK_INTERFACE_DESCRIPTOR_TYPE:
-            return USB_DDK_DT_INTERFACE_SIZE;
-        case USB_DDK_ENDPOINT_DESCRIPTOR_TYPE:
-            return USB_DDK_DT_ENDPOINT_SIZE;
-        default:
-            EDM_LOGE(MODULE_USB_DDK, "invalid descriptorType:%{public}d", descriptorType);
-    }
-    return INT32_MAX;
-}
+constexpr int32_t USB_DDK_DT_CONFIG_SIZE = UsbDescriptorTraits<UsbConfigDescriptor>::MIN_LENGTH;
+constexpr int32_t USB_DDK_DT_INTERFACE_SIZE = UsbDescriptorTraits<UsbInterfaceDescriptor>::MIN_LENGTH;
+constexpr int32_t USB_DDK_DT_ENDPOINT_SIZE = UsbDescriptorTraits<UsbEndpointDescriptor>::MIN_LENGTH;
+constexpr int32_t USB_DDK_DT_CONFIG = UsbDescriptorTraits<UsbConfigDescriptor>::TYPE;
+constexpr int32_t USB_DDK_DT_INTERFACE = UsbDescriptorTraits<UsbInterfaceDescriptor>::TYPE;
+constexpr int32_t USB_DDK_DT_ENDPOINT = UsbDescriptorTraits<UsbEndpointDescriptor>::TYPE;
+
+// A parsed configuration lives in one allocation. The descriptor arrays are taken from the front of it, followed by
+// one copy of the raw descriptors. Extra descriptors are runs of the raw descriptors, so they point into that copy
+// instead of being copied one by one. An interface parsed on its own points into the source instead, which its owner
+// keeps alive.
+struct UsbConfigArena {
+    uint8_t *next;
+    uint8_t *arrayEnd;
+    const uint8_t *source;
+    size_t sourceLen;
+    const uint8_t *copy;
+};
 
-static int32_t ParseDescriptor(
-    UsbDdkDescriptorType descriptorType, uint8_t *dest, uint32_t destLen, const uint8_t *source, int32_t sourceLen)
-{
-    if (source == nullptr || dest == nullptr) {
-        EDM_LOGE(
-            MODULE_USB_DDK, "invalid param, source:%{public}d, dest:%{public}d", source == nullptr, dest == nullptr);
-        return USB_DDK_FAILED;
-    }
+// Counts gathered by the sizing pass, from which the layout of the arena is computed.
+struct UsbConfigLayout {
+    UsbConfigDescriptor configDesc;
+    std::vector<uint8_t> interfaceNums;
+    std::vector<uint8_t> alternateSetting;
+    size_t numEndpoints = 0;
+    size_t arenaSize = 0;
+};
 
-    int32_t descriptorLen = GetDescriptorLength(descriptorType);
-    if (descriptorLen == INT32_MAX) {
-        return USB_DDK_FAILED;
-    }
+// Parsed configurations are interned: identical raw descriptors, as reported by identical devices, share one
+// immutable parsed configuration. The header is placed in front of the configuration in its arena.
+struct alignas(alignof(std::max_align_t)) UsbInternedConfigHeader {
+    // guarded by g_internMutex
+    uint32_t refCount;
+    int32_t parseResult;
+    size_t hash;
+    const uint8_t *raw;
+    size_t rawLen;
+};
 
-    if (sourceLen < descriptorLen) {
-        EDM_LOGE(MODULE_USB_DDK, "invalid sourceLen:%{public}u, descriptorType:%{public}d", sourceLen, descriptorType);
-        return USB_DDK_FAILED;
-    }
+static std::mutex g_internMutex;
+static std::unordered_multimap<size_t, UsbInternedConfigHeader *> g_internedConfigs;
 
-    int32_t ret = memcpy_s(dest, destLen, source, descriptorLen);
-    if (ret != EOK) {
-        EDM_LOGE(MODULE_USB_DDK, "memcpy_s failed, ret = %{public}d", ret);
-        return USB_DDK_MEMORY_ERROR;
+template <typename T>
+static T *ArenaAlloc(UsbConfigArena &arena, size_t count)
+{
+    size_t len = sizeof(T) * count;
+    if (len > static_cast<size_t>(arena.arrayEnd - arena.next)) {
+        EDM_LOGE(MODULE_USB_DDK, "config arena exhausted, len = %{public}zu", len);
+        return nullptr;
     }
+    T *result = reinterpret_cast<T *>(arena.next);
+    arena.next += len;
+    return result;
+}
 
-    switch (descriptorType) {
-        case USB_DDK_CONFIG_DESCRIPTOR_TYPE: {
-            struct UsbConfigDescriptor *desc = reinterpret_cast<struct UsbConfigDescriptor *>(dest);
-            desc->wTotalLength = Le16ToHost(desc->wTotalLength);
-            break;
-        }
-        case USB_DDK_INTERFACE_DESCRIPTOR_TYPE:
-            break;
-        case USB_DDK_ENDPOINT_DESCRIPTOR_TYPE: {
-            UsbEndpointDescriptor *desc = reinterpret_cast<UsbEndpointDescriptor *>(dest);
-            desc->wMaxPacketSize = Le16ToHost(desc->wMaxPacketSize);
-            break;
-        }
-        default:
-            EDM_LOGE(MODULE_USB_DDK, "invalid descriptorType:%{public}d", descriptorType);
-            return USB_DDK_FAILED;
-    }
-    return EDM_OK;
+static size_t ArenaSize(const UsbConfigLayout &layout, size_t descriptorLen)
+{
+    size_t numAltsetting = 0;
+    for (auto count : layout.alternateSetting) {
+        numAltsetting += count;
+    }
+    // every descriptor structure contains pointers, so the arrays stay aligned one after another, and rounding up
+    // keeps the next arena aligned when several configurations share one allocation
+    size_t size = sizeof(UsbDdkConfigDescriptor) + sizeof(UsbDdkInterface) * layout.interfaceNums.size() +
+        sizeof(UsbDdkInterfaceDescriptor) * numAltsetting + sizeof(UsbDdkEndpointDescriptor) * layout.numEndpoints +
+        descriptorLen;
+    return (size + alignof(UsbDdkConfigDescriptor) - 1) / alignof(UsbDdkConfigDescriptor) *
+        alignof(UsbDdkConfigDescriptor);
 }
 
 static int32_t FindNextDescriptor(const uint8_t *buffer, int32_t size)
@@ -120,6 +117,10 @@ static int32_t FindNextDescriptor(const uint8_t *buffer, int32_t size)
         if (header->bDescriptorType == USB_DDK_DT_INTERFACE || header->bDescriptorType == USB_DDK_DT_ENDPOINT) {
             break;
         }
+        if (header->bLength < sizeof(UsbDescriptorHeader) || header->bLength > size) {
+            EDM_LOGW(MODULE_USB_DDK, "invalid descriptor length %{public}hhu", header->bLength);
+            break;
+        }
         buffer += header->bLength;
         size -= header->bLength;
     }
@@ -127,46 +128,50 @@ static int32_t FindNextDescriptor(const uint8_t *buffer, int32_t size)
     return buffer - buffer0;
 }
 
-static int32_t FillExtraDescriptor(
-    const unsigned char **extra, uint32_t *extraLength, const uint8_t *buffer, int32_t bufferLen)
+static const uint8_t *ArenaCopyOf(const UsbConfigArena &arena, const uint8_t *buffer, int32_t bufferLen)
 {
-    if (bufferLen == 0) {
-        EDM_LOGE(MODULE_USB_DDK, "invalid param");
-        return USB_DDK_FAILED;
-    }
-
-    uint32_t extraLenTmp = *extraLength + static_cast<uint32_t>(bufferLen);
-    unsigned char *extraTmp = new unsigned char[extraLenTmp];
-    if (extraTmp == nullptr) {
-        EDM_LOGE(MODULE_USB_DDK, "new failed");
-        return USB_DDK_MEMORY_ERROR;
+    if (bufferLen <= 0 || buffer < arena.source ||
+        static_cast<size_t>(buffer - arena.source) + static_cast<size_t>(bufferLen) > arena.sourceLen) {
+        EDM_LOGE(MODULE_USB_DDK, "invalid param, bufferLen = %{public}d", bufferLen);
+        return nullptr;
     }
-    (void)memset_s(static_cast<void *>(extraTmp), extraLenTmp, 0, extraLenTmp);
+    return arena.copy + (buffer - arena.source);
+}
 
-    if (*extra != nullptr && *extraLength != 0) {
-        if (memcpy_s(extraTmp, extraLenTmp, *extra, *extraLength) != EOK) {
-            EDM_LOGE(MODULE_USB_DDK, "copy extra failed");
-            delete[] extraTmp;
-            return USB_DDK_MEMORY_ERROR;
-        }
+static int32_t FillExtraDescriptor(UsbConfigArena &arena, const unsigned char **extra, uint32_t *extraLength,
+    const uint8_t *buffer, int32_t bufferLen)
+{
+    const uint8_t *copy = ArenaCopyOf(arena, buffer, bufferLen);
+    if (copy == nullptr) {
+        return USB_DDK_FAILED;
     }
+    *extra = copy;
+    *extraLength = static_cast<uint32_t>(bufferLen);
+    return EDM_OK;
+}
 
-    if (memcpy_s(extraTmp + *extraLength, extraLenTmp - *extraLength, buffer, bufferLen) != EOK) {
-        EDM_LOGE(MODULE_USB_DDK, "copy buffer failed");
-        delete[] extraTmp;
-        return USB_DDK_MEMORY_ERROR;
+static int32_t AppendConfigExtraDescriptor(
+    UsbConfigArena &arena, UsbDdkConfigDescriptor &config, const uint8_t *buffer, int32_t bufferLen)
+{
+    const uint8_t *copy = ArenaCopyOf(arena, buffer, bufferLen);
+    if (copy == nullptr) {
+        return USB_DDK_FAILED;
     }
-
-    if (*extra != nullptr) {
-        delete[] (*extra);
-        *extra = extraTmp;
-        *extraLength = extraLenTmp;
+    if (config.extra == nullptr) {
+        config.extra = copy;
+        config.extraLength = static_cast<uint32_t>(bufferLen);
+    } else if (config.extra + config.extraLength == copy) {
+        config.extraLength += static_cast<uint32_t>(bufferLen);
+    } else {
+        // interface descriptors always swallow the descriptors up to the next interface, so this only happens with
+        // malformed descriptors
+        EDM_LOGW(MODULE_USB_DDK, "discontiguous configuration extra of %{public}d bytes ignored", bufferLen);
     }
-
     return EDM_OK;
 }
 
-static int32_t ParseEndpoint(UsbDdkEndpointDescriptor *endPoint, const uint8_t *buffer, int32_t size)
+static int32_t ParseEndpoint(
+    UsbConfigArena &arena, UsbDdkEndpointDescriptor *endPoint, const uint8_t *buffer, int32_t size)
 {
     const uint8_t *buffer0 = buffer;
     int32_t len;
@@ -187,8 +192,7 @@ static int32_t ParseEndpoint(UsbDdkEndpointDescriptor *endPoint, const uint8_t *
         return USB_DDK_FAILED;
     }
 
-    ParseDescriptor(USB_DDK_ENDPOINT_DESCRIPTOR_TYPE, reinterpret_cast<uint8_t *>(endPoint),
-        sizeof(UsbEndpointDescriptor), buffer, size);
+    DecodeDescriptor(buffer, endPoint->endpointDescriptor);
 
     buffer += header->bLength;
     size -= header->bLength;
@@ -197,7 +201,7 @@ static int32_t ParseEndpoint(UsbDdkEndpointDescriptor *endPoint, const uint8_t *
     if (!len) {
         return buffer - buffer0;
     }
-    ret = FillExtraDescriptor(&endPoint->extra, &endPoint->extraLength, buffer, len);
+    ret = FillExtraDescriptor(arena, &endPoint->extra, &endPoint->extraLength, buffer, len);
     if (ret != EDM_OK) {
         EDM_LOGE(MODULE_USB_DDK, "FillExtraDescriptor failed");
         return ret;
@@ -205,15 +209,11 @@ static int32_t ParseEndpoint(UsbDdkEndpointDescriptor *endPoint, const uint8_t *
     return buffer + len - buffer0;
 }
 
-static int32_t RawParseDescriptor(
-    int32_t size, const uint8_t *buffer, UsbDdkDescriptorType bDescriptorType, UsbDdkInterfaceDescriptor &ddkIntfDesc)
+// The caller checks that size is at least USB_DDK_DT_INTERFACE_SIZE.
+static int32_t RawParseDescriptor(int32_t size, const uint8_t *buffer, UsbDdkInterfaceDescriptor &ddkIntfDesc)
 {
-    int32_t ret =
-        ParseDescriptor(bDescriptorType, (uint8_t *)&ddkIntfDesc, sizeof(UsbInterfaceDescriptor), buffer, size);
-    if (ret != EDM_OK) {
-        EDM_LOGE(MODULE_USB_DDK, "ParseDescriptor failed");
-        return ret;
-    }
+    int32_t ret = EDM_OK;
+    DecodeDescriptor(buffer, ddkIntfDesc.interfaceDescriptor);
     if ((ddkIntfDesc.interfaceDescriptor.bDescriptorType != USB_DDK_DT_INTERFACE) ||
         (ddkIntfDesc.interfaceDescriptor.bLength > size)) {
         EDM_LOGE(MODULE_USB_DDK, "unexpected descriptor: type = 0x%{public}x, size = %{public}d",
@@ -229,23 +229,22 @@ static int32_t RawParseDescriptor(
     return ret;
 }
 
-static int32_t ParseInterfaceEndpoint(UsbDdkInterfaceDescriptor &ddkIntfDesc, const uint8_t **buffer, int32_t *size)
+static int32_t ParseInterfaceEndpoint(
+    UsbConfigArena &arena, UsbDdkInterfaceDescriptor &ddkIntfDesc, const uint8_t **buffer, int32_t *size)
 {
     UsbDdkEndpointDescriptor *endPoint = nullptr;
     int32_t ret = EDM_OK;
 
     if (ddkIntfDesc.interfaceDescriptor.bNumEndpoints > 0) {
-        endPoint = new UsbDdkEndpointDescriptor[ddkIntfDesc.interfaceDescriptor.bNumEndpoints];
+        endPoint = ArenaAlloc<UsbDdkEndpointDescriptor>(arena, ddkIntfDesc.interfaceDescriptor.bNumEndpoints);
         if (endPoint == nullptr) {
             ret = USB_DDK_MEMORY_ERROR;
             return ret;
         }
-        auto len = ddkIntfDesc.interfaceDescriptor.bNumEndpoints * sizeof(UsbDdkEndpointDescriptor);
-        (void)memset_s(static_cast<void *>(endPoint), len, 0, len);
 
         ddkIntfDesc.endPoint = endPoint;
         for (uint8_t i = 0; i < ddkIntfDesc.interfaceDescriptor.bNumEndpoints; i++) {
-            ret = ParseEndpoint(endPoint + i, *buffer, *size);
+            ret = ParseEndpoint(arena, endPoint + i, *buffer, *size);
             if (ret == 0) {
                 ddkIntfDesc.interfaceDescriptor.bNumEndpoints = i;
                 break;
@@ -260,14 +259,17 @@ static int32_t ParseInterfaceEndpoint(UsbDdkInterfaceDescriptor &ddkIntfDesc, co
     return ret;
 }
 
-static void GetInterfaceNumberDes(
-    const UsbDescriptorHeader *header, std::vector<uint8_t> &interfaceNums, std::vector<uint8_t> &alternateSetting)
+static void GetInterfaceNumberDes(const UsbDescriptorHeader *header, UsbConfigLayout &layout)
 {
     auto desc = reinterpret_cast<const UsbInterfaceDescriptor *>(header);
     if (desc->bLength < USB_DDK_DT_INTERFACE_SIZE) {
         EDM_LOGW(MODULE_USB_DDK, "invalid interface descriptor length %{public}d, skipping", desc->bLength);
         return;
     }
+    std::vector<uint8_t> &interfaceNums = layout.interfaceNums;
+    std::vector<uint8_t> &alternateSetting = layout.alternateSetting;
+    // interfaces with more endpoints are rejected while parsing
+    layout.numEndpoints += std::min<size_t>(desc->bNumEndpoints, USB_MAXENDPOINTS);
 
     uint8_t intfNum = desc->bInterfaceNumber;
     size_t currentSize = interfaceNums.size();
@@ -287,11 +289,11 @@ static void GetInterfaceNumberDes(
     }
 }
 
-// return number of interfaces
-// intf contains all interface numbers
-// alts contains the number of alternate settings on the corresponding interface
-static void GetInterfaceNumber(
-    const uint8_t *buffer, int32_t size, std::vector<uint8_t> &interfaceNums, std::vector<uint8_t> &alternateSetting)
+// sizing pass
+// interfaceNums contains all interface numbers
+// alternateSetting contains the number of alternate settings on the corresponding interface
+// numEndpoints is an upper bound of the number of endpoints of all alternate settings
+static void GetInterfaceNumber(const uint8_t *buffer, int32_t size, UsbConfigLayout &layout)
 {
     const UsbDescriptorHeader *header = nullptr;
     const uint8_t *buffer2;
@@ -309,12 +311,13 @@ static void GetInterfaceNumber(
         }
 
         if (header->bDescriptorType == USB_DDK_DT_INTERFACE) {
-            GetInterfaceNumberDes(header, interfaceNums, alternateSetting);
+            GetInterfaceNumberDes(header, layout);
         }
     }
 }
 
-static int32_t ParseInterface(UsbDdkInterface &usbInterface, const uint8_t *buffer, int32_t size)
+static int32_t ParseInterface(UsbConfigArena &arena, UsbDdkInterface &usbInterface, uint8_t maxAltsetting,
+    const uint8_t *buffer, int32_t size)
 {
     const uint8_t *buffer0 = buffer;
     int32_t interfaceNumber = -1; // initial value of interfaceNumber is -1
@@ -325,9 +328,9 @@ static int32_t ParseInterface(UsbDdkInterface &usbInterface, const uint8_t *buff
         return USB_DDK_FAILED;
     }
 
-    while (size >= USB_DDK_DT_INTERFACE_SIZE) {
+    while (size >= USB_DDK_DT_INTERFACE_SIZE && usbInterface.numAltsetting < maxAltsetting) {
         UsbDdkInterfaceDescriptor &ddkIntfDesc = usbInterface.altsetting[usbInterface.numAltsetting];
-        int32_t ret = RawParseDescriptor(size, buffer, USB_DDK_INTERFACE_DESCRIPTOR_TYPE, ddkIntfDesc);
+        int32_t ret = RawParseDescriptor(size, buffer, ddkIntfDesc);
         if (ret == USB_DDK_INVALID_PARAMETER) {
             return buffer - buffer0;
         } else if (ret == USB_DDK_INVALID_OPERATION) {
@@ -347,7 +350,7 @@ static int32_t ParseInterface(UsbDdkInterface &usbInterface, const uint8_t *buff
         size -= ddkIntfDesc.interfaceDescriptor.bLength;
         int32_t len = FindNextDescriptor(buffer, size);
         if (len != 0) {
-            if (FillExtraDescriptor(&ddkIntfDesc.extra, &ddkIntfDesc.extraLength, buffer, len) != EDM_OK) {
+            if (FillExtraDescriptor(arena, &ddkIntfDesc.extra, &ddkIntfDesc.extraLength, buffer, len) != EDM_OK) {
                 EDM_LOGE(MODULE_USB_DDK, "FillExtraDescriptor failed");
                 return USB_DDK_INVALID_PARAMETER;
             }
@@ -355,7 +358,7 @@ static int32_t ParseInterface(UsbDdkInterface &usbInterface, const uint8_t *buff
             size -= len;
         }
 
-        ret = ParseInterfaceEndpoint(ddkIntfDesc, &buffer, &size);
+        ret = ParseInterfaceEndpoint(arena, ddkIntfDesc, &buffer, &size);
         if (ret < EDM_OK) {
             EDM_LOGE(MODULE_USB_DDK, "ParseInterfaceEndpoint, ret less than zero");
             return ret;
@@ -372,74 +375,16 @@ static int32_t ParseInterface(UsbDdkInterface &usbInterface, const uint8_t *buff
     return buffer - buffer0;
 }
 
-static void ClearEndpoint(UsbDdkEndpointDescriptor *endPoint)
-{
-    if ((endPoint != nullptr) && (endPoint->extra != nullptr)) {
-        delete[] (endPoint->extra);
-        endPoint->extra = nullptr;
-    }
-}
-
-static void ClearInterface(UsbDdkInterface &usbInterface)
-{
-    uint8_t i;
-    uint8_t j;
-
-    if (usbInterface.numAltsetting > USB_MAXALTSETTING) {
-        EDM_LOGE(MODULE_USB_DDK, "numAltsetting = %{public}hhu is error", usbInterface.numAltsetting);
-        return;
-    }
-
-    for (i = 0; i < usbInterface.numAltsetting; i++) {
-        auto infPtr = reinterpret_cast<UsbDdkInterfaceDescriptor *>(usbInterface.altsetting + i);
-        if (infPtr == nullptr) {
-            EDM_LOGE(MODULE_USB_DDK, "altsetting is null");
-            continue;
-        }
-
-        if (infPtr->extra != nullptr) {
-            delete[] (infPtr->extra);
-            infPtr->extra = nullptr;
-        }
-
-        if (infPtr->endPoint != nullptr) {
-            for (j = 0; j < infPtr->interfaceDescriptor.bNumEndpoints; j++) {
-                ClearEndpoint(reinterpret_cast<UsbDdkEndpointDescriptor *>(infPtr->endPoint + j));
-            }
-
-            delete[] (infPtr->endPoint);
-            infPtr->endPoint = nullptr;
-        }
-    }
-
-    delete[] usbInterface.altsetting;
-}
-
-void RawClearConfiguration(UsbDdkConfigDescriptor &config)
-{
-    uint8_t i;
-    for (i = 0; i < config.configDescriptor.bNumInterfaces; i++) {
-        ClearInterface(config.interface[i]);
-        delete[] config.interface;
-        config.interface = nullptr;
-    }
-
-    if (config.extra != nullptr) {
-        delete[] (config.extra);
-        config.extra = nullptr;
-    }
-}
-
-static int32_t ParseConfigurationDes(
-    UsbDdkConfigDescriptor &config, const uint8_t *buffer, int32_t size, std::vector<uint8_t> &interfaceNums)
+static int32_t ParseConfigurationDes(UsbConfigArena &arena, UsbDdkConfigDescriptor &config, const uint8_t *buffer,
+    int32_t size, const UsbConfigLayout &layout)
 {
     int32_t ret;
     while (size >= static_cast<int32_t>(sizeof(UsbDescriptorHeader))) {
         int32_t len = FindNextDescriptor(buffer, size);
         if (len != 0) {
-            ret = FillExtraDescriptor(&config.extra, &config.extraLength, buffer, len);
+            ret = AppendConfigExtraDescriptor(arena, config, buffer, len);
             if (ret != EDM_OK) {
-                EDM_LOGE(MODULE_USB_DDK, "FillExtraDescriptor failed");
+                EDM_LOGE(MODULE_USB_DDK, "AppendConfigExtraDescriptor failed");
                 return ret;
             }
             buffer += len;
@@ -456,7 +401,7 @@ static int32_t ParseConfigurationDes(
         }
         uint8_t i = 0;
         for (; i < config.configDescriptor.bNumInterfaces; ++i) {
-            if (interfaceNums[i] == ifDesc->bInterfaceNumber) {
+            if (layout.interfaceNums[i] == ifDesc->bInterfaceNumber) {
                 break;
             }
         }
@@ -464,10 +409,13 @@ static int32_t ParseConfigurationDes(
             EDM_LOGE(MODULE_USB_DDK, "%{public}u: bInterfaceNumber not found.", ifDesc->bInterfaceNumber);
             return USB_DDK_INVALID_PARAMETER;
         }
-        ret = ParseInterface(config.interface[i], buffer, size);
+        ret = ParseInterface(arena, config.interface[i], layout.alternateSetting[i], buffer, size);
         if (ret < 0) {
             EDM_LOGE(MODULE_USB_DDK, "%{public}u: Parse interface failed.", ifDesc->bInterfaceNumber);
             return ret;
+        } else if (ret == 0) {
+            // nothing could be parsed at this position, the rest is left unresolved
+            break;
         }
 
         buffer += ret;
@@ -477,91 +425,171 @@ static int32_t ParseConfigurationDes(
     return size;
 }
 
-// On error, return errcode, negative number
-// On success, return 0, means all buffer are resolved into the config; return positive number, means buffer size that
-// is not resolved
-static int32_t ParseConfiguration(UsbDdkConfigDescriptor &config, const uint8_t *buffer, int32_t size)
+static int32_t ParseConfigurationHeader(UsbConfigDescriptor &configDesc, const uint8_t *buffer, int32_t size)
 {
     if (size < USB_DDK_DT_CONFIG_SIZE) {
         EDM_LOGE(MODULE_USB_DDK, "size = %{public}u is short, or config is null!", size);
         return USB_DDK_INVALID_OPERATION;
     }
 
-    ParseDescriptor(
-        USB_DDK_CONFIG_DESCRIPTOR_TYPE, (uint8_t *)&config, sizeof(struct UsbConfigDescriptor), buffer, size);
-    if ((config.configDescriptor.bDescriptorType != USB_DDK_DT_CONFIG) ||
-        (config.configDescriptor.bLength < USB_DDK_DT_CONFIG_SIZE) ||
-        (config.configDescriptor.bLength > (uint8_t)size) ||
-        (config.configDescriptor.bNumInterfaces > USB_MAXINTERFACES)) {
+    DecodeDescriptor(buffer, configDesc);
+    if ((configDesc.bDescriptorType != USB_DDK_DT_CONFIG) || (configDesc.bLength < USB_DDK_DT_CONFIG_SIZE) ||
+        (configDesc.bLength > (uint8_t)size) || (configDesc.bNumInterfaces > USB_MAXINTERFACES)) {
         EDM_LOGE(MODULE_USB_DDK, "invalid descriptor: type = 0x%{public}x, length = %{public}u",
-            config.configDescriptor.bDescriptorType, config.configDescriptor.bLength);
-        return USB_DDK_INVALID_OPERATION;
-    }
-
-    std::vector<uint8_t> interfaceNums;
-    std::vector<uint8_t> alternateSetting;
-    GetInterfaceNumber(buffer, size, interfaceNums, alternateSetting);
-
-    size_t intfNum = interfaceNums.size();
-    if (intfNum == 0 || intfNum > USB_MAXALTSETTING) {
-        EDM_LOGE(MODULE_USB_DDK, "interface num is zero");
+            configDesc.bDescriptorType, configDesc.bLength);
         return USB_DDK_INVALID_OPERATION;
     }
+    return EDM_OK;
+}
 
+// On error, return errcode, negative number
+// On success, return 0, means all buffer are resolved into the config; return positive number, means buffer size that
+// is not resolved
+static int32_t ParseConfiguration(UsbConfigArena &arena, UsbDdkConfigDescriptor &config,
+    const UsbConfigLayout &layout, const uint8_t *buffer, int32_t size)
+{
+    size_t intfNum = layout.interfaceNums.size();
     config.configDescriptor.bNumInterfaces = (uint8_t)intfNum;
-    config.interface = new UsbDdkInterface[intfNum];
+    config.interface = ArenaAlloc<UsbDdkInterface>(arena, intfNum);
     if (config.interface == nullptr) {
-        EDM_LOGE(MODULE_USB_DDK, "new UsbDdkInterface failed");
+        EDM_LOGE(MODULE_USB_DDK, "alloc UsbDdkInterface failed");
         return USB_DDK_MEMORY_ERROR;
     }
-    (void)memset_s(
-        static_cast<void *>(config.interface), sizeof(UsbDdkInterface) * intfNum, 0, sizeof(UsbDdkInterface) * intfNum);
 
     for (size_t i = 0; i < intfNum; ++i) {
-        uint8_t j = alternateSetting[i];
-        if (j > USB_MAXALTSETTING) {
-            EDM_LOGE(MODULE_USB_DDK, "too many alternate settings: %{public}hhu", j);
-            alternateSetting[i] = USB_MAXALTSETTING;
-            j = USB_MAXALTSETTING;
-        }
-        config.interface[i].altsetting = new UsbDdkInterfaceDescriptor[j];
+        config.interface[i].altsetting = ArenaAlloc<UsbDdkInterfaceDescriptor>(arena, layout.alternateSetting[i]);
         if (config.interface[i].altsetting == nullptr) {
-            EDM_LOGE(MODULE_USB_DDK, "new UsbDdkInterfaceDescriptor failed");
+            EDM_LOGE(MODULE_USB_DDK, "alloc UsbDdkInterfaceDescriptor failed");
             return USB_DDK_MEMORY_ERROR;
         }
-        (void)memset_s(static_cast<void *>(config.interface[i].altsetting), sizeof(UsbDdkInterfaceDescriptor) * j, 0,
-            sizeof(UsbDdkInterfaceDescriptor) * j);
     }
 
     buffer += config.configDescriptor.bLength;
     size -= config.configDescriptor.bLength;
 
-    return ParseConfigurationDes(config, buffer, size, interfaceNums);
+    return ParseConfigurationDes(arena, config, buffer, size, layout);
 }
 
-int32_t ParseUsbConfigDescriptor(const std::vector<uint8_t> &configBuffer, UsbDdkConfigDescriptor ** const config)
+// Validates the configuration descriptor and computes the layout of its arena.
+static int32_t GetConfigLayout(const std::vector<uint8_t> &configBuffer, UsbConfigLayout &layout)
 {
-    UsbDdkConfigDescriptor *tmpConfig = new UsbDdkConfigDescriptor();
-    if (tmpConfig == nullptr) {
-        EDM_LOGE(MODULE_USB_DDK, "new failed");
+    const uint8_t *buffer = configBuffer.data();
+    int32_t size = static_cast<int32_t>(configBuffer.size());
+    int32_t ret = ParseConfigurationHeader(layout.configDesc, buffer, size);
+    if (ret != EDM_OK) {
+        return ret;
+    }
+
+    GetInterfaceNumber(buffer, size, layout);
+    size_t intfNum = layout.interfaceNums.size();
+    if (intfNum == 0 || intfNum > USB_MAXALTSETTING) {
+        EDM_LOGE(MODULE_USB_DDK, "interface num is zero");
+        return USB_DDK_INVALID_OPERATION;
+    }
+    layout.arenaSize = ArenaSize(layout, configBuffer.size());
+    return EDM_OK;
+}
+
+// Parses a configuration into an arena of layout.arenaSize bytes. The configuration is placed at the start of it.
+static int32_t ParseConfigInArena(
+    const std::vector<uint8_t> &configBuffer, const UsbConfigLayout &layout, uint8_t *memory)
+{
+    size_t rawLen = configBuffer.size();
+    // the copy of the raw descriptors is written below
+    (void)memset_s(memory, layout.arenaSize - rawLen, 0, layout.arenaSize - rawLen);
+    uint8_t *copy = memory + layout.arenaSize - rawLen;
+    UsbConfigArena arena = {memory, copy, configBuffer.data(), rawLen, copy};
+    if (memcpy_s(arena.arrayEnd, rawLen, configBuffer.data(), rawLen) != EOK) {
+        EDM_LOGE(MODULE_USB_DDK, "copy descriptors failed");
         return USB_DDK_MEMORY_ERROR;
     }
-    (void)memset_s(static_cast<void *>(tmpConfig), sizeof(UsbDdkConfigDescriptor), 0, sizeof(UsbDdkConfigDescriptor));
 
-    int32_t ret = ParseConfiguration(*tmpConfig, configBuffer.data(), configBuffer.size());
+    UsbDdkConfigDescriptor *config = ArenaAlloc<UsbDdkConfigDescriptor>(arena, 1);
+    config->configDescriptor = layout.configDesc;
+    int32_t ret = ParseConfiguration(arena, *config, layout, configBuffer.data(), static_cast<int32_t>(rawLen));
     if (ret < 0) {
         EDM_LOGE(MODULE_USB_DDK, "ParseConfiguration failed with error = %{public}d", ret);
-        FreeUsbConfigDescriptor(tmpConfig);
-        tmpConfig = nullptr;
-        return ret;
     } else if (ret > 0) {
         EDM_LOGW(MODULE_USB_DDK, "still %{public}d bytes of descriptor data left", ret);
     }
-
-    *config = tmpConfig;
     return ret;
 }
 
+static UsbInternedConfigHeader *GetHeader(UsbDdkConfigDescriptor *config)
+{
+    return reinterpret_cast<UsbInternedConfigHeader *>(
+        reinterpret_cast<uint8_t *>(config) - sizeof(UsbInternedConfigHeader));
+}
+
+static UsbDdkConfigDescriptor *GetConfig(UsbInternedConfigHeader *header)
+{
+    return reinterpret_cast<UsbDdkConfigDescriptor *>(reinterpret_cast<uint8_t *>(header) + sizeof(*header));
+}
+
+// Returns a new reference to an interned configuration with the same raw descriptors, or nullptr. Must be called with
+// g_internMutex held.
+static UsbInternedConfigHeader *FindInterned(size_t hash, const std::vector<uint8_t> &configBuffer)
+{
+    auto range = g_internedConfigs.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        UsbInternedConfigHeader *header = it->second;
+        if (header->rawLen == configBuffer.size() &&
+            std::equal(configBuffer.begin(), configBuffer.end(), header->raw)) {
+            ++header->refCount;
+            return header;
+        }
+    }
+    return nullptr;
+}
+
+int32_t ParseUsbConfigDescriptor(const std::vector<uint8_t> &configBuffer, UsbDdkConfigDescriptor ** const config)
+{
+    size_t hash = std::hash<std::string_view>()(
+        std::string_view(reinterpret_cast<const char *>(configBuffer.data()), configBuffer.size()));
+    {
+        std::lock_guard<std::mutex> lock(g_internMutex);
+        UsbInternedConfigHeader *header = FindInterned(hash, configBuffer);
+        if (header != nullptr) {
+            *config = GetConfig(header);
+            return header->parseResult;
+        }
+    }
+
+    UsbConfigLayout layout;
+    int32_t ret = GetConfigLayout(configBuffer, layout);
+    if (ret != EDM_OK) {
+        return ret;
+    }
+
+    size_t totalSize = sizeof(UsbInternedConfigHeader) + layout.arenaSize;
+    uint8_t *memory = new (std::nothrow) uint8_t[totalSize];
+    if (memory == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "new failed, size = %{public}zu", totalSize);
+        return USB_DDK_MEMORY_ERROR;
+    }
+    uint8_t *arenaMemory = memory + sizeof(UsbInternedConfigHeader);
+    ret = ParseConfigInArena(configBuffer, layout, arenaMemory);
+    if (ret < 0) {
+        delete[] memory;
+        return ret;
+    }
+    // the raw copy is at the end of the arena
+    auto newHeader = reinterpret_cast<UsbInternedConfigHeader *>(memory);
+    *newHeader = {1, ret, hash, arenaMemory + layout.arenaSize - configBuffer.size(), configBuffer.size()};
+
+    std::lock_guard<std::mutex> lock(g_internMutex);
+    // the parser runs without the lock, an identical configuration may have been interned meanwhile
+    UsbInternedConfigHeader *header = FindInterned(hash, configBuffer);
+    if (header != nullptr) {
+        delete[] memory;
+    } else {
+        header = newHeader;
+        g_internedConfigs.emplace(hash, header);
+    }
+    *config = GetConfig(header);
+    return header->parseResult;
+}
+
 void FreeUsbConfigDescriptor(UsbDdkConfigDescriptor * const config)
 {
     if (config == nullptr) {
@@ -569,8 +597,144 @@ void FreeUsbConfigDescriptor(UsbDdkConfigDescriptor * const config)
         return;
     }
 
-    RawClearConfiguration(*config);
-    delete config;
+    UsbInternedConfigHeader *header = GetHeader(config);
+    {
+        std::lock_guard<std::mutex> lock(g_internMutex);
+        if (--header->refCount != 0) {
+            return;
+        }
+        auto range = g_internedConfigs.equal_range(header->hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == header) {
+                g_internedConfigs.erase(it);
+                break;
+            }
+        }
+    }
+    delete[] reinterpret_cast<uint8_t *>(header);
+}
+
+int32_t ParseUsbConfigDescriptorToArena(const std::vector<uint8_t> &configBuffer, std::vector<uint8_t> &arena)
+{
+    UsbConfigLayout layout;
+    int32_t ret = GetConfigLayout(configBuffer, layout);
+    if (ret != EDM_OK) {
+        return ret;
+    }
+    // the memory of a vector comes from operator new, which is aligned for every descriptor structure
+    arena.resize(layout.arenaSize);
+    return ParseConfigInArena(configBuffer, layout, arena.data());
+}
+
+int32_t ParseUsbConfigDescriptorTable(
+    const std::vector<const std::vector<uint8_t> *> &configBuffers, UsbDdkConfigDescriptorTable ** const table)
+{
+    if (configBuffers.empty() || configBuffers.size() > UINT8_MAX) {
+        EDM_LOGE(MODULE_USB_DDK, "invalid configuration count %{public}zu", configBuffers.size());
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    std::vector<UsbConfigLayout> layouts(configBuffers.size());
+    size_t totalSize = sizeof(UsbDdkConfigDescriptorTable);
+    for (size_t i = 0; i < configBuffers.size(); ++i) {
+        int32_t ret = GetConfigLayout(*configBuffers[i], layouts[i]);
+        if (ret != EDM_OK) {
+            EDM_LOGE(MODULE_USB_DDK, "configuration %{public}zu is invalid", i);
+            return ret;
+        }
+        totalSize += layouts[i].arenaSize;
+    }
+
+    uint8_t *memory = new (std::nothrow) uint8_t[totalSize];
+    if (memory == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "new failed, size = %{public}zu", totalSize);
+        return USB_DDK_MEMORY_ERROR;
+    }
+    auto tmpTable = reinterpret_cast<UsbDdkConfigDescriptorTable *>(memory);
+    (void)memset_s(tmpTable, sizeof(UsbDdkConfigDescriptorTable), 0, sizeof(UsbDdkConfigDescriptorTable));
+    tmpTable->numConfigurations = static_cast<uint8_t>(configBuffers.size());
+
+    uint8_t *next = memory + sizeof(UsbDdkConfigDescriptorTable);
+    for (size_t i = 0; i < configBuffers.size(); ++i) {
+        int32_t ret = ParseConfigInArena(*configBuffers[i], layouts[i], next);
+        if (ret < 0) {
+            delete[] memory;
+            return ret;
+        }
+        auto config = reinterpret_cast<UsbDdkConfigDescriptor *>(next);
+        UsbDdkConfigDescriptor *&slot = tmpTable->configs[config->configDescriptor.bConfigurationValue];
+        if (slot == nullptr) {
+            slot = config;
+        } else {
+            EDM_LOGW(MODULE_USB_DDK, "duplicate configuration value %{public}hhu",
+                config->configDescriptor.bConfigurationValue);
+        }
+        next += layouts[i].arenaSize;
+    }
+
+    *table = tmpTable;
+    return EDM_OK;
+}
+
+void FreeUsbConfigDescriptorTable(UsbDdkConfigDescriptorTable * const table)
+{
+    if (table == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "table is nullptr");
+        return;
+    }
+
+    // the table and all configurations share one allocation
+    delete[] reinterpret_cast<uint8_t *>(table);
+}
+
+int32_t ParseUsbInterfaceDescriptor(const uint8_t *raw, size_t rawLen,
+    const std::vector<std::pair<uint32_t, uint32_t>> &altSettings, UsbDdkInterface ** const usbInterface)
+{
+    if (raw == nullptr || altSettings.empty() || altSettings.size() > USB_MAXALTSETTING) {
+        EDM_LOGE(MODULE_USB_DDK, "invalid param, altSettings = %{public}zu", altSettings.size());
+        return USB_DDK_INVALID_PARAMETER;
+    }
+    size_t numEndpoints = 0;
+    for (auto &[offset, length] : altSettings) {
+        if (offset > rawLen || length > rawLen - offset || length < USB_DDK_DT_INTERFACE_SIZE) {
+            EDM_LOGE(MODULE_USB_DDK, "invalid alternate setting, offset = %{public}u, length = %{public}u", offset,
+                length);
+            return USB_DDK_INVALID_PARAMETER;
+        }
+        numEndpoints += std::min<size_t>(raw[offset + offsetof(UsbInterfaceDescriptor, bNumEndpoints)],
+            USB_MAXENDPOINTS);
+    }
+
+    size_t size = sizeof(UsbDdkInterface) + sizeof(UsbDdkInterfaceDescriptor) * altSettings.size() +
+        sizeof(UsbDdkEndpointDescriptor) * numEndpoints;
+    uint8_t *memory = new (std::nothrow) uint8_t[size];
+    if (memory == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "new failed, size = %{public}zu", size);
+        return USB_DDK_MEMORY_ERROR;
+    }
+    (void)memset_s(memory, size, 0, size);
+    UsbConfigArena arena = {memory, memory + size, raw, rawLen, raw};
+    UsbDdkInterface *result = ArenaAlloc<UsbDdkInterface>(arena, 1);
+    result->altsetting = ArenaAlloc<UsbDdkInterfaceDescriptor>(arena, altSettings.size());
+    for (size_t i = 0; i < altSettings.size(); ++i) {
+        // each alternate setting is parsed from its own range, which ends at the next interface descriptor
+        int32_t ret = ParseInterface(arena, *result, static_cast<uint8_t>(i + 1), raw + altSettings[i].first,
+            static_cast<int32_t>(altSettings[i].second));
+        if (ret < 0 || result->numAltsetting != i + 1) {
+            EDM_LOGE(MODULE_USB_DDK, "parse alternate setting %{public}zu failed, ret = %{public}d", i, ret);
+            delete[] memory;
+            return ret < 0 ? ret : USB_DDK_INVALID_OPERATION;
+        }
+    }
+
+    *usbInterface = result;
+    return EDM_OK;
+}
+
+void FreeUsbInterfaceDescriptor(UsbDdkInterface * const usbInterface)
+{
+    // the interface is at the start of its arena
+    delete[] reinterpret_cast<uint8_t *>(usbInterface);
 }
 } // namespace ExternalDeviceManager
-} // namespace OHOS
\ No newline at end of file
+} // namespace OHOS
@@ -14,13 +14,29 @@
  */
 
 #ifndef USB_CONFIG_DESC_PARSER_H
+#include <utility>
 #include <vector>
 
 #include "usb_ddk_types.h"
 namespace OHOS {
 namespace ExternalDeviceManager {
+// Identical raw descriptors share one parsed configuration, which must not be modified. Every successful parse must
+// be paired with FreeUsbConfigDescriptor.
 int32_t ParseUsbConfigDescriptor(const std::vector<uint8_t> &configBuffer, UsbDdkConfigDescriptor ** const config);
 void FreeUsbConfigDescriptor(UsbDdkConfigDescriptor * const config);
+// Parses a configuration into memory owned by the caller, without interning it. The configuration is at the start of
+// the arena and the raw descriptors at its end, every pointer in it refers to the arena itself.
+int32_t ParseUsbConfigDescriptorToArena(const std::vector<uint8_t> &configBuffer, std::vector<uint8_t> &arena);
+// Parses several configurations of a device into one allocation, which is released by FreeUsbConfigDescriptorTable.
+int32_t ParseUsbConfigDescriptorTable(
+    const std::vector<const std::vector<uint8_t> *> &configBuffers, UsbDdkConfigDescriptorTable ** const table);
+void FreeUsbConfigDescriptorTable(UsbDdkConfigDescriptorTable * const table);
+// Parses one interface from the raw descriptors of a configuration. Every alternate setting is given as the offset and
+// length of its descriptors, from its interface descriptor up to the next interface descriptor. Extra descriptors point
+// into the raw descriptors, which must outlive the interface. Released by FreeUsbInterfaceDescriptor.
+int32_t ParseUsbInterfaceDescriptor(const uint8_t *raw, size_t rawLen,
+    const std::vector<std::pair<uint32_t, uint32_t>> &altSettings, UsbDdkInterface ** const usbInterface);
+void FreeUsbInterfaceDescriptor(UsbDdkInterface * const usbInterface);
 } // namespace ExternalDeviceManager
 } // namespace OHOS
 #define USB_CONFIG_DESC_PARSER_H
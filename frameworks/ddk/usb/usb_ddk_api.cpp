@@ -14,9 +14,13 @@
  */
 
 #include "usb_ddk_api.h"
+#include <algorithm>
 #include <cerrno>
 #include <memory.h>
+#include <memory>
+#include <mutex>
 #include <securec.h>
+#include <shared_mutex>
 #include <sys/mman.h>
 #include <unistd.h>
 #include <vector>
@@ -24,36 +28,209 @@
 #include "edm_errors.h"
 #include "hilog_wrapper.h"
 #include "usb_config_desc_parser.h"
+#include "usb_ddk_descriptor_cache.h"
+#include "usb_ddk_iso_stream.h"
+#include "usb_ddk_mem_pool.h"
+#include "usb_ddk_read_stream.h"
+#include "usb_ddk_request_queue.h"
+#include "usb_ddk_transfer_plan.h"
+#include "usb_ddk_transfer_ring.h"
 #include "usb_ddk_types.h"
 #include "v1_0/usb_ddk_service.h"
 using namespace OHOS::ExternalDeviceManager;
 namespace {
-OHOS::sptr<OHOS::HDI::Usb::Ddk::V1_0::IUsbDdk> g_ddk = nullptr;
+using OHOS::HDI::Usb::Ddk::V1_0::IUsbDdk;
+constexpr uint8_t USB_ENDPOINT_DIR_IN = 0x80;
+// g_lifecycleMutex serializes OH_Usb_Init and OH_Usb_Release. Transfers only take g_ddkMutex shared to copy g_ddk,
+// so threads working on different interfaces never wait for each other.
+std::mutex g_lifecycleMutex;
+uint32_t g_initCount = 0;
+std::shared_mutex g_ddkMutex;
+OHOS::sptr<IUsbDdk> g_ddk = nullptr;
+std::mutex g_requestQueueMutex;
+std::shared_ptr<UsbDdkRequestQueue> g_requestQueue = nullptr;
+UsbDdkDescriptorCache g_descriptorCache;
+
+OHOS::sptr<IUsbDdk> GetDdk()
+{
+    std::shared_lock<std::shared_mutex> lock(g_ddkMutex);
+    return g_ddk;
+}
+
+int32_t GetCachedDeviceDescriptor(const OHOS::sptr<IUsbDdk> &ddk, uint64_t deviceId, UsbDeviceDescriptor &desc)
+{
+    return g_descriptorCache.GetDeviceDescriptor(deviceId, desc, [&ddk, deviceId](UsbDeviceDescriptor &tmp) {
+        return ddk->GetDeviceDescriptor(
+            deviceId, reinterpret_cast<OHOS::HDI::Usb::Ddk::V1_0::UsbDeviceDescriptor &>(tmp));
+    });
+}
+
+// An interface of the device was claimed since its configurations were cached, they are served once the device
+// descriptor has been read again and found unchanged.
+void ValidateCachedConfigs(const OHOS::sptr<IUsbDdk> &ddk, uint64_t deviceId)
+{
+    if (!g_descriptorCache.NeedsValidation(deviceId)) {
+        return;
+    }
+    UsbDeviceDescriptor desc;
+    if (GetCachedDeviceDescriptor(ddk, deviceId, desc) != EDM_OK) {
+        g_descriptorCache.Invalidate(deviceId);
+    }
+}
+
+int32_t SendPipeRequestInner(
+    const UsbRequestPipe &pipe, uint32_t size, uint32_t offset, uint32_t length, uint32_t &transferedLength)
+{
+    auto tmpSetUp = reinterpret_cast<const OHOS::HDI::Usb::Ddk::V1_0::UsbRequestPipe *>(&pipe);
+    auto ddk = GetDdk();
+    if (ddk == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "ddk is released");
+        return USB_DDK_INVALID_OPERATION;
+    }
+    return ddk->SendPipeRequest(*tmpSetUp, size, offset, length, transferedLength);
+}
+
+bool IsMemMapRangeValid(const UsbDeviceMemMap &devMmap)
+{
+    return devMmap.offset <= devMmap.size && devMmap.bufferLength <= devMmap.size - devMmap.offset;
+}
+
+// The service only sees the mapping of a pool as a whole, so the buffer is checked against the slice before it is
+// translated, a buffer running over the end of a slice would otherwise reach into the next one.
+int32_t TranslateMemMap(const UsbDeviceMemMap &devMmap, uint32_t &size, uint32_t &offset)
+{
+    if (!IsMemMapRangeValid(devMmap)) {
+        EDM_LOGE(MODULE_USB_DDK, "buffer is out of the memory map");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+    if (!UsbDdkMemMapPool::Translate(devMmap, size, offset)) {
+        size = devMmap.size;
+        offset = devMmap.offset;
+    }
+    return EDM_OK;
+}
+
+int32_t SendMemMapPipeRequest(const UsbRequestPipe &pipe, UsbDeviceMemMap &devMmap)
+{
+    uint32_t size = 0;
+    uint32_t offset = 0;
+    int32_t ret = TranslateMemMap(devMmap, size, offset);
+    if (ret != EDM_OK) {
+        devMmap.transferedLength = 0;
+        return ret;
+    }
+    return SendPipeRequestInner(pipe, size, offset, devMmap.bufferLength, devMmap.transferedLength);
+}
+
+// The HDI interface transfers control data in a vector. Each thread keeps its vector, so once it has grown to the
+// largest transfer no memory is allocated per request.
+std::vector<uint8_t> &GetControlBuffer()
+{
+    thread_local std::vector<uint8_t> buffer;
+    return buffer;
+}
+
+int32_t SendControlReadRequestInner(const OHOS::sptr<IUsbDdk> &ddk, uint64_t interfaceHandle,
+    const UsbControlRequestSetup &setup, uint32_t timeout, uint8_t *data, uint32_t &dataLen)
+{
+    auto tmpSetUp = reinterpret_cast<const OHOS::HDI::Usb::Ddk::V1_0::UsbControlRequestSetup *>(&setup);
+    std::vector<uint8_t> &dataTmp = GetControlBuffer();
+    dataTmp.clear();
+    int32_t ret = ddk->SendControlReadRequest(interfaceHandle, *tmpSetUp, timeout, dataTmp);
+    if (ret != 0) {
+        EDM_LOGE(MODULE_USB_DDK, "send control req failed");
+        return ret;
+    }
+
+    if (dataLen < dataTmp.size()) {
+        EDM_LOGE(MODULE_USB_DDK, "The data is too small");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    if (!dataTmp.empty() && memcpy_s(data, dataLen, dataTmp.data(), dataTmp.size()) != 0) {
+        EDM_LOGE(MODULE_USB_DDK, "copy data failed");
+        return USB_DDK_MEMORY_ERROR;
+    }
+    dataLen = dataTmp.size();
+    return EDM_OK;
+}
+
+int32_t SendControlWriteRequestInner(const OHOS::sptr<IUsbDdk> &ddk, uint64_t interfaceHandle,
+    const UsbControlRequestSetup &setup, uint32_t timeout, const uint8_t *data, uint32_t dataLen)
+{
+    auto tmpSetUp = reinterpret_cast<const OHOS::HDI::Usb::Ddk::V1_0::UsbControlRequestSetup *>(&setup);
+    std::vector<uint8_t> &dataTmp = GetControlBuffer();
+    dataTmp.assign(data, data + dataLen);
+    return ddk->SendControlWriteRequest(interfaceHandle, *tmpSetUp, timeout, dataTmp);
+}
+
+// The stopped queue stays in place, so that the completions of the requests it dropped can still be reaped. The
+// next submission replaces it.
+void StopRequestQueue()
+{
+    std::shared_ptr<UsbDdkRequestQueue> requestQueue;
+    {
+        std::lock_guard<std::mutex> lock(g_requestQueueMutex);
+        requestQueue = g_requestQueue;
+    }
+    if (requestQueue != nullptr) {
+        requestQueue->Stop();
+    }
+}
 } // namespace
 int32_t OH_Usb_Init()
 {
-    g_ddk = OHOS::HDI::Usb::Ddk::V1_0::IUsbDdk::Get();
-    if (g_ddk == nullptr) {
+    std::lock_guard<std::mutex> lifecycleLock(g_lifecycleMutex);
+    if (g_initCount > 0) {
+        ++g_initCount;
+        return EDM_OK;
+    }
+
+    auto ddk = IUsbDdk::Get();
+    if (ddk == nullptr) {
         EDM_LOGE(MODULE_USB_DDK, "get ddk failed");
         return USB_DDK_FAILED;
     }
 
-    return g_ddk->Init();
+    int32_t ret = ddk->Init();
+    if (ret != EDM_OK) {
+        EDM_LOGE(MODULE_USB_DDK, "init ddk failed: %{public}d", ret);
+        return ret;
+    }
+    {
+        std::unique_lock<std::shared_mutex> lock(g_ddkMutex);
+        g_ddk = ddk;
+    }
+    g_initCount = 1;
+    return EDM_OK;
 }
 
 void OH_Usb_Release()
 {
-    if (g_ddk == nullptr) {
+    std::lock_guard<std::mutex> lifecycleLock(g_lifecycleMutex);
+    if (g_initCount == 0) {
         EDM_LOGE(MODULE_USB_DDK, "ddk is null");
         return;
     }
-    g_ddk->Release();
-    g_ddk.clear();
+    if (--g_initCount > 0) {
+        return;
+    }
+
+    OHOS::sptr<IUsbDdk> ddk;
+    {
+        std::unique_lock<std::shared_mutex> lock(g_ddkMutex);
+        ddk = g_ddk;
+        g_ddk.clear();
+    }
+    StopRequestQueue();
+    g_descriptorCache.Clear();
+    ddk->Release();
 }
 
 int32_t OH_Usb_GetDeviceDescriptor(uint64_t deviceId, UsbDeviceDescriptor *desc)
 {
-    if (g_ddk == nullptr) {
+    auto ddk = GetDdk();
+    if (ddk == nullptr) {
         EDM_LOGE(MODULE_USB_DDK, "invalid obj");
         return USB_DDK_INVALID_OPERATION;
     }
@@ -62,8 +239,7 @@ int32_t OH_Usb_GetDeviceDescriptor(uint64_t deviceId, UsbDeviceDescriptor *desc)
         return USB_DDK_INVALID_PARAMETER;
     }
 
-    auto tmpDesc = reinterpret_cast<OHOS::HDI::Usb::Ddk::V1_0::UsbDeviceDescriptor *>(desc);
-    int32_t ret = g_ddk->GetDeviceDescriptor(deviceId, *tmpDesc);
+    int32_t ret = GetCachedDeviceDescriptor(ddk, deviceId, *desc);
     if (ret != EDM_OK) {
         EDM_LOGE(MODULE_USB_DDK, "get device desc failed: %{public}d", ret);
         return ret;
@@ -74,7 +250,8 @@ int32_t OH_Usb_GetDeviceDescriptor(uint64_t deviceId, UsbDeviceDescriptor *desc)
 int32_t OH_Usb_GetConfigDescriptor(
     uint64_t deviceId, uint8_t configIndex, struct UsbDdkConfigDescriptor ** const config)
 {
-    if (g_ddk == nullptr) {
+    auto ddk = GetDdk();
+    if (ddk == nullptr) {
         EDM_LOGE(MODULE_USB_DDK, "invalid obj");
         return USB_DDK_INVALID_OPERATION;
     }
@@ -82,24 +259,185 @@ int32_t OH_Usb_GetConfigDescriptor(
         EDM_LOGE(MODULE_USB_DDK, "param is null");
         return USB_DDK_INVALID_PARAMETER;
     }
-    std::vector<uint8_t> configDescriptor;
-    int32_t ret = g_ddk->GetConfigDescriptor(deviceId, configIndex, configDescriptor);
+    ValidateCachedConfigs(ddk, deviceId);
+    int32_t ret = g_descriptorCache.GetConfigDescriptor(
+        deviceId, configIndex, *config, [&ddk, deviceId, configIndex](std::vector<uint8_t> &configDescriptor) {
+            return ddk->GetConfigDescriptor(deviceId, configIndex, configDescriptor);
+        });
+    if (ret < 0) {
+        EDM_LOGE(MODULE_USB_DDK, "get config desc failed: %{public}d", ret);
+    }
+    return ret;
+}
+
+void OH_Usb_FreeConfigDescriptor(UsbDdkConfigDescriptor * const config)
+{
+    if (g_descriptorCache.ReleaseConfigDescriptor(config)) {
+        return;
+    }
+    return FreeUsbConfigDescriptor(config);
+}
+
+int32_t OH_Usb_GetConfigDescriptorTable(uint64_t deviceId, UsbDdkConfigDescriptorTable ** const table)
+{
+    auto ddk = GetDdk();
+    if (ddk == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "invalid obj");
+        return USB_DDK_INVALID_OPERATION;
+    }
+    if (table == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "param table is null");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    UsbDeviceDescriptor desc;
+    int32_t ret = GetCachedDeviceDescriptor(ddk, deviceId, desc);
     if (ret != EDM_OK) {
-        EDM_LOGE(MODULE_USB_DDK, "get config desc failed");
+        EDM_LOGE(MODULE_USB_DDK, "get device desc failed: %{public}d", ret);
         return ret;
     }
 
-    return ParseUsbConfigDescriptor(configDescriptor, config);
+    ret = g_descriptorCache.GetConfigDescriptorTable(deviceId, desc.bNumConfigurations, *table,
+        [&ddk, deviceId](uint8_t configIndex, std::vector<uint8_t> &configDescriptor) {
+            return ddk->GetConfigDescriptor(deviceId, configIndex, configDescriptor);
+        });
+    if (ret != EDM_OK) {
+        EDM_LOGE(MODULE_USB_DDK, "get config desc table failed: %{public}d", ret);
+    }
+    return ret;
 }
 
-void OH_Usb_FreeConfigDescriptor(UsbDdkConfigDescriptor * const config)
+void OH_Usb_FreeConfigDescriptorTable(UsbDdkConfigDescriptorTable * const table)
 {
-    return FreeUsbConfigDescriptor(config);
+    if (!g_descriptorCache.ReleaseConfigDescriptorTable(table)) {
+        EDM_LOGE(MODULE_USB_DDK, "table was not obtained from OH_Usb_GetConfigDescriptorTable");
+    }
+}
+
+int32_t OH_Usb_SetDescriptorImageDirectory(const char *directory)
+{
+    if (directory == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "param directory is null");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+    g_descriptorCache.SetImageDirectory(directory);
+    return EDM_OK;
+}
+
+int32_t OH_Usb_GetConfigDescriptorView(uint64_t deviceId, uint8_t configIndex, const UsbConfigDescriptorView **view)
+{
+    auto ddk = GetDdk();
+    if (ddk == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "invalid obj");
+        return USB_DDK_INVALID_OPERATION;
+    }
+    if (view == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "param view is null");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    ValidateCachedConfigs(ddk, deviceId);
+    const UsbDdkDescriptorView *descriptorView = nullptr;
+    int32_t ret = g_descriptorCache.GetConfigDescriptorView(deviceId, configIndex, descriptorView,
+        [&ddk, deviceId, configIndex](std::vector<uint8_t> &configDescriptor) {
+            return ddk->GetConfigDescriptor(deviceId, configIndex, configDescriptor);
+        });
+    if (ret != EDM_OK) {
+        EDM_LOGE(MODULE_USB_DDK, "get config desc view failed: %{public}d", ret);
+        return ret;
+    }
+    *view = reinterpret_cast<const UsbConfigDescriptorView *>(descriptorView);
+    return EDM_OK;
+}
+
+void OH_Usb_FreeConfigDescriptorView(const UsbConfigDescriptorView *view)
+{
+    if (!g_descriptorCache.ReleaseConfigDescriptorView(reinterpret_cast<const UsbDdkDescriptorView *>(view))) {
+        EDM_LOGE(MODULE_USB_DDK, "view was not obtained from OH_Usb_GetConfigDescriptorView");
+    }
+}
+
+int32_t OH_Usb_GetViewInterface(const UsbConfigDescriptorView *view, uint8_t interfaceNumber,
+    uint8_t alternateSetting, const UsbInterfaceDescriptor **desc)
+{
+    if (view == nullptr || desc == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "param is null");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    *desc = reinterpret_cast<const UsbDdkDescriptorView *>(view)->GetInterface(interfaceNumber, alternateSetting);
+    return EDM_OK;
+}
+
+int32_t OH_Usb_GetViewEndpoint(const UsbConfigDescriptorView *view, uint8_t interfaceNumber,
+    uint8_t alternateSetting, uint8_t endpointAddress, const UsbEndpointDescriptor **desc)
+{
+    if (view == nullptr || desc == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "param is null");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    *desc = reinterpret_cast<const UsbDdkDescriptorView *>(view)->GetEndpoint(
+        interfaceNumber, alternateSetting, endpointAddress);
+    return EDM_OK;
+}
+
+int32_t OH_Usb_GetViewParsedInterface(
+    const UsbConfigDescriptorView *view, uint8_t interfaceNumber, const UsbDdkInterface **usbInterface)
+{
+    if (view == nullptr || usbInterface == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "param is null");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    return reinterpret_cast<const UsbDdkDescriptorView *>(view)->GetParsedInterface(interfaceNumber, *usbInterface);
+}
+
+int32_t OH_Usb_InitViewIterator(
+    const UsbConfigDescriptorView *view, uint8_t descriptorType, UsbDescriptorIterator *iter)
+{
+    if (view == nullptr || iter == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "param is null");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    reinterpret_cast<const UsbDdkDescriptorView *>(view)->InitIterator(descriptorType, *iter);
+    return EDM_OK;
+}
+
+int32_t OH_Usb_InitViewInterfaceIterator(const UsbConfigDescriptorView *view, uint8_t interfaceNumber,
+    uint8_t alternateSetting, uint8_t descriptorType, UsbDescriptorIterator *iter)
+{
+    if (view == nullptr || iter == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "param is null");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    if (!reinterpret_cast<const UsbDdkDescriptorView *>(view)->InitIterator(
+        interfaceNumber, alternateSetting, descriptorType, *iter)) {
+        EDM_LOGE(MODULE_USB_DDK, "alternate setting %{public}u of interface %{public}u not found", alternateSetting,
+            interfaceNumber);
+        return USB_DDK_INVALID_PARAMETER;
+    }
+    return EDM_OK;
+}
+
+int32_t OH_Usb_NextViewDescriptor(
+    const UsbConfigDescriptorView *view, UsbDescriptorIterator *iter, const uint8_t **desc)
+{
+    if (view == nullptr || iter == nullptr || desc == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "param is null");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    *desc = reinterpret_cast<const UsbDdkDescriptorView *>(view)->Next(*iter);
+    return EDM_OK;
 }
 
 int32_t OH_Usb_ClaimInterface(uint64_t deviceId, uint8_t interfaceIndex, uint64_t *interfaceHandle)
 {
-    if (g_ddk == nullptr) {
+    auto ddk = GetDdk();
+    if (ddk == nullptr) {
         EDM_LOGE(MODULE_USB_DDK, "invalid obj");
         return USB_DDK_INVALID_OPERATION;
     }
@@ -108,32 +446,44 @@ int32_t OH_Usb_ClaimInterface(uint64_t deviceId, uint8_t interfaceIndex, uint64_
         return USB_DDK_INVALID_PARAMETER;
     }
 
-    return g_ddk->ClaimInterface(deviceId, interfaceIndex, *interfaceHandle);
+    int32_t ret = ddk->ClaimInterface(deviceId, interfaceIndex, *interfaceHandle);
+    if (ret != EDM_OK) {
+        // the device may have been detached, so its descriptors must be read again
+        g_descriptorCache.Invalidate(deviceId);
+        return ret;
+    }
+
+    // the id may belong to another device since the descriptors were cached, they are checked on their next use
+    g_descriptorCache.RequestValidation(deviceId);
+    return EDM_OK;
 }
 
 int32_t OH_Usb_ReleaseInterface(uint64_t interfaceHandle)
 {
-    if (g_ddk == nullptr) {
+    auto ddk = GetDdk();
+    if (ddk == nullptr) {
         EDM_LOGE(MODULE_USB_DDK, "invalid obj");
         return USB_DDK_INVALID_OPERATION;
     }
 
-    return g_ddk->ReleaseInterface(interfaceHandle);
+    return ddk->ReleaseInterface(interfaceHandle);
 }
 
 int32_t OH_Usb_SelectInterfaceSetting(uint64_t interfaceHandle, uint8_t settingIndex)
 {
-    if (g_ddk == nullptr) {
+    auto ddk = GetDdk();
+    if (ddk == nullptr) {
         EDM_LOGE(MODULE_USB_DDK, "invalid obj");
         return USB_DDK_INVALID_OPERATION;
     }
 
-    return g_ddk->SelectInterfaceSetting(interfaceHandle, settingIndex);
+    return ddk->SelectInterfaceSetting(interfaceHandle, settingIndex);
 }
 
 int32_t OH_Usb_GetCurrentInterfaceSetting(uint64_t interfaceHandle, uint8_t *settingIndex)
 {
-    if (g_ddk == nullptr) {
+    auto ddk = GetDdk();
+    if (ddk == nullptr) {
         EDM_LOGE(MODULE_USB_DDK, "invalid obj");
         return USB_DDK_INVALID_OPERATION;
     }
@@ -143,13 +493,14 @@ int32_t OH_Usb_GetCurrentInterfaceSetting(uint64_t interfaceHandle, uint8_t *set
         return USB_DDK_INVALID_PARAMETER;
     }
 
-    return g_ddk->GetCurrentInterfaceSetting(interfaceHandle, *settingIndex);
+    return ddk->GetCurrentInterfaceSetting(interfaceHandle, *settingIndex);
 }
 
 int32_t OH_Usb_SendControlReadRequest(
     uint64_t interfaceHandle, const UsbControlRequestSetup *setup, uint32_t timeout, uint8_t *data, uint32_t *dataLen)
 {
-    if (g_ddk == nullptr) {
+    auto ddk = GetDdk();
+    if (ddk == nullptr) {
         EDM_LOGE(MODULE_USB_DDK, "invalid obj");
         return USB_DDK_INVALID_OPERATION;
     }
@@ -159,48 +510,131 @@ int32_t OH_Usb_SendControlReadRequest(
         return USB_DDK_INVALID_PARAMETER;
     }
 
-    auto tmpSetUp = reinterpret_cast<const OHOS::HDI::Usb::Ddk::V1_0::UsbControlRequestSetup *>(setup);
-    std::vector<uint8_t> dataTmp;
-    int32_t ret = g_ddk->SendControlReadRequest(interfaceHandle, *tmpSetUp, timeout, dataTmp);
-    if (ret != 0) {
-        EDM_LOGE(MODULE_USB_DDK, "send control req failed");
-        return ret;
+    return SendControlReadRequestInner(ddk, interfaceHandle, *setup, timeout, data, *dataLen);
+}
+
+int32_t OH_Usb_SendControlWriteRequest(uint64_t interfaceHandle, const UsbControlRequestSetup *setup, uint32_t timeout,
+    const uint8_t *data, uint32_t dataLen)
+{
+    auto ddk = GetDdk();
+    if (ddk == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "invalid obj");
+        return USB_DDK_INVALID_OPERATION;
     }
 
-    if (*dataLen < dataTmp.size()) {
-        EDM_LOGE(MODULE_USB_DDK, "The data is too small");
+    if (setup == nullptr || data == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "param is null");
         return USB_DDK_INVALID_PARAMETER;
     }
 
-    if (memcpy_s(data, *dataLen, dataTmp.data(), dataTmp.size()) != 0) {
-        EDM_LOGE(MODULE_USB_DDK, "copy data failed");
-        return USB_DDK_MEMORY_ERROR;
+    return SendControlWriteRequestInner(ddk, interfaceHandle, *setup, timeout, data, dataLen);
+}
+
+int32_t OH_Usb_SendControlRequests(
+    uint64_t interfaceHandle, uint32_t timeout, UsbControlTransfer *transfers, uint32_t count, uint32_t *completed)
+{
+    auto ddk = GetDdk();
+    if (ddk == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "invalid obj");
+        return USB_DDK_INVALID_OPERATION;
     }
-    *dataLen = dataTmp.size();
-    return EDM_OK;
+
+    if (transfers == nullptr || count == 0 || completed == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "param is null");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    *completed = 0;
+    int32_t ret = EDM_OK;
+    for (uint32_t i = 0; i < count; ++i) {
+        UsbControlTransfer &transfer = transfers[i];
+        transfer.transferedLength = 0;
+        if (ret != EDM_OK) {
+            transfer.status = USB_DDK_INVALID_OPERATION;
+            continue;
+        }
+        if (transfer.data == nullptr && transfer.dataLen != 0) {
+            EDM_LOGE(MODULE_USB_DDK, "data of transfer %{public}u is null", i);
+            transfer.status = USB_DDK_INVALID_PARAMETER;
+            ret = transfer.status;
+            continue;
+        }
+
+        if ((transfer.setup.bmRequestType & USB_ENDPOINT_DIR_IN) != 0) {
+            uint32_t dataLen = transfer.dataLen;
+            transfer.status =
+                SendControlReadRequestInner(ddk, interfaceHandle, transfer.setup, timeout, transfer.data, dataLen);
+            transfer.transferedLength = (transfer.status == EDM_OK) ? dataLen : 0;
+        } else {
+            transfer.status = SendControlWriteRequestInner(
+                ddk, interfaceHandle, transfer.setup, timeout, transfer.data, transfer.dataLen);
+            transfer.transferedLength = (transfer.status == EDM_OK) ? transfer.dataLen : 0;
+        }
+        if (transfer.status != EDM_OK) {
+            EDM_LOGE(MODULE_USB_DDK, "transfer %{public}u failed: %{public}d", i, transfer.status);
+            ret = transfer.status;
+            continue;
+        }
+        ++(*completed);
+    }
+    return ret;
 }
 
-int32_t OH_Usb_SendControlWriteRequest(uint64_t interfaceHandle, const UsbControlRequestSetup *setup, uint32_t timeout,
-    const uint8_t *data, uint32_t dataLen)
+int32_t OH_Usb_SendControlReadRequestWithMemMap(
+    uint64_t interfaceHandle, const UsbControlRequestSetup *setup, uint32_t timeout, UsbDeviceMemMap *devMmap)
 {
-    if (g_ddk == nullptr) {
+    auto ddk = GetDdk();
+    if (ddk == nullptr) {
         EDM_LOGE(MODULE_USB_DDK, "invalid obj");
         return USB_DDK_INVALID_OPERATION;
     }
 
-    if (setup == nullptr || data == nullptr) {
+    if (setup == nullptr || devMmap == nullptr || devMmap->address == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "param is null");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    if (!IsMemMapRangeValid(*devMmap)) {
+        EDM_LOGE(MODULE_USB_DDK, "buffer is out of the memory map");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    uint32_t dataLen = devMmap->bufferLength;
+    int32_t ret = SendControlReadRequestInner(ddk, interfaceHandle, *setup, timeout, devMmap->address + devMmap->offset,
+        dataLen);
+    devMmap->transferedLength = (ret == EDM_OK) ? dataLen : 0;
+    return ret;
+}
+
+int32_t OH_Usb_SendControlWriteRequestWithMemMap(
+    uint64_t interfaceHandle, const UsbControlRequestSetup *setup, uint32_t timeout, UsbDeviceMemMap *devMmap)
+{
+    auto ddk = GetDdk();
+    if (ddk == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "invalid obj");
+        return USB_DDK_INVALID_OPERATION;
+    }
+
+    if (setup == nullptr || devMmap == nullptr || devMmap->address == nullptr) {
         EDM_LOGE(MODULE_USB_DDK, "param is null");
         return USB_DDK_INVALID_PARAMETER;
     }
 
-    auto tmpSetUp = reinterpret_cast<const OHOS::HDI::Usb::Ddk::V1_0::UsbControlRequestSetup *>(setup);
-    std::vector<uint8_t> dataTmp(data, data + dataLen);
-    return g_ddk->SendControlWriteRequest(interfaceHandle, *tmpSetUp, timeout, dataTmp);
+    if (!IsMemMapRangeValid(*devMmap)) {
+        EDM_LOGE(MODULE_USB_DDK, "buffer is out of the memory map");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    int32_t ret = SendControlWriteRequestInner(
+        ddk, interfaceHandle, *setup, timeout, devMmap->address + devMmap->offset, devMmap->bufferLength);
+    devMmap->transferedLength = (ret == EDM_OK) ? devMmap->bufferLength : 0;
+    return ret;
 }
 
 int32_t OH_Usb_SendPipeRequest(const UsbRequestPipe *pipe, UsbDeviceMemMap *devMmap)
 {
-    if (g_ddk == nullptr) {
+    auto ddk = GetDdk();
+    if (ddk == nullptr) {
         EDM_LOGE(MODULE_USB_DDK, "invalid obj");
         return USB_DDK_INVALID_OPERATION;
     }
@@ -210,25 +644,355 @@ int32_t OH_Usb_SendPipeRequest(const UsbRequestPipe *pipe, UsbDeviceMemMap *devM
         return USB_DDK_INVALID_PARAMETER;
     }
 
-    auto tmpSetUp = reinterpret_cast<const OHOS::HDI::Usb::Ddk::V1_0::UsbRequestPipe *>(pipe);
-    return g_ddk->SendPipeRequest(
-        *tmpSetUp, devMmap->size, devMmap->offset, devMmap->bufferLength, devMmap->transferedLength);
+    return SendMemMapPipeRequest(*pipe, *devMmap);
+}
+
+int32_t OH_Usb_SendPipeRequestVectored(const UsbRequestPipe *pipe, UsbDeviceMemMap *devMmap,
+    UsbMemMapSegment *segments, uint32_t count, uint32_t *transferedLength)
+{
+    auto ddk = GetDdk();
+    if (ddk == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "invalid obj");
+        return USB_DDK_INVALID_OPERATION;
+    }
+
+    if (pipe == nullptr || devMmap == nullptr || devMmap->address == nullptr || segments == nullptr || count == 0 ||
+        transferedLength == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "param is null");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+        if (segments[i].offset > devMmap->size || segments[i].length > devMmap->size - segments[i].offset) {
+            EDM_LOGE(MODULE_USB_DDK, "segment %{public}u is out of the memory map", i);
+            return USB_DDK_INVALID_PARAMETER;
+        }
+        segments[i].transferedLength = 0;
+    }
+
+    // the service addresses the memory map from the start of its mapping, which differs for pooled memory maps
+    uint32_t size = devMmap->size;
+    uint32_t base = 0;
+    if (UsbDdkMemMapPool::Translate(*devMmap, size, base)) {
+        base -= devMmap->offset;
+    } else {
+        size = devMmap->size;
+        base = 0;
+    }
+
+    *transferedLength = 0;
+    uint32_t first = 0;
+    while (first < count) {
+        // adjacent segments are sent in one transfer
+        uint32_t last = first;
+        uint64_t length = segments[first].length;
+        while (last + 1 < count &&
+            static_cast<uint64_t>(segments[last].offset) + segments[last].length == segments[last + 1].offset &&
+            length + segments[last + 1].length <= UINT32_MAX) {
+            ++last;
+            length += segments[last].length;
+        }
+
+        uint32_t transfered = 0;
+        int32_t ret = SendPipeRequestInner(
+            *pipe, size, base + segments[first].offset, static_cast<uint32_t>(length), transfered);
+        if (ret != EDM_OK) {
+            EDM_LOGE(MODULE_USB_DDK, "send segment %{public}u failed: %{public}d", first, ret);
+            return ret;
+        }
+        *transferedLength += transfered;
+        for (uint32_t i = first; i <= last; ++i) {
+            segments[i].transferedLength = std::min(segments[i].length, transfered);
+            transfered -= segments[i].transferedLength;
+        }
+        if (segments[last].transferedLength < segments[last].length) {
+            break;
+        }
+        first = last + 1;
+    }
+    return EDM_OK;
+}
+
+int32_t OH_Usb_SubmitPipeRequest(const UsbRequestPipe *pipe, UsbDeviceMemMap *devMmap, uint64_t *requestId)
+{
+    auto ddk = GetDdk();
+    if (ddk == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "invalid obj");
+        return USB_DDK_INVALID_OPERATION;
+    }
+
+    if (pipe == nullptr || devMmap == nullptr || devMmap->address == nullptr || requestId == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "param is null");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    std::lock_guard<std::mutex> lock(g_requestQueueMutex);
+    if (g_requestQueue == nullptr || g_requestQueue->IsStopped()) {
+        g_requestQueue = std::make_shared<UsbDdkRequestQueue>(SendMemMapPipeRequest);
+    }
+    return g_requestQueue->Submit(*pipe, devMmap, *requestId);
+}
+
+int32_t OH_Usb_ReapPipeRequests(
+    UsbPipeRequestCompletion *completions, uint32_t count, uint32_t timeout, uint32_t *reaped)
+{
+    if (completions == nullptr || count == 0 || reaped == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "invalid param");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    std::shared_ptr<UsbDdkRequestQueue> requestQueue;
+    {
+        std::lock_guard<std::mutex> lock(g_requestQueueMutex);
+        requestQueue = g_requestQueue;
+    }
+    if (requestQueue == nullptr) {
+        *reaped = 0;
+        return EDM_OK;
+    }
+    return requestQueue->Reap(completions, count, timeout, *reaped);
+}
+
+int32_t OH_Usb_CreateTransferRing(UsbDeviceMemMap *devMmap, uint32_t entries, UsbTransferRing **ring)
+{
+    auto ddk = GetDdk();
+    if (ddk == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "invalid obj");
+        return USB_DDK_INVALID_OPERATION;
+    }
+
+    if (devMmap == nullptr || devMmap->address == nullptr || ring == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "param is null");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    uint32_t size = 0;
+    uint32_t offset = 0;
+    int32_t ret = TranslateMemMap(*devMmap, size, offset);
+    if (ret != EDM_OK) {
+        return ret;
+    }
+    std::unique_ptr<UsbDdkTransferRing> transferRing;
+    ret = UsbDdkTransferRing::Create(SendMemMapPipeRequest, *devMmap, size, offset, entries, transferRing);
+    if (ret != EDM_OK) {
+        EDM_LOGE(MODULE_USB_DDK, "create transfer ring failed: %{public}d", ret);
+        return ret;
+    }
+
+    *ring = reinterpret_cast<UsbTransferRing *>(transferRing.release());
+    return EDM_OK;
+}
+
+int32_t OH_Usb_GetRingSubmission(UsbTransferRing *ring, UsbRingSubmission **submission)
+{
+    if (ring == nullptr || submission == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "param is null");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    return reinterpret_cast<UsbDdkTransferRing *>(ring)->GetSubmission(*submission);
+}
+
+int32_t OH_Usb_SubmitTransferRing(UsbTransferRing *ring)
+{
+    if (ring == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "param is null");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    reinterpret_cast<UsbDdkTransferRing *>(ring)->Submit();
+    return EDM_OK;
+}
+
+int32_t OH_Usb_PeekRingCompletion(UsbTransferRing *ring, UsbRingCompletion **completion)
+{
+    if (ring == nullptr || completion == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "param is null");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    reinterpret_cast<UsbDdkTransferRing *>(ring)->PeekCompletion(*completion);
+    return EDM_OK;
+}
+
+int32_t OH_Usb_AdvanceRingCompletion(UsbTransferRing *ring, uint32_t count)
+{
+    if (ring == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "param is null");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    reinterpret_cast<UsbDdkTransferRing *>(ring)->AdvanceCompletion(count);
+    return EDM_OK;
+}
+
+int32_t OH_Usb_GetTransferRingEventFd(UsbTransferRing *ring, int32_t *fd)
+{
+    if (ring == nullptr || fd == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "param is null");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    *fd = reinterpret_cast<UsbDdkTransferRing *>(ring)->GetEventFd();
+    return EDM_OK;
+}
+
+void OH_Usb_DestroyTransferRing(UsbTransferRing *ring)
+{
+    if (ring == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "ring is nullptr");
+        return;
+    }
+
+    delete reinterpret_cast<UsbDdkTransferRing *>(ring);
+}
+
+int32_t OH_Usb_CreateReadStream(
+    const UsbRequestPipe *pipe, UsbDeviceMemMap *devMmap, uint32_t bufferCount, UsbReadStream **stream)
+{
+    auto ddk = GetDdk();
+    if (ddk == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "invalid obj");
+        return USB_DDK_INVALID_OPERATION;
+    }
+
+    if (pipe == nullptr || devMmap == nullptr || devMmap->address == nullptr || stream == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "param is null");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    uint32_t size = 0;
+    uint32_t offset = 0;
+    int32_t ret = TranslateMemMap(*devMmap, size, offset);
+    if (ret != EDM_OK) {
+        return ret;
+    }
+    std::unique_ptr<UsbDdkReadStream> readStream;
+    ret = UsbDdkReadStream::Create(*pipe, SendMemMapPipeRequest, *devMmap, size, offset, bufferCount, readStream);
+    if (ret != EDM_OK) {
+        EDM_LOGE(MODULE_USB_DDK, "create read stream failed: %{public}d", ret);
+        return ret;
+    }
+
+    *stream = reinterpret_cast<UsbReadStream *>(readStream.release());
+    return EDM_OK;
+}
+
+int32_t OH_Usb_AcquireReadStreamBuffer(UsbReadStream *stream, uint32_t timeout, UsbStreamBuffer *buffer)
+{
+    if (stream == nullptr || buffer == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "param is null");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    return reinterpret_cast<UsbDdkReadStream *>(stream)->Acquire(timeout, *buffer);
+}
+
+int32_t OH_Usb_ReleaseReadStreamBuffer(UsbReadStream *stream, const UsbStreamBuffer *buffer)
+{
+    if (stream == nullptr || buffer == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "param is null");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    return reinterpret_cast<UsbDdkReadStream *>(stream)->Release(*buffer);
+}
+
+void OH_Usb_DestroyReadStream(UsbReadStream *stream)
+{
+    if (stream == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "stream is nullptr");
+        return;
+    }
+
+    delete reinterpret_cast<UsbDdkReadStream *>(stream);
+}
+
+int32_t OH_Usb_CreateIsoStream(const UsbRequestPipe *pipe, UsbDeviceMemMap *devMmap,
+    const UsbIsoStreamParams *params, UsbIsoStream **stream)
+{
+    auto ddk = GetDdk();
+    if (ddk == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "invalid obj");
+        return USB_DDK_INVALID_OPERATION;
+    }
+
+    if (pipe == nullptr || devMmap == nullptr || devMmap->address == nullptr || params == nullptr ||
+        stream == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "param is null");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    uint32_t size = 0;
+    uint32_t offset = 0;
+    int32_t ret = TranslateMemMap(*devMmap, size, offset);
+    if (ret != EDM_OK) {
+        return ret;
+    }
+    std::unique_ptr<UsbDdkIsoStream> isoStream;
+    ret = UsbDdkIsoStream::Create(*pipe, SendMemMapPipeRequest, *devMmap, size, offset, *params, isoStream);
+    if (ret != EDM_OK) {
+        EDM_LOGE(MODULE_USB_DDK, "create iso stream failed: %{public}d", ret);
+        return ret;
+    }
+
+    *stream = reinterpret_cast<UsbIsoStream *>(isoStream.release());
+    return EDM_OK;
+}
+
+int32_t OH_Usb_AcquireIsoPackets(
+    UsbIsoStream *stream, uint32_t timeout, UsbIsoPacketDescriptor **packets, uint32_t *packetCount)
+{
+    if (stream == nullptr || packets == nullptr || packetCount == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "param is null");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    return reinterpret_cast<UsbDdkIsoStream *>(stream)->Acquire(timeout, *packets, *packetCount);
+}
+
+int32_t OH_Usb_SubmitIsoPackets(UsbIsoStream *stream, UsbIsoPacketDescriptor *packets)
+{
+    if (stream == nullptr || packets == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "param is null");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    return reinterpret_cast<UsbDdkIsoStream *>(stream)->Submit(packets);
+}
+
+void OH_Usb_DestroyIsoStream(UsbIsoStream *stream)
+{
+    if (stream == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "stream is nullptr");
+        return;
+    }
+
+    delete reinterpret_cast<UsbDdkIsoStream *>(stream);
 }
 
 int32_t OH_Usb_CreateDeviceMemMap(uint64_t deviceId, size_t size, UsbDeviceMemMap **devMmap)
 {
+    auto ddk = GetDdk();
+    if (ddk == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "invalid obj");
+        return USB_DDK_INVALID_OPERATION;
+    }
     if (devMmap == nullptr) {
         EDM_LOGE(MODULE_USB_DDK, "invalid param");
         return USB_DDK_INVALID_PARAMETER;
     }
 
     int32_t fd = -1;
-    int32_t ret = g_ddk->GetDeviceMemMapFd(deviceId, fd);
+    int32_t ret = ddk->GetDeviceMemMapFd(deviceId, fd);
     if (ret != EDM_OK) {
         EDM_LOGE(MODULE_USB_DDK, "get fd failed, errno=%{public}d", errno);
         return ret;
     }
-    ftruncate(fd, size);
+    ret = UsbDdkMemMapPool::ResizeDeviceMemory(deviceId, fd, size);
+    if (ret != EDM_OK) {
+        return ret;
+    }
 
     auto buffer = static_cast<uint8_t *>(mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
     if (buffer == MAP_FAILED) {
@@ -258,4 +1022,90 @@ void OH_Usb_DestroyDeviceMemMap(UsbDeviceMemMap *devMmap)
         return;
     }
     delete devMmap;
-}
\ No newline at end of file
+}
+
+int32_t OH_Usb_CreateDeviceMemMapPool(
+    uint64_t deviceId, uint32_t sliceSize, uint32_t sliceCount, uint32_t flags, UsbDeviceMemMapPool **pool)
+{
+    auto ddk = GetDdk();
+    if (ddk == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "invalid obj");
+        return USB_DDK_INVALID_OPERATION;
+    }
+    if (pool == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "invalid param");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    int32_t fd = -1;
+    int32_t ret = ddk->GetDeviceMemMapFd(deviceId, fd);
+    if (ret != EDM_OK) {
+        EDM_LOGE(MODULE_USB_DDK, "get fd failed, errno=%{public}d", errno);
+        return ret;
+    }
+
+    std::unique_ptr<UsbDdkMemMapPool> memMapPool;
+    ret = UsbDdkMemMapPool::Create(
+        deviceId, fd, sliceSize, sliceCount, (flags & USB_DDK_MEM_MAP_POOL_PREFAULT) != 0, memMapPool);
+    // the mapping stays valid after the fd is closed
+    close(fd);
+    if (ret != EDM_OK) {
+        EDM_LOGE(MODULE_USB_DDK, "create mem map pool failed: %{public}d", ret);
+        return ret;
+    }
+
+    *pool = reinterpret_cast<UsbDeviceMemMapPool *>(memMapPool.release());
+    return EDM_OK;
+}
+
+int32_t OH_Usb_AllocDeviceMemMap(UsbDeviceMemMapPool *pool, UsbDeviceMemMap **devMmap)
+{
+    if (pool == nullptr || devMmap == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "invalid param");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    return reinterpret_cast<UsbDdkMemMapPool *>(pool)->Alloc(*devMmap);
+}
+
+void OH_Usb_FreeDeviceMemMap(UsbDeviceMemMapPool *pool, UsbDeviceMemMap *devMmap)
+{
+    if (pool == nullptr || devMmap == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "invalid param");
+        return;
+    }
+
+    reinterpret_cast<UsbDdkMemMapPool *>(pool)->Free(devMmap);
+}
+
+int32_t OH_Usb_GetDeviceMemMapPoolStats(UsbDeviceMemMapPool *pool, UsbDeviceMemMapPoolStats *stats)
+{
+    if (pool == nullptr || stats == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "invalid param");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    reinterpret_cast<UsbDdkMemMapPool *>(pool)->GetStats(*stats);
+    return EDM_OK;
+}
+
+void OH_Usb_DestroyDeviceMemMapPool(UsbDeviceMemMapPool *pool)
+{
+    if (pool == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "pool is nullptr");
+        return;
+    }
+
+    delete reinterpret_cast<UsbDdkMemMapPool *>(pool);
+}
+
+int32_t OH_Usb_GetEndpointTransferPlan(
+    const UsbDdkEndpointDescriptor *endpoint, UsbDdkSpeed speed, UsbEndpointTransferPlan *plan)
+{
+    if (endpoint == nullptr || plan == nullptr) {
+        EDM_LOGE(MODULE_USB_DDK, "invalid param");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    return GetUsbEndpointTransferPlan(*endpoint, speed, *plan);
+}
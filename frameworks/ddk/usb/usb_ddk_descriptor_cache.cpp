@@ -0,0 +1,389 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "usb_ddk_descriptor_cache.h"
+
+#include <cinttypes>
+
+#include "edm_errors.h"
+#include "hilog_wrapper.h"
+#include "securec.h"
+#include "usb_config_desc_image.h"
+#include "usb_config_desc_parser.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+constexpr size_t IMAGE_NAME_LEN = 32;
+
+static bool IsSameDeviceDescriptor(const UsbDeviceDescriptor &lhs, const UsbDeviceDescriptor &rhs)
+{
+    return lhs.bLength == rhs.bLength && lhs.bDescriptorType == rhs.bDescriptorType && lhs.bcdUSB == rhs.bcdUSB &&
+        lhs.bDeviceClass == rhs.bDeviceClass && lhs.bDeviceSubClass == rhs.bDeviceSubClass &&
+        lhs.bDeviceProtocol == rhs.bDeviceProtocol && lhs.bMaxPacketSize0 == rhs.bMaxPacketSize0 &&
+        lhs.idVendor == rhs.idVendor && lhs.idProduct == rhs.idProduct && lhs.bcdDevice == rhs.bcdDevice &&
+        lhs.iManufacturer == rhs.iManufacturer && lhs.iProduct == rhs.iProduct &&
+        lhs.iSerialNumber == rhs.iSerialNumber && lhs.bNumConfigurations == rhs.bNumConfigurations;
+}
+
+UsbDdkDescriptorCache::ConfigEntry::~ConfigEntry()
+{
+    if (config == nullptr) {
+        return;
+    }
+    if (mapped) {
+        UnmapUsbConfigImage(config);
+    } else {
+        FreeUsbConfigDescriptor(config);
+    }
+}
+
+UsbDdkDescriptorCache::TableEntry::~TableEntry()
+{
+    if (table != nullptr) {
+        FreeUsbConfigDescriptorTable(table);
+    }
+}
+
+int32_t UsbDdkDescriptorCache::GetDeviceDescriptor(
+    uint64_t deviceId, UsbDeviceDescriptor &desc, const DeviceLoader &load)
+{
+    uint64_t generation = 0;
+    bool validate = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        validate = unvalidated_.count(deviceId) != 0;
+        auto it = devices_.find(deviceId);
+        if (it != devices_.end() && !validate) {
+            desc = it->second;
+            return EDM_OK;
+        }
+        generation = generations_[deviceId];
+    }
+
+    int32_t ret = load(desc);
+    if (ret != EDM_OK) {
+        return ret;
+    }
+    if (validate) {
+        Validate(deviceId, desc);
+        return EDM_OK;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (generations_[deviceId] == generation) {
+        devices_.emplace(deviceId, desc);
+    }
+    return EDM_OK;
+}
+
+int32_t UsbDdkDescriptorCache::LoadConfig(
+    uint64_t deviceId, uint8_t configIndex, const ConfigLoader &load, std::shared_ptr<ConfigEntry> &entry)
+{
+    ConfigKey key(deviceId, configIndex);
+    uint64_t generation = 0;
+    std::string imagePath;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = configs_.find(key);
+        if (it != configs_.end()) {
+            entry = it->second;
+            return EDM_OK;
+        }
+        generation = generations_[deviceId];
+        imagePath = GetImagePath(deviceId, configIndex);
+    }
+
+    // the service is called without the lock, a concurrent miss may load the same configuration
+    auto newEntry = std::make_shared<ConfigEntry>();
+    UsbConfigImage image = {};
+    if (!imagePath.empty() && MapUsbConfigImage(imagePath, image) == EDM_OK) {
+        // another device of the same model has been parsed before, so neither the service nor the parser is needed
+        newEntry->raw.assign(image.raw, image.raw + image.rawLen);
+        newEntry->config = image.config;
+        newEntry->mapped = true;
+        newEntry->parsed = true;
+        newEntry->parseResult = image.parseResult;
+    } else {
+        int32_t ret = load(newEntry->raw);
+        if (ret != EDM_OK) {
+            return ret;
+        }
+        newEntry->imagePath = std::move(imagePath);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = configs_.find(key);
+    if (it != configs_.end()) {
+        entry = it->second;
+    } else {
+        entry = newEntry;
+        if (generations_[deviceId] == generation) {
+            configs_.emplace(key, entry);
+        }
+    }
+    return EDM_OK;
+}
+
+std::string UsbDdkDescriptorCache::GetImagePath(uint64_t deviceId, uint8_t configIndex) const
+{
+    if (imageDirectory_.empty()) {
+        return "";
+    }
+    // the model of a device is only known once its device descriptor has been loaded
+    auto it = devices_.find(deviceId);
+    if (it == devices_.end()) {
+        return "";
+    }
+    char name[IMAGE_NAME_LEN] = {0};
+    if (sprintf_s(name, sizeof(name), "usb_%04x_%04x_%04x_%u.cfg", it->second.idVendor, it->second.idProduct,
+        it->second.bcdDevice, configIndex) < 0) {
+        EDM_LOGE(MODULE_USB_DDK, "format image name failed");
+        return "";
+    }
+    return imageDirectory_ + "/" + name;
+}
+
+void UsbDdkDescriptorCache::AddReference(const void *descriptor, const std::shared_ptr<void> &entry)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Reference &reference = references_[descriptor];
+    if (reference.entry == nullptr) {
+        reference.entry = entry;
+        reference.count = 0;
+    }
+    ++reference.count;
+}
+
+int32_t UsbDdkDescriptorCache::GetConfigDescriptor(
+    uint64_t deviceId, uint8_t configIndex, UsbDdkConfigDescriptor *&config, const ConfigLoader &load)
+{
+    std::shared_ptr<ConfigEntry> entry;
+    int32_t ret = LoadConfig(deviceId, configIndex, load, entry);
+    if (ret != EDM_OK) {
+        return ret;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(entry->mutex);
+        if (!entry->parsed) {
+            entry->parseResult = ParseUsbConfigDescriptor(entry->raw, &entry->config);
+            entry->parsed = true;
+            if (entry->parseResult >= 0 && !entry->imagePath.empty()) {
+                // a failed write only costs the next driver instance a parse
+                (void)WriteUsbConfigImage(entry->imagePath, entry->raw);
+            }
+        }
+    }
+    if (entry->parseResult < 0) {
+        return entry->parseResult;
+    }
+
+    AddReference(entry->config, entry);
+    config = entry->config;
+    return entry->parseResult;
+}
+
+int32_t UsbDdkDescriptorCache::GetConfigDescriptorView(
+    uint64_t deviceId, uint8_t configIndex, const UsbDdkDescriptorView *&view, const ConfigLoader &load)
+{
+    std::shared_ptr<ConfigEntry> entry;
+    int32_t ret = LoadConfig(deviceId, configIndex, load, entry);
+    if (ret != EDM_OK) {
+        return ret;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(entry->mutex);
+        if (!entry->indexed) {
+            entry->indexResult = UsbDdkDescriptorView::Create(entry->raw.data(), entry->raw.size(), entry->view);
+            entry->indexed = true;
+        }
+    }
+    if (entry->indexResult != EDM_OK) {
+        return entry->indexResult;
+    }
+
+    AddReference(entry->view.get(), entry);
+    view = entry->view.get();
+    return EDM_OK;
+}
+
+int32_t UsbDdkDescriptorCache::GetConfigDescriptorTable(uint64_t deviceId, uint8_t numConfigurations,
+    UsbDdkConfigDescriptorTable *&table, const IndexedConfigLoader &load)
+{
+    uint64_t generation = 0;
+    std::shared_ptr<TableEntry> entry;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = tables_.find(deviceId);
+        if (it != tables_.end()) {
+            entry = it->second;
+        } else {
+            generation = generations_[deviceId];
+        }
+    }
+
+    if (entry == nullptr) {
+        // the raw configurations come from the cache, so only the ones not loaded yet go to the service
+        std::vector<std::shared_ptr<ConfigEntry>> configs(numConfigurations);
+        std::vector<const std::vector<uint8_t> *> configBuffers(numConfigurations);
+        for (uint8_t i = 0; i < numConfigurations; ++i) {
+            uint8_t configIndex = i + 1;
+            int32_t ret = LoadConfig(deviceId, configIndex, [&load, configIndex](std::vector<uint8_t> &configBuffer) {
+                return load(configIndex, configBuffer);
+            }, configs[i]);
+            if (ret != EDM_OK) {
+                return ret;
+            }
+            configBuffers[i] = &configs[i]->raw;
+        }
+
+        auto newEntry = std::make_shared<TableEntry>();
+        int32_t ret = ParseUsbConfigDescriptorTable(configBuffers, &newEntry->table);
+        if (ret != EDM_OK) {
+            return ret;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = tables_.find(deviceId);
+        if (it != tables_.end()) {
+            entry = it->second;
+        } else {
+            entry = newEntry;
+            if (generations_[deviceId] == generation) {
+                tables_.emplace(deviceId, entry);
+            }
+        }
+    }
+
+    AddReference(entry->table, entry);
+    table = entry->table;
+    return EDM_OK;
+}
+
+bool UsbDdkDescriptorCache::ReleaseConfigDescriptor(UsbDdkConfigDescriptor *config)
+{
+    return ReleaseReference(config);
+}
+
+bool UsbDdkDescriptorCache::ReleaseConfigDescriptorView(const UsbDdkDescriptorView *view)
+{
+    return ReleaseReference(view);
+}
+
+bool UsbDdkDescriptorCache::ReleaseConfigDescriptorTable(UsbDdkConfigDescriptorTable *table)
+{
+    return ReleaseReference(table);
+}
+
+bool UsbDdkDescriptorCache::ReleaseReference(const void *descriptor)
+{
+    std::shared_ptr<void> entry;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = references_.find(descriptor);
+        if (it == references_.end()) {
+            return false;
+        }
+        if (--it->second.count == 0) {
+            // the entry is freed outside the lock when this was the last reference to an invalidated configuration
+            entry = std::move(it->second.entry);
+            references_.erase(it);
+        }
+    }
+    return true;
+}
+
+void UsbDdkDescriptorCache::Invalidate(uint64_t deviceId)
+{
+    std::vector<std::shared_ptr<ConfigEntry>> entries;
+    std::shared_ptr<TableEntry> tableEntry;
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++generations_[deviceId];
+    devices_.erase(deviceId);
+    unvalidated_.erase(deviceId);
+    auto table = tables_.find(deviceId);
+    if (table != tables_.end()) {
+        tableEntry = std::move(table->second);
+        tables_.erase(table);
+    }
+    auto first = configs_.lower_bound(ConfigKey(deviceId, 0));
+    auto last = configs_.upper_bound(ConfigKey(deviceId, UINT8_MAX));
+    for (auto it = first; it != last; ++it) {
+        entries.push_back(std::move(it->second));
+    }
+    configs_.erase(first, last);
+}
+
+void UsbDdkDescriptorCache::Validate(uint64_t deviceId, const UsbDeviceDescriptor &desc)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        unvalidated_.erase(deviceId);
+        auto it = devices_.find(deviceId);
+        if (it != devices_.end() && IsSameDeviceDescriptor(it->second, desc)) {
+            return;
+        }
+        // configurations may be cached without the device descriptor, then there is nothing to compare them with
+        if (it == devices_.end() && configs_.lower_bound(ConfigKey(deviceId, 0)) ==
+            configs_.upper_bound(ConfigKey(deviceId, UINT8_MAX)) && tables_.count(deviceId) == 0) {
+            devices_.emplace(deviceId, desc);
+            return;
+        }
+    }
+
+    EDM_LOGI(MODULE_USB_DDK, "descriptors of device %{public}" PRIu64 " changed, drop the cached ones", deviceId);
+    Invalidate(deviceId);
+    std::lock_guard<std::mutex> lock(mutex_);
+    devices_.emplace(deviceId, desc);
+}
+
+void UsbDdkDescriptorCache::RequestValidation(uint64_t deviceId)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    // nothing cached, nothing to validate
+    if (devices_.count(deviceId) == 0 && tables_.count(deviceId) == 0 &&
+        configs_.lower_bound(ConfigKey(deviceId, 0)) == configs_.upper_bound(ConfigKey(deviceId, UINT8_MAX))) {
+        return;
+    }
+    unvalidated_.insert(deviceId);
+}
+
+bool UsbDdkDescriptorCache::NeedsValidation(uint64_t deviceId)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return unvalidated_.count(deviceId) != 0;
+}
+
+void UsbDdkDescriptorCache::Clear()
+{
+    std::map<ConfigKey, std::shared_ptr<ConfigEntry>> configs;
+    std::map<uint64_t, std::shared_ptr<TableEntry>> tables;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &item : generations_) {
+        ++item.second;
+    }
+    devices_.clear();
+    unvalidated_.clear();
+    configs.swap(configs_);
+    tables.swap(tables_);
+}
+
+void UsbDdkDescriptorCache::SetImageDirectory(const std::string &directory)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    imageDirectory_ = directory;
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef USB_DDK_DESCRIPTOR_CACHE_H
+#define USB_DDK_DESCRIPTOR_CACHE_H
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "usb_ddk_descriptor_view.h"
+#include "usb_ddk_types.h"
+namespace OHOS {
+namespace ExternalDeviceManager {
+// Caches the descriptors of attached devices. Descriptors do not change while a device is attached, so only the
+// first request for a device or a configuration goes to the DDK service. The raw bytes of a configuration are parsed
+// or indexed the first time a caller asks for the parsed tree or the view of it. Both are shared by all callers and
+// are freed when the last caller has released them and the device has been invalidated.
+class UsbDdkDescriptorCache final {
+public:
+    using DeviceLoader = std::function<int32_t(UsbDeviceDescriptor &desc)>;
+    using ConfigLoader = std::function<int32_t(std::vector<uint8_t> &configBuffer)>;
+    using IndexedConfigLoader = std::function<int32_t(uint8_t configIndex, std::vector<uint8_t> &configBuffer)>;
+
+    UsbDdkDescriptorCache() = default;
+    ~UsbDdkDescriptorCache() = default;
+
+    int32_t GetDeviceDescriptor(uint64_t deviceId, UsbDeviceDescriptor &desc, const DeviceLoader &load);
+    int32_t GetConfigDescriptor(
+        uint64_t deviceId, uint8_t configIndex, UsbDdkConfigDescriptor *&config, const ConfigLoader &load);
+    int32_t GetConfigDescriptorView(
+        uint64_t deviceId, uint8_t configIndex, const UsbDdkDescriptorView *&view, const ConfigLoader &load);
+    // Loads the configurations 1 to numConfigurations and parses them into one table.
+    int32_t GetConfigDescriptorTable(uint64_t deviceId, uint8_t numConfigurations,
+        UsbDdkConfigDescriptorTable *&table, const IndexedConfigLoader &load);
+    // Returns false if the configuration was not obtained from the cache.
+    bool ReleaseConfigDescriptor(UsbDdkConfigDescriptor *config);
+    bool ReleaseConfigDescriptorView(const UsbDdkDescriptorView *view);
+    bool ReleaseConfigDescriptorTable(UsbDdkConfigDescriptorTable *table);
+    void Invalidate(uint64_t deviceId);
+    // Compares the device descriptor just read from the device with the cached one. A device that was replugged may
+    // have been given the id of another, so everything cached for the id is dropped unless both are the same.
+    void Validate(uint64_t deviceId, const UsbDeviceDescriptor &desc);
+    // Called when an interface of the device is claimed. The next GetDeviceDescriptor of the device reads the device
+    // descriptor again and validates the cache with it, so the claim itself costs no request to the service.
+    void RequestValidation(uint64_t deviceId);
+    bool NeedsValidation(uint64_t deviceId);
+    void Clear();
+    // Configurations of a device whose device descriptor has been loaded are mapped from the images in directory, which
+    // are named after the model of the device. A configuration without an image is loaded from the service, and its
+    // image is written once it has been parsed. An empty directory turns images off.
+    void SetImageDirectory(const std::string &directory);
+
+private:
+    UsbDdkDescriptorCache(const UsbDdkDescriptorCache &) = delete;
+    UsbDdkDescriptorCache &operator=(const UsbDdkDescriptorCache &) = delete;
+
+    struct ConfigEntry {
+        ~ConfigEntry();
+
+        std::vector<uint8_t> raw;
+        // guards the lazily built members below
+        std::mutex mutex;
+        bool parsed {false};
+        UsbDdkConfigDescriptor *config {nullptr};
+        // the configuration is mapped from an image instead of being parsed
+        bool mapped {false};
+        // the image to write once the configuration has been parsed, empty if none
+        std::string imagePath;
+        // result of parsing, a positive value is the number of bytes that were not parsed
+        int32_t parseResult {0};
+        bool indexed {false};
+        std::unique_ptr<UsbDdkDescriptorView> view;
+        int32_t indexResult {0};
+    };
+    struct TableEntry {
+        ~TableEntry();
+
+        UsbDdkConfigDescriptorTable *table {nullptr};
+    };
+    struct Reference {
+        // the configuration or table entry that owns the descriptor
+        std::shared_ptr<void> entry;
+        uint32_t count;
+    };
+    using ConfigKey = std::pair<uint64_t, uint8_t>;
+
+    int32_t LoadConfig(
+        uint64_t deviceId, uint8_t configIndex, const ConfigLoader &load, std::shared_ptr<ConfigEntry> &entry);
+    // Must be called with mutex_ held.
+    std::string GetImagePath(uint64_t deviceId, uint8_t configIndex) const;
+    void AddReference(const void *descriptor, const std::shared_ptr<void> &entry);
+    bool ReleaseReference(const void *descriptor);
+
+    std::mutex mutex_;
+    std::map<uint64_t, UsbDeviceDescriptor> devices_;
+    std::map<ConfigKey, std::shared_ptr<ConfigEntry>> configs_;
+    std::map<uint64_t, std::shared_ptr<TableEntry>> tables_;
+    // references by the parsed configuration, view or table handed out
+    std::unordered_map<const void *, Reference> references_;
+    // bumped on invalidation, so that descriptors loaded before it are not cached
+    std::map<uint64_t, uint64_t> generations_;
+    // devices whose cached descriptors have to be validated before they are served again
+    std::set<uint64_t> unvalidated_;
+    std::string imageDirectory_;
+};
+} // namespace ExternalDeviceManager
+} // namespace OHOS
+#endif // USB_DDK_DESCRIPTOR_CACHE_H
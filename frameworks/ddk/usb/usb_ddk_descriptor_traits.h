@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef USB_DDK_DESCRIPTOR_TRAITS_H
+#define USB_DDK_DESCRIPTOR_TRAITS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "usb_ddk_types.h"
+namespace OHOS {
+namespace ExternalDeviceManager {
+// SuperSpeed endpoint companion descriptor, found in the extra descriptors of an endpoint.
+struct UsbSsEndpointCompanionDescriptor {
+    uint8_t bLength;
+    uint8_t bDescriptorType;
+    uint8_t bMaxBurst;
+    uint8_t bmAttributes;
+    uint16_t wBytesPerInterval;
+} __attribute__((packed));
+
+// Binary device object store descriptor, the header of the BOS descriptor set.
+struct UsbBosDescriptor {
+    uint8_t bLength;
+    uint8_t bDescriptorType;
+    uint16_t wTotalLength;
+    uint8_t bNumDeviceCaps;
+} __attribute__((packed));
+
+// Layout of a standard descriptor: its type, its minimum length, and the offsets of its little-endian 16-bit fields.
+// A descriptor is decoded by a copy of a known size followed by a fixed list of byte swaps, which the compiler turns
+// into straight-line code.
+template <typename T>
+struct UsbDescriptorTraits;
+
+template <>
+struct UsbDescriptorTraits<UsbConfigDescriptor> {
+    static constexpr uint8_t TYPE = 0x02;
+    static constexpr uint8_t MIN_LENGTH = 0x09;
+    static constexpr std::array<size_t, 1> LE16_FIELDS = {offsetof(UsbConfigDescriptor, wTotalLength)};
+};
+
+template <>
+struct UsbDescriptorTraits<UsbInterfaceDescriptor> {
+    static constexpr uint8_t TYPE = 0x04;
+    static constexpr uint8_t MIN_LENGTH = 0x09;
+    static constexpr std::array<size_t, 0> LE16_FIELDS = {};
+};
+
+template <>
+struct UsbDescriptorTraits<UsbEndpointDescriptor> {
+    static constexpr uint8_t TYPE = 0x05;
+    static constexpr uint8_t MIN_LENGTH = 0x07;
+    static constexpr std::array<size_t, 1> LE16_FIELDS = {offsetof(UsbEndpointDescriptor, wMaxPacketSize)};
+};
+
+template <>
+struct UsbDescriptorTraits<UsbBosDescriptor> {
+    static constexpr uint8_t TYPE = 0x0f;
+    static constexpr uint8_t MIN_LENGTH = 0x05;
+    static constexpr std::array<size_t, 1> LE16_FIELDS = {offsetof(UsbBosDescriptor, wTotalLength)};
+};
+
+template <>
+struct UsbDescriptorTraits<UsbSsEndpointCompanionDescriptor> {
+    static constexpr uint8_t TYPE = 0x30;
+    static constexpr uint8_t MIN_LENGTH = 0x06;
+    static constexpr std::array<size_t, 1> LE16_FIELDS = {
+        offsetof(UsbSsEndpointCompanionDescriptor, wBytesPerInterval)};
+};
+
+constexpr uint16_t LoadLe16(const uint8_t *source)
+{
+    return static_cast<uint16_t>(source[0] | (source[1] << 8));
+}
+
+// Returns true if the descriptor at source has the type of T, is at least as long as T, and fits in sourceLen.
+template <typename T>
+inline bool IsValidDescriptor(const uint8_t *source, size_t sourceLen)
+{
+    using Traits = UsbDescriptorTraits<T>;
+    return sourceLen >= Traits::MIN_LENGTH && source[0] >= Traits::MIN_LENGTH && source[0] <= sourceLen &&
+        source[1] == Traits::TYPE;
+}
+
+// Decodes the first MIN_LENGTH bytes at source into dest in host byte order. The caller checks that sourceLen is at
+// least MIN_LENGTH, see IsValidDescriptor.
+template <typename T>
+inline void DecodeDescriptor(const uint8_t *source, T &dest)
+{
+    using Traits = UsbDescriptorTraits<T>;
+    static_assert(sizeof(T) >= Traits::MIN_LENGTH, "descriptor structure is shorter than its standard length");
+    // a copy of a constant size is inlined, unlike memcpy_s
+    std::memcpy(&dest, source, Traits::MIN_LENGTH);
+    for (size_t offset : Traits::LE16_FIELDS) {
+        uint16_t value = LoadLe16(source + offset);
+        std::memcpy(reinterpret_cast<uint8_t *>(&dest) + offset, &value, sizeof(value));
+    }
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
+#endif // USB_DDK_DESCRIPTOR_TRAITS_H
@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "usb_ddk_descriptor_view.h"
+
+#include <algorithm>
+
+#include "edm_errors.h"
+#include "hilog_wrapper.h"
+#include "usb_config_desc_parser.h"
+#include "usb_ddk_descriptor_traits.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+namespace {
+constexpr uint8_t DESC_HEADER_LENGTH = 2;
+constexpr uint8_t USB_DDK_DT_CONFIG = UsbDescriptorTraits<UsbConfigDescriptor>::TYPE;
+constexpr uint8_t USB_DDK_DT_INTERFACE = UsbDescriptorTraits<UsbInterfaceDescriptor>::TYPE;
+constexpr uint8_t USB_DDK_DT_ENDPOINT = UsbDescriptorTraits<UsbEndpointDescriptor>::TYPE;
+constexpr uint8_t USB_DDK_DT_CONFIG_SIZE = UsbDescriptorTraits<UsbConfigDescriptor>::MIN_LENGTH;
+constexpr uint8_t USB_DDK_DT_INTERFACE_SIZE = UsbDescriptorTraits<UsbInterfaceDescriptor>::MIN_LENGTH;
+constexpr uint8_t USB_DDK_DT_ENDPOINT_SIZE = UsbDescriptorTraits<UsbEndpointDescriptor>::MIN_LENGTH;
+constexpr uint8_t USB_ENDPOINT_NUMBER_MASK = 0x0f;
+constexpr uint8_t USB_ENDPOINT_DIR_IN = 0x80;
+constexpr uint8_t USB_ENDPOINT_DIR_SLOT_SHIFT = 3;
+
+// IN endpoints take the upper half of the slots
+inline uint32_t EndpointSlot(uint8_t endpointAddress)
+{
+    return (endpointAddress & USB_ENDPOINT_NUMBER_MASK) |
+        ((endpointAddress & USB_ENDPOINT_DIR_IN) >> USB_ENDPOINT_DIR_SLOT_SHIFT);
+}
+} // namespace
+
+UsbDdkDescriptorView::~UsbDdkDescriptorView()
+{
+    for (auto &item : parsedInterfaces_) {
+        FreeUsbInterfaceDescriptor(item.second);
+    }
+}
+
+int32_t UsbDdkDescriptorView::Create(const uint8_t *data, size_t length, std::unique_ptr<UsbDdkDescriptorView> &view)
+{
+    if (data == nullptr || length < USB_DDK_DT_CONFIG_SIZE || data[0] < USB_DDK_DT_CONFIG_SIZE ||
+        data[0] > length || data[1] != USB_DDK_DT_CONFIG) {
+        EDM_LOGE(MODULE_USB_DDK, "invalid configuration descriptor, length = %{public}zu", length);
+        return USB_DDK_INVALID_OPERATION;
+    }
+
+    view.reset(new UsbDdkDescriptorView(data, length));
+    view->Index();
+    return EDM_OK;
+}
+
+bool UsbDdkDescriptorView::IsValidAt(size_t offset) const
+{
+    return length_ - offset >= DESC_HEADER_LENGTH && data_[offset] >= DESC_HEADER_LENGTH &&
+        data_[offset] <= length_ - offset;
+}
+
+bool UsbDdkDescriptorView::IsInterfaceAt(size_t offset) const
+{
+    return data_[offset + 1] == USB_DDK_DT_INTERFACE && data_[offset] >= USB_DDK_DT_INTERFACE_SIZE;
+}
+
+void UsbDdkDescriptorView::Index()
+{
+    // the first pass counts the descriptors and the alternate settings of every interface, so the second pass writes
+    // the alternate settings grouped by interface number in place
+    size_t descriptorCount = 0;
+    uint32_t maxInterfaceNumber = 0;
+    size_t offset = 0;
+    for (; IsValidAt(offset); offset += data_[offset]) {
+        ++descriptorCount;
+        if (IsInterfaceAt(offset)) {
+            uint8_t interfaceNumber =
+                reinterpret_cast<const UsbInterfaceDescriptor *>(data_ + offset)->bInterfaceNumber;
+            uint8_t &count = altSettingCount_[interfaceNumber];
+            count += count < UINT8_MAX ? 1 : 0;
+            maxInterfaceNumber = std::max<uint32_t>(maxInterfaceNumber, interfaceNumber);
+        }
+    }
+    if (length_ - offset >= DESC_HEADER_LENGTH) {
+        EDM_LOGW(MODULE_USB_DDK, "invalid descriptor length %{public}hhu, skipping remainder", data_[offset]);
+    }
+
+    // firstAltSetting_ is only valid for interface numbers with alternate settings
+    uint16_t next = 0;
+    for (uint32_t number = 0; number <= maxInterfaceNumber; ++number) {
+        if (altSettingCount_[number] != 0) {
+            firstAltSetting_[number] = next;
+            next += altSettingCount_[number];
+        }
+    }
+    altSettings_.resize(next);
+    offsets_.reserve(descriptorCount);
+
+    std::array<uint8_t, UINT8_MAX + 1> filled {};
+    AltSetting *current = nullptr;
+    for (offset = 0; offsets_.size() < descriptorCount; offset += data_[offset]) {
+        uint32_t index = static_cast<uint32_t>(offsets_.size());
+        offsets_.push_back(static_cast<uint32_t>(offset));
+        if (IsInterfaceAt(offset)) {
+            if (current != nullptr) {
+                current->end = index;
+            }
+            uint8_t interfaceNumber =
+                reinterpret_cast<const UsbInterfaceDescriptor *>(data_ + offset)->bInterfaceNumber;
+            uint8_t &count = filled[interfaceNumber];
+            // alternate settings beyond the count limit are left out
+            current = count < altSettingCount_[interfaceNumber] ?
+                &altSettings_[firstAltSetting_[interfaceNumber] + count++] : nullptr;
+            if (current != nullptr) {
+                current->first = index;
+            }
+        } else if (data_[offset + 1] == USB_DDK_DT_ENDPOINT && data_[offset] >= USB_DDK_DT_ENDPOINT_SIZE &&
+            current != nullptr) {
+            auto desc = reinterpret_cast<const UsbEndpointDescriptor *>(data_ + offset);
+            uint16_t &slot = current->endpoints[EndpointSlot(desc->bEndpointAddress)];
+            if (slot == 0) {
+                slot = static_cast<uint16_t>(index + 1);
+            }
+        }
+    }
+    if (current != nullptr) {
+        current->end = static_cast<uint32_t>(offsets_.size());
+    }
+}
+
+const UsbDdkDescriptorView::AltSetting *UsbDdkDescriptorView::FindAltSetting(
+    uint8_t interfaceNumber, uint8_t alternateSetting) const
+{
+    uint8_t count = altSettingCount_[interfaceNumber];
+    if (count == 0) {
+        return nullptr;
+    }
+    uint16_t first = firstAltSetting_[interfaceNumber];
+    // alternate settings are normally numbered in the order they appear, which makes this a direct hit
+    auto matches = [this](const AltSetting &altSetting, uint8_t value) {
+        return reinterpret_cast<const UsbInterfaceDescriptor *>(data_ + offsets_[altSetting.first])
+                   ->bAlternateSetting == value;
+    };
+    if (alternateSetting < count && matches(altSettings_[first + alternateSetting], alternateSetting)) {
+        return &altSettings_[first + alternateSetting];
+    }
+    for (uint8_t i = 0; i < count; ++i) {
+        if (matches(altSettings_[first + i], alternateSetting)) {
+            return &altSettings_[first + i];
+        }
+    }
+    return nullptr;
+}
+
+const UsbInterfaceDescriptor *UsbDdkDescriptorView::GetInterface(
+    uint8_t interfaceNumber, uint8_t alternateSetting) const
+{
+    const AltSetting *altSetting = FindAltSetting(interfaceNumber, alternateSetting);
+    if (altSetting == nullptr) {
+        return nullptr;
+    }
+    return reinterpret_cast<const UsbInterfaceDescriptor *>(data_ + offsets_[altSetting->first]);
+}
+
+const UsbEndpointDescriptor *UsbDdkDescriptorView::GetEndpoint(
+    uint8_t interfaceNumber, uint8_t alternateSetting, uint8_t endpointAddress) const
+{
+    const AltSetting *altSetting = FindAltSetting(interfaceNumber, alternateSetting);
+    if (altSetting == nullptr) {
+        return nullptr;
+    }
+    uint16_t slot = altSetting->endpoints[EndpointSlot(endpointAddress)];
+    if (slot == 0) {
+        return nullptr;
+    }
+    return reinterpret_cast<const UsbEndpointDescriptor *>(data_ + offsets_[slot - 1]);
+}
+
+void UsbDdkDescriptorView::InitIterator(uint8_t descriptorType, UsbDescriptorIterator &iter) const
+{
+    iter.next = 0;
+    iter.end = static_cast<uint32_t>(offsets_.size());
+    iter.descriptorType = descriptorType;
+}
+
+bool UsbDdkDescriptorView::InitIterator(
+    uint8_t interfaceNumber, uint8_t alternateSetting, uint8_t descriptorType, UsbDescriptorIterator &iter) const
+{
+    const AltSetting *altSetting = FindAltSetting(interfaceNumber, alternateSetting);
+    if (altSetting == nullptr) {
+        return false;
+    }
+    iter.next = altSetting->first;
+    iter.end = altSetting->end;
+    iter.descriptorType = descriptorType;
+    return true;
+}
+
+const uint8_t *UsbDdkDescriptorView::Next(UsbDescriptorIterator &iter) const
+{
+    uint32_t end = std::min(iter.end, static_cast<uint32_t>(offsets_.size()));
+    while (iter.next < end) {
+        const uint8_t *desc = data_ + offsets_[iter.next++];
+        if (iter.descriptorType == ALL_DESCRIPTOR_TYPES || desc[1] == iter.descriptorType) {
+            return desc;
+        }
+    }
+    return nullptr;
+}
+
+int32_t UsbDdkDescriptorView::GetParsedInterface(uint8_t interfaceNumber, const UsbDdkInterface *&usbInterface) const
+{
+    std::lock_guard<std::mutex> lock(parsedMutex_);
+    auto it = parsedInterfaces_.find(interfaceNumber);
+    if (it != parsedInterfaces_.end()) {
+        usbInterface = it->second;
+        return EDM_OK;
+    }
+
+    if (altSettingCount_[interfaceNumber] == 0) {
+        usbInterface = nullptr;
+        return EDM_OK;
+    }
+    uint16_t first = firstAltSetting_[interfaceNumber];
+    std::vector<std::pair<uint32_t, uint32_t>> ranges;
+    for (uint16_t i = first; i < first + altSettingCount_[interfaceNumber]; ++i) {
+        const AltSetting &altSetting = altSettings_[i];
+        uint32_t begin = offsets_[altSetting.first];
+        uint32_t last = offsets_[altSetting.end - 1];
+        uint32_t end = altSetting.end < offsets_.size() ? offsets_[altSetting.end] : last + data_[last];
+        ranges.emplace_back(begin, end - begin);
+    }
+
+    UsbDdkInterface *parsed = nullptr;
+    int32_t ret = ParseUsbInterfaceDescriptor(data_, length_, ranges, &parsed);
+    if (ret != EDM_OK) {
+        EDM_LOGE(MODULE_USB_DDK, "parse interface %{public}u failed: %{public}d", interfaceNumber, ret);
+        return ret;
+    }
+    parsedInterfaces_.emplace(interfaceNumber, parsed);
+    usbInterface = parsed;
+    return EDM_OK;
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
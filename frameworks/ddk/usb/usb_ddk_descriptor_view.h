@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef USB_DDK_DESCRIPTOR_VIEW_H
+#define USB_DDK_DESCRIPTOR_VIEW_H
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "usb_ddk_types.h"
+namespace OHOS {
+namespace ExternalDeviceManager {
+// Read-only index over the raw bytes of a configuration descriptor. The index is built in one pass and refers to
+// the descriptors by offset, so lookups and iteration return pointers into the raw bytes and never allocate. The raw
+// bytes must outlive the view.
+class UsbDdkDescriptorView final {
+public:
+    static constexpr uint8_t ALL_DESCRIPTOR_TYPES = 0;
+
+    ~UsbDdkDescriptorView();
+    static int32_t Create(const uint8_t *data, size_t length, std::unique_ptr<UsbDdkDescriptorView> &view);
+
+    const UsbConfigDescriptor *GetConfig() const
+    {
+        return reinterpret_cast<const UsbConfigDescriptor *>(data_);
+    }
+    const UsbInterfaceDescriptor *GetInterface(uint8_t interfaceNumber, uint8_t alternateSetting) const;
+    const UsbEndpointDescriptor *GetEndpoint(
+        uint8_t interfaceNumber, uint8_t alternateSetting, uint8_t endpointAddress) const;
+    // Initializes an iterator over the descriptors of the whole configuration.
+    void InitIterator(uint8_t descriptorType, UsbDescriptorIterator &iter) const;
+    // Initializes an iterator over the descriptors of an alternate setting, from its interface descriptor up to the
+    // next interface descriptor. Returns false if the alternate setting does not exist.
+    bool InitIterator(
+        uint8_t interfaceNumber, uint8_t alternateSetting, uint8_t descriptorType, UsbDescriptorIterator &iter) const;
+    const uint8_t *Next(UsbDescriptorIterator &iter) const;
+    // Parses all alternate settings of an interface on first use, so drivers that use a few interfaces of a large
+    // composite device do not pay for the others. The interface is owned by the view, and is set to nullptr if it
+    // does not exist.
+    int32_t GetParsedInterface(uint8_t interfaceNumber, const UsbDdkInterface *&usbInterface) const;
+
+private:
+    static constexpr uint32_t ENDPOINT_SLOTS = 32;
+
+    struct AltSetting {
+        uint32_t first;
+        uint32_t end;
+        // descriptor index plus one of each endpoint by its slot, 0 if the endpoint does not exist. Descriptors are at
+        // least 2 bytes long in at most 65535 bytes, so the index fits in 16 bits.
+        std::array<uint16_t, ENDPOINT_SLOTS> endpoints;
+    };
+
+    UsbDdkDescriptorView(const uint8_t *data, size_t length) : data_(data), length_(length) {}
+    UsbDdkDescriptorView(const UsbDdkDescriptorView &) = delete;
+    UsbDdkDescriptorView &operator=(const UsbDdkDescriptorView &) = delete;
+    void Index();
+    bool IsValidAt(size_t offset) const;
+    bool IsInterfaceAt(size_t offset) const;
+    const AltSetting *FindAltSetting(uint8_t interfaceNumber, uint8_t alternateSetting) const;
+
+    const uint8_t *data_;
+    size_t length_;
+    // offset of every descriptor in the raw bytes
+    std::vector<uint32_t> offsets_;
+    // alternate settings grouped by interface number, in the order of the raw bytes inside a group
+    std::vector<AltSetting> altSettings_;
+    std::array<uint16_t, UINT8_MAX + 1> firstAltSetting_;
+    std::array<uint8_t, UINT8_MAX + 1> altSettingCount_ {};
+    mutable std::mutex parsedMutex_;
+    // interfaces parsed by GetParsedInterface by interface number
+    mutable std::unordered_map<uint8_t, UsbDdkInterface *> parsedInterfaces_;
+};
+} // namespace ExternalDeviceManager
+} // namespace OHOS
+#endif // USB_DDK_DESCRIPTOR_VIEW_H
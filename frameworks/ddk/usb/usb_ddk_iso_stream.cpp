@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "usb_ddk_iso_stream.h"
+
+#include <algorithm>
+#include <functional>
+#include <securec.h>
+
+#include "edm_errors.h"
+#include "hilog_wrapper.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+namespace {
+constexpr uint8_t USB_ENDPOINT_DIR_IN = 0x80;
+
+uint64_t AlignUp(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+} // namespace
+
+UsbDdkIsoStream::UsbDdkIsoStream(bool in, uint8_t *address, uint32_t dataOffset, const UsbIsoStreamParams &params)
+    : in_(in), address_(address), descriptors_(nullptr), dataOffset_(dataOffset), packetSize_(params.packetSize),
+      packetsPerTransfer_(params.packetsPerTransfer), transferCount_(params.transferCount)
+{
+}
+
+int32_t UsbDdkIsoStream::Create(const UsbRequestPipe &pipe, UsbDdkRequestQueue::TransferFunc transfer,
+    const UsbDeviceMemMap &devMmap, uint32_t serviceSize, uint32_t serviceOffset, const UsbIsoStreamParams &params,
+    std::unique_ptr<UsbDdkIsoStream> &stream)
+{
+    if (params.packetSize == 0 || params.packetsPerTransfer == 0 || params.transferCount == 0 ||
+        params.transferCount > UsbDdkRequestQueue::MAX_INFLIGHT_PER_ENDPOINT) {
+        EDM_LOGE(MODULE_USB_DDK, "invalid stream params");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    uint64_t packetCount = static_cast<uint64_t>(params.packetsPerTransfer) * params.transferCount;
+    uint64_t transferSize = static_cast<uint64_t>(params.packetSize) * params.packetsPerTransfer;
+    auto base = reinterpret_cast<uintptr_t>(devMmap.address);
+    uint64_t tableOffset = AlignUp(base + devMmap.offset, alignof(UsbIsoPacketDescriptor)) - base;
+    uint64_t dataOffset = AlignUp(tableOffset + packetCount * sizeof(UsbIsoPacketDescriptor), sizeof(uint64_t));
+    uint64_t end = dataOffset + transferSize * params.transferCount;
+    if (transferSize > UINT32_MAX || end > static_cast<uint64_t>(devMmap.offset) + devMmap.bufferLength ||
+        end > devMmap.size) {
+        EDM_LOGE(MODULE_USB_DDK, "memory map is too small for the stream");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    std::unique_ptr<UsbDdkIsoStream> isoStream(new UsbDdkIsoStream(
+        (pipe.endpoint & USB_ENDPOINT_DIR_IN) != 0, devMmap.address, static_cast<uint32_t>(dataOffset), params));
+    isoStream->descriptors_ = reinterpret_cast<UsbIsoPacketDescriptor *>(devMmap.address + tableOffset);
+    std::vector<UsbDeviceMemMap> slots;
+    slots.reserve(params.transferCount);
+    for (uint32_t i = 0; i < params.transferCount; ++i) {
+        // the slot offset is how the service addresses the first packet of the transfer
+        uint64_t offset = serviceOffset + (isoStream->GetPacketOffset(i, 0) - devMmap.offset);
+        slots.push_back({devMmap.address, serviceSize, static_cast<uint32_t>(offset),
+            static_cast<uint32_t>(transferSize), 0});
+        for (uint32_t j = 0; j < params.packetsPerTransfer; ++j) {
+            isoStream->descriptors_[i * params.packetsPerTransfer + j] = {
+                isoStream->GetPacketOffset(i, j), params.packetSize, 0, EDM_OK};
+        }
+    }
+    isoStream->stream_ = std::make_unique<UsbDdkStream>(pipe, std::move(transfer), slots);
+
+    // an IN stream keeps every transfer queued, an OUT stream waits for the driver to fill them
+    for (uint32_t i = 0; isoStream->in_ && i < params.transferCount; ++i) {
+        int32_t ret = isoStream->stream_->Submit(i, static_cast<uint32_t>(transferSize));
+        if (ret != EDM_OK) {
+            EDM_LOGE(MODULE_USB_DDK, "submit transfer %{public}u failed: %{public}d", i, ret);
+            return ret;
+        }
+    }
+    stream = std::move(isoStream);
+    return EDM_OK;
+}
+
+int32_t UsbDdkIsoStream::Acquire(uint32_t timeout, UsbIsoPacketDescriptor *&packets, uint32_t &packetCount)
+{
+    uint32_t index = 0;
+    int32_t status = EDM_OK;
+    uint32_t remain = 0;
+    int32_t ret = stream_->Acquire(timeout, index, status, remain);
+    if (ret != EDM_OK) {
+        return ret;
+    }
+
+    // the service reports one length per transfer, the packets were filled or sent in order
+    UsbIsoPacketDescriptor *transferPackets = descriptors_ + index * packetsPerTransfer_;
+    for (uint32_t i = 0; i < packetsPerTransfer_; ++i) {
+        UsbIsoPacketDescriptor &packet = transferPackets[i];
+        packet.offset = GetPacketOffset(index, i);
+        if (in_) {
+            packet.length = packetSize_;
+        }
+        packet.actualLength = std::min(packet.length, remain);
+        packet.status = status;
+        remain -= packet.actualLength;
+    }
+    packets = transferPackets;
+    packetCount = packetsPerTransfer_;
+    return EDM_OK;
+}
+
+int32_t UsbDdkIsoStream::Submit(UsbIsoPacketDescriptor *packets)
+{
+    std::less<const UsbIsoPacketDescriptor *> less;
+    if (packets == nullptr || less(packets, descriptors_) ||
+        !less(packets, descriptors_ + transferCount_ * packetsPerTransfer_) ||
+        (packets - descriptors_) % packetsPerTransfer_ != 0) {
+        EDM_LOGE(MODULE_USB_DDK, "packets do not belong to stream");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    auto index = static_cast<uint32_t>((packets - descriptors_) / packetsPerTransfer_);
+    if (in_) {
+        return stream_->Submit(index, packetSize_ * packetsPerTransfer_);
+    }
+
+    // short packets are moved together so that the transfer is contiguous
+    uint8_t *base = address_ + GetPacketOffset(index, 0);
+    uint32_t length = 0;
+    for (uint32_t i = 0; i < packetsPerTransfer_; ++i) {
+        uint32_t packetLength = packets[i].length;
+        if (packetLength > packetSize_) {
+            EDM_LOGE(MODULE_USB_DDK, "packet %{public}u is too long: %{public}u", i, packetLength);
+            return USB_DDK_INVALID_PARAMETER;
+        }
+        uint32_t packetOffset = i * packetSize_;
+        if (length != packetOffset && packetLength != 0 &&
+            memmove_s(base + length, packetOffset + packetSize_ - length, base + packetOffset, packetLength) != 0) {
+            EDM_LOGE(MODULE_USB_DDK, "move packet %{public}u failed", i);
+            return USB_DDK_MEMORY_ERROR;
+        }
+        length += packetLength;
+    }
+    return stream_->Submit(index, length);
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
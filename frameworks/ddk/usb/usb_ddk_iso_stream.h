@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef USB_DDK_ISO_STREAM_H
+#define USB_DDK_ISO_STREAM_H
+
+#include <memory>
+
+#include "usb_ddk_stream.h"
+#include "usb_ddk_types.h"
+namespace OHOS {
+namespace ExternalDeviceManager {
+// Isochronous stream laid out in a device memory map: a table of packet descriptors followed by the packet data.
+// The packets of one transfer are contiguous, so a whole transfer is sent to the service in one request.
+class UsbDdkIsoStream final {
+public:
+    // serviceSize and serviceOffset describe the memory map the way the DDK service addresses it.
+    static int32_t Create(const UsbRequestPipe &pipe, UsbDdkRequestQueue::TransferFunc transfer,
+        const UsbDeviceMemMap &devMmap, uint32_t serviceSize, uint32_t serviceOffset, const UsbIsoStreamParams &params,
+        std::unique_ptr<UsbDdkIsoStream> &stream);
+
+    int32_t Acquire(uint32_t timeout, UsbIsoPacketDescriptor *&packets, uint32_t &packetCount);
+    int32_t Submit(UsbIsoPacketDescriptor *packets);
+
+private:
+    UsbDdkIsoStream(bool in, uint8_t *address, uint32_t dataOffset, const UsbIsoStreamParams &params);
+    UsbDdkIsoStream(const UsbDdkIsoStream &) = delete;
+    UsbDdkIsoStream &operator=(const UsbDdkIsoStream &) = delete;
+
+    uint32_t GetPacketOffset(uint32_t transfer, uint32_t packet) const
+    {
+        return dataOffset_ + (transfer * packetsPerTransfer_ + packet) * packetSize_;
+    }
+
+    bool in_;
+    uint8_t *address_;
+    UsbIsoPacketDescriptor *descriptors_;
+    uint32_t dataOffset_;
+    uint32_t packetSize_;
+    uint32_t packetsPerTransfer_;
+    uint32_t transferCount_;
+    std::unique_ptr<UsbDdkStream> stream_;
+};
+} // namespace ExternalDeviceManager
+} // namespace OHOS
+#endif // USB_DDK_ISO_STREAM_H
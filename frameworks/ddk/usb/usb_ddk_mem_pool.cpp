@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "usb_ddk_mem_pool.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <iterator>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "edm_errors.h"
+#include "hilog_wrapper.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+std::shared_mutex UsbDdkMemMapPool::poolsMutex_;
+std::map<const UsbDeviceMemMap *, UsbDdkMemMapPool *, std::less<const UsbDeviceMemMap *>> UsbDdkMemMapPool::pools_;
+
+UsbDdkMemMapPool::UsbDdkMemMapPool(
+    uint64_t deviceId, uint8_t *base, size_t size, uint32_t sliceSize, uint32_t sliceCount)
+    : deviceId_(deviceId), base_(base), size_(size), sliceSize_(sliceSize)
+{
+    slices_.reserve(sliceCount);
+    freeSlices_.reserve(sliceCount);
+    sliceInUse_.assign(sliceCount, false);
+    for (uint32_t i = 0; i < sliceCount; ++i) {
+        slices_.push_back({base_ + static_cast<size_t>(i) * sliceSize_, sliceSize_, 0, sliceSize_, 0});
+    }
+    // hand out the lowest slices first
+    for (uint32_t i = sliceCount; i > 0; --i) {
+        freeSlices_.push_back(i - 1);
+    }
+}
+
+UsbDdkMemMapPool::~UsbDdkMemMapPool()
+{
+    {
+        std::unique_lock<std::shared_mutex> lock(poolsMutex_);
+        pools_.erase(slices_.data());
+    }
+    if (munmap(base_, size_) != 0) {
+        EDM_LOGE(MODULE_USB_DDK, "munmap failed, errno=%{public}d", errno);
+    }
+}
+
+int32_t UsbDdkMemMapPool::Create(uint64_t deviceId, int32_t fd, uint32_t sliceSize, uint32_t sliceCount,
+    bool prefault, std::unique_ptr<UsbDdkMemMapPool> &pool)
+{
+    if (sliceSize == 0 || sliceCount == 0 || sliceSize > UINT32_MAX - SLICE_ALIGNMENT) {
+        EDM_LOGE(MODULE_USB_DDK, "invalid slice size or count");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+    sliceSize = (sliceSize + SLICE_ALIGNMENT - 1) / SLICE_ALIGNMENT * SLICE_ALIGNMENT;
+    uint64_t size = static_cast<uint64_t>(sliceSize) * sliceCount;
+    if (size > UINT32_MAX) {
+        EDM_LOGE(MODULE_USB_DDK, "pool is too large, sliceSize=%{public}u, sliceCount=%{public}u", sliceSize,
+            sliceCount);
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(poolsMutex_);
+    // all mappings of a device share the same memory, so a second pool would alias the first one
+    for (const auto &item : pools_) {
+        if (item.second->deviceId_ == deviceId) {
+            EDM_LOGE(MODULE_USB_DDK, "device already has a memory map pool");
+            return USB_DDK_DEVICE_BUSY;
+        }
+    }
+
+    if (ftruncate(fd, size) != 0) {
+        EDM_LOGE(MODULE_USB_DDK, "ftruncate failed, errno=%{public}d", errno);
+        return USB_DDK_MEMORY_ERROR;
+    }
+    int32_t flags = MAP_SHARED | (prefault ? MAP_POPULATE : 0);
+    auto base = static_cast<uint8_t *>(mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, fd, 0));
+    if (base == MAP_FAILED) {
+        EDM_LOGE(MODULE_USB_DDK, "mmap failed, errno=%{public}d", errno);
+        return USB_DDK_MEMORY_ERROR;
+    }
+
+    pool.reset(new UsbDdkMemMapPool(deviceId, base, size, sliceSize, sliceCount));
+    pools_.emplace(pool->slices_.data(), pool.get());
+    return EDM_OK;
+}
+
+int32_t UsbDdkMemMapPool::Alloc(UsbDeviceMemMap *&devMmap)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (freeSlices_.empty()) {
+        ++misses_;
+        EDM_LOGE(MODULE_USB_DDK, "no free slice in pool");
+        return USB_DDK_MEMORY_ERROR;
+    }
+
+    uint32_t index = freeSlices_.back();
+    freeSlices_.pop_back();
+    sliceInUse_[index] = true;
+    ++hits_;
+    highWaterMark_ = std::max(highWaterMark_, static_cast<uint32_t>(slices_.size() - freeSlices_.size()));
+
+    devMmap = &slices_[index];
+    devMmap->offset = 0;
+    devMmap->bufferLength = sliceSize_;
+    devMmap->transferedLength = 0;
+    return EDM_OK;
+}
+
+void UsbDdkMemMapPool::Free(UsbDeviceMemMap *devMmap)
+{
+    if (!Contains(devMmap)) {
+        EDM_LOGE(MODULE_USB_DDK, "memory map does not belong to pool");
+        return;
+    }
+
+    uint32_t index = static_cast<uint32_t>(devMmap - slices_.data());
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!sliceInUse_[index]) {
+        EDM_LOGE(MODULE_USB_DDK, "slice %{public}u is freed repeatedly", index);
+        return;
+    }
+    sliceInUse_[index] = false;
+    freeSlices_.push_back(index);
+}
+
+void UsbDdkMemMapPool::GetStats(UsbDeviceMemMapPoolStats &stats)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats.sliceSize = sliceSize_;
+    stats.sliceCount = static_cast<uint32_t>(slices_.size());
+    stats.inUse = static_cast<uint32_t>(slices_.size() - freeSlices_.size());
+    stats.highWaterMark = highWaterMark_;
+    stats.hits = hits_;
+    stats.misses = misses_;
+}
+
+bool UsbDdkMemMapPool::Translate(const UsbDeviceMemMap &devMmap, uint32_t &size, uint32_t &offset)
+{
+    std::shared_lock<std::shared_mutex> lock(poolsMutex_);
+    // the last pool whose slices start at or before devMmap
+    auto iter = pools_.upper_bound(&devMmap);
+    if (iter == pools_.begin()) {
+        return false;
+    }
+    UsbDdkMemMapPool *pool = std::prev(iter)->second;
+    if (!pool->Contains(&devMmap)) {
+        return false;
+    }
+    size = static_cast<uint32_t>(pool->size_);
+    offset = static_cast<uint32_t>(devMmap.address - pool->base_) + devMmap.offset;
+    return true;
+}
+
+int32_t UsbDdkMemMapPool::ResizeDeviceMemory(uint64_t deviceId, int32_t fd, size_t size)
+{
+    // the lock keeps a pool from being created between the check and the resize
+    std::unique_lock<std::shared_mutex> lock(poolsMutex_);
+    for (const auto &item : pools_) {
+        if (item.second->deviceId_ == deviceId) {
+            EDM_LOGE(MODULE_USB_DDK, "device has a memory map pool");
+            return USB_DDK_DEVICE_BUSY;
+        }
+    }
+
+    if (ftruncate(fd, size) != 0) {
+        EDM_LOGE(MODULE_USB_DDK, "ftruncate failed, errno=%{public}d", errno);
+        return USB_DDK_MEMORY_ERROR;
+    }
+    return EDM_OK;
+}
+
+bool UsbDdkMemMapPool::Contains(const UsbDeviceMemMap *devMmap) const
+{
+    std::less<const UsbDeviceMemMap *> less;
+    return devMmap != nullptr && !less(devMmap, slices_.data()) && less(devMmap, slices_.data() + slices_.size());
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
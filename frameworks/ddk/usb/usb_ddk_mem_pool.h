@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef USB_DDK_MEM_POOL_H
+#define USB_DDK_MEM_POOL_H
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+#include "usb_ddk_types.h"
+namespace OHOS {
+namespace ExternalDeviceManager {
+// Hands out fixed-size slices of one shared memory mapping of a device. The DDK service addresses the mapping of a
+// device from its start, so every slice is described to the service by the size of the whole mapping and the offset
+// of the slice inside it.
+class UsbDdkMemMapPool final {
+public:
+    static constexpr uint32_t SLICE_ALIGNMENT = 1024;
+
+    ~UsbDdkMemMapPool();
+    static int32_t Create(uint64_t deviceId, int32_t fd, uint32_t sliceSize, uint32_t sliceCount, bool prefault,
+        std::unique_ptr<UsbDdkMemMapPool> &pool);
+
+    int32_t Alloc(UsbDeviceMemMap *&devMmap);
+    void Free(UsbDeviceMemMap *devMmap);
+    void GetStats(UsbDeviceMemMapPoolStats &stats);
+    // Translates a slice to the size and offset expected by the DDK service. Returns false if the memory map is not
+    // a slice of any pool.
+    static bool Translate(const UsbDeviceMemMap &devMmap, uint32_t &size, uint32_t &offset);
+    // Resizes the shared memory of a device for a memory map outside of any pool. Returns USB_DDK_DEVICE_BUSY while
+    // the device has a pool, whose mapping would no longer be backed by the memory.
+    static int32_t ResizeDeviceMemory(uint64_t deviceId, int32_t fd, size_t size);
+
+private:
+    UsbDdkMemMapPool(uint64_t deviceId, uint8_t *base, size_t size, uint32_t sliceSize, uint32_t sliceCount);
+    UsbDdkMemMapPool(const UsbDdkMemMapPool &) = delete;
+    UsbDdkMemMapPool &operator=(const UsbDdkMemMapPool &) = delete;
+    bool Contains(const UsbDeviceMemMap *devMmap) const;
+
+    // Pools by the start of their slice array, so that Translate finds the pool of a slice with one lookup. Every
+    // pipe request translates its slice, so they only take the lock shared.
+    static std::shared_mutex poolsMutex_;
+    static std::map<const UsbDeviceMemMap *, UsbDdkMemMapPool *, std::less<const UsbDeviceMemMap *>> pools_;
+
+    uint64_t deviceId_;
+    uint8_t *base_;
+    size_t size_;
+    uint32_t sliceSize_;
+    std::vector<UsbDeviceMemMap> slices_;
+    std::mutex mutex_;
+    std::vector<uint32_t> freeSlices_;
+    std::vector<bool> sliceInUse_;
+    uint32_t highWaterMark_ {0};
+    uint64_t hits_ {0};
+    uint64_t misses_ {0};
+};
+} // namespace ExternalDeviceManager
+} // namespace OHOS
+#endif // USB_DDK_MEM_POOL_H
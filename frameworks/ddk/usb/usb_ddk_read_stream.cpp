@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "usb_ddk_read_stream.h"
+
+#include "edm_errors.h"
+#include "hilog_wrapper.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+namespace {
+constexpr uint8_t USB_ENDPOINT_DIR_IN = 0x80;
+} // namespace
+
+int32_t UsbDdkReadStream::Create(const UsbRequestPipe &pipe, UsbDdkRequestQueue::TransferFunc transfer,
+    const UsbDeviceMemMap &devMmap, uint32_t serviceSize, uint32_t serviceOffset, uint32_t bufferCount,
+    std::unique_ptr<UsbDdkReadStream> &stream)
+{
+    if ((pipe.endpoint & USB_ENDPOINT_DIR_IN) == 0) {
+        EDM_LOGE(MODULE_USB_DDK, "endpoint 0x%{public}x is not an IN endpoint", pipe.endpoint);
+        return USB_DDK_INVALID_PARAMETER;
+    }
+    if (bufferCount == 0 || bufferCount > UsbDdkRequestQueue::MAX_INFLIGHT_PER_ENDPOINT ||
+        devMmap.bufferLength < bufferCount || devMmap.offset > devMmap.size ||
+        devMmap.bufferLength > devMmap.size - devMmap.offset) {
+        EDM_LOGE(MODULE_USB_DDK, "invalid buffer count %{public}u", bufferCount);
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    uint32_t bufferSize = devMmap.bufferLength / bufferCount;
+    std::unique_ptr<UsbDdkReadStream> readStream(new UsbDdkReadStream(devMmap.offset, bufferSize));
+    std::vector<UsbDeviceMemMap> slots;
+    slots.reserve(bufferCount);
+    for (uint32_t i = 0; i < bufferCount; ++i) {
+        slots.push_back({devMmap.address, serviceSize, serviceOffset + i * bufferSize, bufferSize, 0});
+    }
+    readStream->stream_ = std::make_unique<UsbDdkStream>(pipe, std::move(transfer), slots);
+
+    for (uint32_t i = 0; i < bufferCount; ++i) {
+        int32_t ret = readStream->stream_->Submit(i, bufferSize);
+        if (ret != EDM_OK) {
+            EDM_LOGE(MODULE_USB_DDK, "submit buffer %{public}u failed: %{public}d", i, ret);
+            return ret;
+        }
+    }
+    stream = std::move(readStream);
+    return EDM_OK;
+}
+
+int32_t UsbDdkReadStream::Acquire(uint32_t timeout, UsbStreamBuffer &buffer)
+{
+    uint32_t index = 0;
+    int32_t status = EDM_OK;
+    uint32_t transferedLength = 0;
+    int32_t ret = stream_->Acquire(timeout, index, status, transferedLength);
+    if (ret != EDM_OK) {
+        return ret;
+    }
+
+    buffer.index = index;
+    buffer.offset = dataOffset_ + index * bufferSize_;
+    buffer.transferedLength = transferedLength;
+    buffer.status = status;
+    return EDM_OK;
+}
+
+int32_t UsbDdkReadStream::Release(const UsbStreamBuffer &buffer)
+{
+    return stream_->Submit(buffer.index, bufferSize_);
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
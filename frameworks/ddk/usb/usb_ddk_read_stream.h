@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef USB_DDK_READ_STREAM_H
+#define USB_DDK_READ_STREAM_H
+
+#include <memory>
+
+#include "usb_ddk_stream.h"
+#include "usb_ddk_types.h"
+namespace OHOS {
+namespace ExternalDeviceManager {
+// Continuous read on a bulk or interrupt IN endpoint. The used buffer of a device memory map is divided into equal
+// buffers which stay queued on the endpoint, except the ones the driver is consuming.
+class UsbDdkReadStream final {
+public:
+    // serviceSize and serviceOffset describe the memory map the way the DDK service addresses it.
+    static int32_t Create(const UsbRequestPipe &pipe, UsbDdkRequestQueue::TransferFunc transfer,
+        const UsbDeviceMemMap &devMmap, uint32_t serviceSize, uint32_t serviceOffset, uint32_t bufferCount,
+        std::unique_ptr<UsbDdkReadStream> &stream);
+
+    int32_t Acquire(uint32_t timeout, UsbStreamBuffer &buffer);
+    int32_t Release(const UsbStreamBuffer &buffer);
+
+private:
+    UsbDdkReadStream(uint32_t dataOffset, uint32_t bufferSize) : dataOffset_(dataOffset), bufferSize_(bufferSize) {}
+    UsbDdkReadStream(const UsbDdkReadStream &) = delete;
+    UsbDdkReadStream &operator=(const UsbDdkReadStream &) = delete;
+
+    uint32_t dataOffset_;
+    uint32_t bufferSize_;
+    std::unique_ptr<UsbDdkStream> stream_;
+};
+} // namespace ExternalDeviceManager
+} // namespace OHOS
+#endif // USB_DDK_READ_STREAM_H
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "usb_ddk_request_queue.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "edm_errors.h"
+#include "hilog_wrapper.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+UsbDdkRequestQueue::~UsbDdkRequestQueue()
+{
+    Stop();
+}
+
+int32_t UsbDdkRequestQueue::Submit(const UsbRequestPipe &pipe, UsbDeviceMemMap *devMmap, uint64_t &requestId)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopped_) {
+        EDM_LOGE(MODULE_USB_DDK, "request queue is stopped");
+        return USB_DDK_INVALID_OPERATION;
+    }
+
+    EndpointKey key(pipe.interfaceHandle, pipe.endpoint);
+    uint32_t &inflight = inflight_[key];
+    if (inflight >= MAX_INFLIGHT_PER_ENDPOINT) {
+        EDM_LOGE(MODULE_USB_DDK, "too many requests on endpoint 0x%{public}x", pipe.endpoint);
+        return USB_DDK_DEVICE_BUSY;
+    }
+
+    ++inflight;
+    ++outstanding_;
+    requestId = nextRequestId_++;
+    pending_.push_back({requestId, pipe, devMmap});
+    // the first request of an endpoint is not left waiting for workers busy with other endpoints
+    if (idleWorkers_ < pending_.size() && (workers_.size() < MAX_WORKERS || inflight == 1)) {
+        workers_.emplace_back(&UsbDdkRequestQueue::WorkLoop, this);
+    }
+    submitCond_.notify_one();
+    return EDM_OK;
+}
+
+int32_t UsbDdkRequestQueue::Reap(
+    UsbPipeRequestCompletion *completions, uint32_t count, uint32_t timeout, uint32_t &reaped)
+{
+    reaped = 0;
+    if (completions == nullptr || count == 0) {
+        EDM_LOGE(MODULE_USB_DDK, "invalid param");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    // nothing has been submitted, waiting would always end in a timeout
+    if (completed_.empty() && outstanding_ == 0) {
+        return EDM_OK;
+    }
+
+    if (completed_.empty() && timeout != 0) {
+        bool ready = completeCond_.wait_for(lock, std::chrono::milliseconds(timeout),
+            [this] { return stopped_ || !completed_.empty(); });
+        if (!ready) {
+            return USB_DDK_TIMEOUT;
+        }
+    }
+
+    uint32_t num = static_cast<uint32_t>(std::min(static_cast<size_t>(count), completed_.size()));
+    std::copy_n(completed_.begin(), num, completions);
+    completed_.erase(completed_.begin(), completed_.begin() + num);
+    reaped = num;
+    return EDM_OK;
+}
+
+void UsbDdkRequestQueue::Stop()
+{
+    std::vector<std::thread> workers;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = true;
+        for (const Request &request : pending_) {
+            Complete(request, USB_DDK_INVALID_OPERATION, 0);
+        }
+        pending_.clear();
+        workers.swap(workers_);
+    }
+    submitCond_.notify_all();
+    completeCond_.notify_all();
+    for (auto &worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+bool UsbDdkRequestQueue::IsStopped()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stopped_;
+}
+
+void UsbDdkRequestQueue::WorkLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        ++idleWorkers_;
+        submitCond_.wait(lock, [this] { return stopped_ || !pending_.empty(); });
+        --idleWorkers_;
+        if (stopped_) {
+            return;
+        }
+
+        // requests of endpoints with nothing running go first, the others in order
+        auto iter = std::find_if(pending_.begin(), pending_.end(), [this](const Request &request) {
+            return running_.count(EndpointKey(request.pipe.interfaceHandle, request.pipe.endpoint)) == 0;
+        });
+        if (iter == pending_.end()) {
+            iter = pending_.begin();
+        }
+        Request request = *iter;
+        pending_.erase(iter);
+        EndpointKey key(request.pipe.interfaceHandle, request.pipe.endpoint);
+        ++running_[key];
+        lock.unlock();
+        int32_t ret = transfer_(request.pipe, *request.devMmap);
+        lock.lock();
+        auto running = running_.find(key);
+        if (running != running_.end() && --(running->second) == 0) {
+            running_.erase(running);
+        }
+        Complete(request, ret, request.devMmap->transferedLength);
+    }
+}
+
+void UsbDdkRequestQueue::Complete(const Request &request, int32_t status, uint32_t transferedLength)
+{
+    auto iter = inflight_.find(EndpointKey(request.pipe.interfaceHandle, request.pipe.endpoint));
+    if (iter != inflight_.end() && --(iter->second) == 0) {
+        inflight_.erase(iter);
+    }
+    --outstanding_;
+    completed_.push_back({request.requestId, request.devMmap, status, transferedLength});
+    completeCond_.notify_all();
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
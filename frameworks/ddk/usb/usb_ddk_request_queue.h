@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef USB_DDK_REQUEST_QUEUE_H
+#define USB_DDK_REQUEST_QUEUE_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "usb_ddk_types.h"
+namespace OHOS {
+namespace ExternalDeviceManager {
+// Executes pipe requests on a pool of worker threads so that a single driver thread can keep several transfers
+// outstanding. Each worker blocks in one synchronous transfer, so the number of workers bounds the requests in flight.
+// The workers are shared by all endpoints, but a request on an endpoint with nothing in flight gets a worker beyond
+// MAX_WORKERS when all of them are busy, so an endpoint keeping the shared workers busy cannot starve the others.
+class UsbDdkRequestQueue final {
+public:
+    using TransferFunc = std::function<int32_t(const UsbRequestPipe &pipe, UsbDeviceMemMap &devMmap)>;
+
+    static constexpr uint32_t MAX_INFLIGHT_PER_ENDPOINT = 32;
+    static constexpr uint32_t MAX_WORKERS = 32;
+
+    explicit UsbDdkRequestQueue(TransferFunc transfer) : transfer_(std::move(transfer)) {}
+    ~UsbDdkRequestQueue();
+
+    int32_t Submit(const UsbRequestPipe &pipe, UsbDeviceMemMap *devMmap, uint64_t &requestId);
+    int32_t Reap(UsbPipeRequestCompletion *completions, uint32_t count, uint32_t timeout, uint32_t &reaped);
+    // Stops the workers after their current transfer. Requests that have not been started complete with
+    // USB_DDK_INVALID_OPERATION, so every submitted request is reaped once.
+    void Stop();
+    bool IsStopped();
+
+private:
+    UsbDdkRequestQueue(const UsbDdkRequestQueue &) = delete;
+    UsbDdkRequestQueue &operator=(const UsbDdkRequestQueue &) = delete;
+
+    struct Request {
+        uint64_t requestId;
+        UsbRequestPipe pipe;
+        UsbDeviceMemMap *devMmap;
+    };
+    using EndpointKey = std::pair<uint64_t, uint8_t>;
+
+    void WorkLoop();
+    void Complete(const Request &request, int32_t status, uint32_t transferedLength);
+
+    TransferFunc transfer_;
+    std::mutex mutex_;
+    std::condition_variable submitCond_;
+    std::condition_variable completeCond_;
+    std::deque<Request> pending_;
+    std::deque<UsbPipeRequestCompletion> completed_;
+    std::map<EndpointKey, uint32_t> inflight_;
+    // requests being transferred per endpoint, a subset of inflight_
+    std::map<EndpointKey, uint32_t> running_;
+    std::vector<std::thread> workers_;
+    uint32_t idleWorkers_ {0};
+    uint32_t outstanding_ {0};
+    uint64_t nextRequestId_ {1};
+    bool stopped_ {false};
+};
+} // namespace ExternalDeviceManager
+} // namespace OHOS
+#endif // USB_DDK_REQUEST_QUEUE_H
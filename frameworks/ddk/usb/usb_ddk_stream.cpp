@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "usb_ddk_stream.h"
+
+#include <chrono>
+
+#include "edm_errors.h"
+#include "hilog_wrapper.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+UsbDdkStream::UsbDdkStream(
+    const UsbRequestPipe &pipe, UsbDdkRequestQueue::TransferFunc transfer, const std::vector<UsbDeviceMemMap> &slots)
+    : pipe_(pipe), queue_(std::move(transfer)), slots_(slots), states_(slots.size(), SlotState::READY),
+      status_(slots.size(), EDM_OK), completions_(slots.size())
+{
+}
+
+UsbDdkStream::~UsbDdkStream()
+{
+    Stop();
+}
+
+int32_t UsbDdkStream::Submit(uint32_t index, uint32_t length)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (index >= slots_.size() || states_[index] == SlotState::SUBMITTED) {
+        EDM_LOGE(MODULE_USB_DDK, "slot %{public}u is not held by driver", index);
+        return USB_DDK_INVALID_PARAMETER;
+    }
+    UsbDeviceMemMap &slot = slots_[index];
+    if (length > slot.size - slot.offset) {
+        EDM_LOGE(MODULE_USB_DDK, "length %{public}u exceeds slot", length);
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    slot.bufferLength = length;
+    slot.transferedLength = 0;
+    uint64_t requestId = 0;
+    int32_t ret = queue_.Submit(pipe_, &slot, requestId);
+    if (ret != EDM_OK) {
+        return ret;
+    }
+    states_[index] = SlotState::SUBMITTED;
+    return EDM_OK;
+}
+
+int32_t UsbDdkStream::Acquire(uint32_t timeout, uint32_t &index, int32_t &status, uint32_t &transferedLength)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (states_[cursor_] == SlotState::ACQUIRED) {
+                EDM_LOGE(MODULE_USB_DDK, "all slots are held by driver");
+                return USB_DDK_INVALID_OPERATION;
+            }
+            if (states_[cursor_] == SlotState::READY) {
+                index = cursor_;
+                status = status_[cursor_];
+                transferedLength = slots_[cursor_].transferedLength;
+                states_[cursor_] = SlotState::ACQUIRED;
+                cursor_ = (cursor_ + 1) % slots_.size();
+                return EDM_OK;
+            }
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        uint32_t remain = 0;
+        if (now < deadline) {
+            remain = static_cast<uint32_t>(
+                std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count());
+        } else if (timeout != 0) {
+            return USB_DDK_TIMEOUT;
+        }
+        int32_t ret = ReapCompletions(remain);
+        if (ret != EDM_OK) {
+            return ret;
+        }
+        if (timeout == 0) {
+            // polling: take the slot if it has just completed, otherwise report that nothing is ready
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (states_[cursor_] != SlotState::READY) {
+                return USB_DDK_TIMEOUT;
+            }
+        }
+    }
+}
+
+int32_t UsbDdkStream::ReapCompletions(uint32_t timeout)
+{
+    std::lock_guard<std::mutex> reapLock(reapMutex_);
+    uint32_t reaped = 0;
+    int32_t ret = queue_.Reap(completions_.data(), completions_.size(), timeout, reaped);
+    if (ret != EDM_OK) {
+        return ret;
+    }
+    if (reaped == 0 && timeout != 0) {
+        EDM_LOGE(MODULE_USB_DDK, "stream is stopped");
+        return USB_DDK_INVALID_OPERATION;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (uint32_t i = 0; i < reaped; ++i) {
+        auto index = static_cast<uint32_t>(completions_[i].devMmap - slots_.data());
+        status_[index] = completions_[i].status;
+        states_[index] = SlotState::READY;
+    }
+    return EDM_OK;
+}
+
+void UsbDdkStream::Stop()
+{
+    queue_.Stop();
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef USB_DDK_STREAM_H
+#define USB_DDK_STREAM_H
+
+#include <mutex>
+#include <vector>
+
+#include "usb_ddk_request_queue.h"
+#include "usb_ddk_types.h"
+namespace OHOS {
+namespace ExternalDeviceManager {
+// A ring of transfer slots on one pipe. Slots are handed to the driver in ring order by Acquire and given back to
+// the device by Submit, so the driver can keep every slot it does not hold queued on the endpoint. The slots are
+// executed by a request queue owned by the stream, so their completions never mix with other requests.
+class UsbDdkStream final {
+public:
+    UsbDdkStream(const UsbRequestPipe &pipe, UsbDdkRequestQueue::TransferFunc transfer,
+        const std::vector<UsbDeviceMemMap> &slots);
+    ~UsbDdkStream();
+
+    // Queues a slot that is held by the driver with the given number of bytes to transfer.
+    int32_t Submit(uint32_t index, uint32_t length);
+    // Waits until the next slot in ring order is completed and hands it to the driver.
+    int32_t Acquire(uint32_t timeout, uint32_t &index, int32_t &status, uint32_t &transferedLength);
+    void Stop();
+
+    uint32_t GetSlotCount() const
+    {
+        return static_cast<uint32_t>(slots_.size());
+    }
+
+private:
+    UsbDdkStream(const UsbDdkStream &) = delete;
+    UsbDdkStream &operator=(const UsbDdkStream &) = delete;
+
+    enum class SlotState {
+        READY,
+        SUBMITTED,
+        ACQUIRED,
+    };
+
+    int32_t ReapCompletions(uint32_t timeout);
+
+    UsbRequestPipe pipe_;
+    UsbDdkRequestQueue queue_;
+    std::mutex mutex_;
+    std::vector<UsbDeviceMemMap> slots_;
+    std::vector<SlotState> states_;
+    std::vector<int32_t> status_;
+    uint32_t cursor_ {0};
+    std::mutex reapMutex_;
+    std::vector<UsbPipeRequestCompletion> completions_;
+};
+} // namespace ExternalDeviceManager
+} // namespace OHOS
+#endif // USB_DDK_STREAM_H
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "usb_ddk_transfer_plan.h"
+
+#include <algorithm>
+
+#include "edm_errors.h"
+#include "hilog_wrapper.h"
+#include "usb_ddk_descriptor_traits.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+constexpr uint8_t TRANSFER_TYPE_MASK = 0x03;
+constexpr uint8_t TRANSFER_TYPE_CONTROL = 0x00;
+constexpr uint8_t TRANSFER_TYPE_ISOCHRONOUS = 0x01;
+constexpr uint8_t TRANSFER_TYPE_BULK = 0x02;
+constexpr uint8_t TRANSFER_TYPE_INTERRUPT = 0x03;
+constexpr uint16_t MAX_PACKET_SIZE_MASK = 0x07ff;
+constexpr uint16_t ADDITIONAL_TRANSACTIONS_SHIFT = 11;
+constexpr uint16_t ADDITIONAL_TRANSACTIONS_MASK = 0x03;
+constexpr uint8_t MAX_ADDITIONAL_TRANSACTIONS = 2;
+constexpr uint8_t ISO_MULT_MASK = 0x03;
+constexpr uint8_t MAX_ISO_MULT = 2;
+constexpr uint8_t MAX_BURST = 15;
+constexpr uint8_t MAX_INTERVAL_EXPONENT = 16;
+constexpr uint32_t FRAME_US = 1000;
+constexpr uint32_t MICROFRAME_US = 125;
+constexpr uint64_t US_PER_SECOND = 1000000;
+// payload of the bus when one bulk endpoint has it to itself
+constexpr uint64_t FULL_SPEED_BULK_BYTES_PER_SECOND = 1216000;
+constexpr uint64_t HIGH_SPEED_BULK_BYTES_PER_SECOND = 53248000;
+constexpr uint64_t SUPER_SPEED_BULK_BYTES_PER_SECOND = 400000000;
+constexpr uint64_t SUPER_SPEED_PLUS_BULK_BYTES_PER_SECOND = 1200000000;
+constexpr uint32_t TARGET_TRANSFER_US = 1000;
+constexpr uint32_t TARGET_QUEUE_US = 8000;
+constexpr uint32_t MAX_TRANSFER_SIZE = 256 * 1024;
+constexpr uint32_t MIN_TRANSFER_COUNT = 2;
+// the most buffers a read stream or an isochronous stream takes
+constexpr uint32_t MAX_TRANSFER_COUNT = 32;
+
+static bool IsSuperSpeed(UsbDdkSpeed speed)
+{
+    return speed == USB_DDK_SPEED_SUPER || speed == USB_DDK_SPEED_SUPER_PLUS;
+}
+
+// The companion descriptor follows the endpoint descriptor, so it is the first of the extra descriptors.
+static bool FindSsEndpointCompanion(const UsbDdkEndpointDescriptor &endpoint, UsbSsEndpointCompanionDescriptor &desc)
+{
+    const uint8_t *extra = endpoint.extra;
+    uint32_t remaining = extra == nullptr ? 0 : endpoint.extraLength;
+    while (remaining >= UsbDescriptorTraits<UsbSsEndpointCompanionDescriptor>::MIN_LENGTH) {
+        if (IsValidDescriptor<UsbSsEndpointCompanionDescriptor>(extra, remaining)) {
+            DecodeDescriptor(extra, desc);
+            return true;
+        }
+        if (extra[0] < sizeof(uint16_t) || extra[0] > remaining) {
+            break;
+        }
+        remaining -= extra[0];
+        extra += extra[0];
+    }
+    return false;
+}
+
+static uint32_t GetIntervalUs(uint8_t transferType, uint8_t bInterval, UsbDdkSpeed speed)
+{
+    if (transferType == TRANSFER_TYPE_BULK) {
+        return 0;
+    }
+    // interrupt endpoints of low and full speed devices give the interval in frames, all other periodic endpoints as
+    // the exponent of a power of two
+    if (transferType == TRANSFER_TYPE_INTERRUPT && speed <= USB_DDK_SPEED_FULL) {
+        return std::max<uint32_t>(bInterval, 1) * FRAME_US;
+    }
+    uint32_t exponent = std::clamp<uint32_t>(bInterval, 1, MAX_INTERVAL_EXPONENT) - 1;
+    return (speed <= USB_DDK_SPEED_FULL ? FRAME_US : MICROFRAME_US) << exponent;
+}
+
+static uint64_t GetBulkBytesPerSecond(UsbDdkSpeed speed)
+{
+    switch (speed) {
+        case USB_DDK_SPEED_FULL:
+            return FULL_SPEED_BULK_BYTES_PER_SECOND;
+        case USB_DDK_SPEED_HIGH:
+            return HIGH_SPEED_BULK_BYTES_PER_SECOND;
+        case USB_DDK_SPEED_SUPER:
+            return SUPER_SPEED_BULK_BYTES_PER_SECOND;
+        default:
+            return SUPER_SPEED_PLUS_BULK_BYTES_PER_SECOND;
+    }
+}
+
+int32_t GetUsbEndpointTransferPlan(
+    const UsbDdkEndpointDescriptor &endpoint, UsbDdkSpeed speed, UsbEndpointTransferPlan &plan)
+{
+    const UsbEndpointDescriptor &desc = endpoint.endpointDescriptor;
+    uint8_t transferType = desc.bmAttributes & TRANSFER_TYPE_MASK;
+    uint32_t packetSize = desc.wMaxPacketSize & MAX_PACKET_SIZE_MASK;
+    if (speed < USB_DDK_SPEED_LOW || speed > USB_DDK_SPEED_SUPER_PLUS || transferType == TRANSFER_TYPE_CONTROL ||
+        packetSize == 0 || (speed == USB_DDK_SPEED_LOW && transferType != TRANSFER_TYPE_INTERRUPT)) {
+        EDM_LOGE(MODULE_USB_DDK, "unsupported endpoint 0x%{public}x, speed = %{public}d", desc.bEndpointAddress,
+            speed);
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    uint32_t packetsPerInterval = 1;
+    uint32_t bytesPerInterval = 0;
+    UsbSsEndpointCompanionDescriptor companion = {};
+    if (IsSuperSpeed(speed) && FindSsEndpointCompanion(endpoint, companion)) {
+        packetsPerInterval = std::min<uint32_t>(companion.bMaxBurst, MAX_BURST) + 1;
+        if (transferType == TRANSFER_TYPE_ISOCHRONOUS) {
+            packetsPerInterval *= std::min<uint32_t>(companion.bmAttributes & ISO_MULT_MASK, MAX_ISO_MULT) + 1;
+        }
+        bytesPerInterval = companion.wBytesPerInterval;
+    } else if (speed == USB_DDK_SPEED_HIGH && transferType != TRANSFER_TYPE_BULK) {
+        packetsPerInterval += std::min<uint32_t>(
+            (desc.wMaxPacketSize >> ADDITIONAL_TRANSACTIONS_SHIFT) & ADDITIONAL_TRANSACTIONS_MASK,
+            MAX_ADDITIONAL_TRANSACTIONS);
+    }
+    uint32_t maxBytesPerInterval = packetSize * packetsPerInterval;
+    if (bytesPerInterval == 0 || bytesPerInterval > maxBytesPerInterval) {
+        bytesPerInterval = maxBytesPerInterval;
+    }
+
+    plan.transferType = transferType;
+    plan.packetSize = packetSize;
+    plan.packetsPerInterval = packetsPerInterval;
+    plan.intervalUs = GetIntervalUs(transferType, desc.bInterval, speed);
+    uint64_t transferBytes = 0;
+    if (plan.intervalUs == 0) {
+        plan.maxBytesPerSecond = GetBulkBytesPerSecond(speed);
+        // fill the bus for TARGET_TRANSFER_US, in whole packets
+        transferBytes = std::clamp<uint64_t>(plan.maxBytesPerSecond * TARGET_TRANSFER_US / US_PER_SECOND,
+            packetSize, MAX_TRANSFER_SIZE) / packetSize * packetSize;
+    } else {
+        plan.maxBytesPerSecond = static_cast<uint64_t>(bytesPerInterval) * US_PER_SECOND / plan.intervalUs;
+        // whole service intervals, so that a transfer of a slow endpoint is one interval
+        uint64_t intervals = std::clamp<uint64_t>(TARGET_TRANSFER_US / plan.intervalUs, 1,
+            std::max<uint64_t>(MAX_TRANSFER_SIZE / maxBytesPerInterval, 1));
+        transferBytes = intervals * maxBytesPerInterval;
+    }
+    plan.transferSize = static_cast<uint32_t>(transferBytes);
+
+    // transfers in flight cover TARGET_QUEUE_US at full throughput
+    uint64_t transferUs = std::max<uint64_t>(transferBytes * US_PER_SECOND / plan.maxBytesPerSecond, 1);
+    plan.transferCount = static_cast<uint32_t>(std::clamp<uint64_t>(
+        (TARGET_QUEUE_US + transferUs - 1) / transferUs, MIN_TRANSFER_COUNT, MAX_TRANSFER_COUNT));
+    return EDM_OK;
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef USB_DDK_TRANSFER_PLAN_H
+#define USB_DDK_TRANSFER_PLAN_H
+
+#include <cstdint>
+
+#include "usb_ddk_types.h"
+namespace OHOS {
+namespace ExternalDeviceManager {
+// Derives the throughput of an endpoint from its descriptors and sizes transfers to keep it busy: one transfer holds
+// about TARGET_TRANSFER_US of data, and enough transfers are queued to cover TARGET_QUEUE_US.
+int32_t GetUsbEndpointTransferPlan(
+    const UsbDdkEndpointDescriptor &endpoint, UsbDdkSpeed speed, UsbEndpointTransferPlan &plan);
+} // namespace ExternalDeviceManager
+} // namespace OHOS
+#endif // USB_DDK_TRANSFER_PLAN_H
@@ -0,0 +1,312 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "usb_ddk_transfer_ring.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <new>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "edm_errors.h"
+#include "hilog_wrapper.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+namespace {
+constexpr size_t CACHE_LINE_SIZE = 64;
+constexpr uint32_t RING_FLAG_NEED_WAKEUP = 1;
+constexpr uint32_t COMPLETION_RING_SCALE = 2;
+constexpr uint32_t REAP_TIMEOUT = 1000;
+} // namespace
+
+// Every index is on its own cache line so that the driver and the worker threads do not share lines they write.
+struct UsbDdkTransferRing::RingHeader {
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> sqHead;
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> sqTail;
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> cqHead;
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> cqTail;
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> flags;
+};
+
+UsbDdkTransferRing::UsbDdkTransferRing(UsbDdkRequestQueue::TransferFunc transfer, const UsbDeviceMemMap &devMmap,
+    uint32_t serviceSize, uint32_t serviceBase, uint32_t entries)
+    : queue_(std::move(transfer)), mapSize_(devMmap.size), serviceSize_(serviceSize), serviceBase_(serviceBase),
+      entries_(entries), slotUserData_(entries), slotEndpoints_(entries)
+{
+    slots_.reserve(entries);
+    freeSlots_.reserve(entries);
+    for (uint32_t i = 0; i < entries; ++i) {
+        slots_.push_back({devMmap.address, serviceSize, 0, 0, 0});
+        freeSlots_.push_back(entries - i - 1);
+    }
+}
+
+UsbDdkTransferRing::~UsbDdkTransferRing()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = true;
+    }
+    WakeSubmitter();
+    if (submitter_.joinable()) {
+        submitter_.join();
+    }
+    queue_.Stop();
+    inflightCond_.notify_all();
+    if (completer_.joinable()) {
+        completer_.join();
+    }
+    if (header_ != nullptr) {
+        header_->~RingHeader();
+    }
+    if (eventFd_ >= 0) {
+        close(eventFd_);
+    }
+    if (wakeFd_ >= 0) {
+        close(wakeFd_);
+    }
+}
+
+int32_t UsbDdkTransferRing::Create(UsbDdkRequestQueue::TransferFunc transfer, const UsbDeviceMemMap &devMmap,
+    uint32_t serviceSize, uint32_t serviceOffset, uint32_t entries, std::unique_ptr<UsbDdkTransferRing> &ring)
+{
+    if (entries == 0 || entries > MAX_ENTRIES || (entries & (entries - 1)) != 0) {
+        EDM_LOGE(MODULE_USB_DDK, "entries must be a power of 2 not larger than %{public}u", MAX_ENTRIES);
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    auto base = reinterpret_cast<uintptr_t>(devMmap.address);
+    uint64_t headerOffset = (base + devMmap.offset + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE - base;
+    uint64_t sqOffset = headerOffset + sizeof(RingHeader);
+    uint64_t cqOffset = sqOffset + static_cast<uint64_t>(entries) * sizeof(UsbRingSubmission);
+    uint64_t end = cqOffset + static_cast<uint64_t>(entries) * COMPLETION_RING_SCALE * sizeof(UsbRingCompletion);
+    if (end > static_cast<uint64_t>(devMmap.offset) + devMmap.bufferLength || end > devMmap.size) {
+        EDM_LOGE(MODULE_USB_DDK, "memory map is too small for the rings");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
+    std::unique_ptr<UsbDdkTransferRing> transferRing(
+        new UsbDdkTransferRing(std::move(transfer), devMmap, serviceSize, serviceOffset - devMmap.offset, entries));
+    transferRing->ringBegin_ = headerOffset;
+    transferRing->ringEnd_ = end;
+    transferRing->eventFd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    transferRing->wakeFd_ = eventfd(0, EFD_CLOEXEC);
+    if (transferRing->eventFd_ < 0 || transferRing->wakeFd_ < 0) {
+        EDM_LOGE(MODULE_USB_DDK, "create eventfd failed, errno=%{public}d", errno);
+        return USB_DDK_FAILED;
+    }
+
+    RingHeader *header = new (devMmap.address + headerOffset) RingHeader();
+    header->sqHead.store(0, std::memory_order_relaxed);
+    header->sqTail.store(0, std::memory_order_relaxed);
+    header->cqHead.store(0, std::memory_order_relaxed);
+    header->cqTail.store(0, std::memory_order_relaxed);
+    header->flags.store(0, std::memory_order_relaxed);
+    transferRing->header_ = header;
+    transferRing->submissions_ = reinterpret_cast<UsbRingSubmission *>(devMmap.address + sqOffset);
+    transferRing->completions_ = reinterpret_cast<UsbRingCompletion *>(devMmap.address + cqOffset);
+    transferRing->submitter_ = std::thread(&UsbDdkTransferRing::SubmitLoop, transferRing.get());
+    transferRing->completer_ = std::thread(&UsbDdkTransferRing::CompleteLoop, transferRing.get());
+    ring = std::move(transferRing);
+    return EDM_OK;
+}
+
+int32_t UsbDdkTransferRing::GetSubmission(UsbRingSubmission *&submission)
+{
+    if (localSqTail_ - header_->sqHead.load(std::memory_order_acquire) >= entries_) {
+        return USB_DDK_DEVICE_BUSY;
+    }
+    submission = &submissions_[localSqTail_ & (entries_ - 1)];
+    ++localSqTail_;
+    return EDM_OK;
+}
+
+void UsbDdkTransferRing::Submit()
+{
+    header_->sqTail.store(localSqTail_, std::memory_order_seq_cst);
+    if ((header_->flags.load(std::memory_order_seq_cst) & RING_FLAG_NEED_WAKEUP) != 0) {
+        WakeSubmitter();
+    }
+}
+
+void UsbDdkTransferRing::PeekCompletion(UsbRingCompletion *&completion)
+{
+    uint32_t head = header_->cqHead.load(std::memory_order_relaxed);
+    if (head == header_->cqTail.load(std::memory_order_acquire)) {
+        completion = nullptr;
+        return;
+    }
+    completion = &completions_[head & (entries_ * COMPLETION_RING_SCALE - 1)];
+}
+
+void UsbDdkTransferRing::AdvanceCompletion(uint32_t count)
+{
+    uint32_t head = header_->cqHead.load(std::memory_order_relaxed);
+    uint32_t available = header_->cqTail.load(std::memory_order_acquire) - head;
+    header_->cqHead.store(head + std::min(count, available), std::memory_order_seq_cst);
+    // the submitter may be waiting for room in the completion ring
+    if ((header_->flags.load(std::memory_order_seq_cst) & RING_FLAG_NEED_WAKEUP) != 0) {
+        WakeSubmitter();
+    }
+}
+
+void UsbDdkTransferRing::WakeSubmitter()
+{
+    uint64_t value = 1;
+    if (write(wakeFd_, &value, sizeof(value)) != sizeof(value)) {
+        EDM_LOGE(MODULE_USB_DDK, "wake submitter failed, errno=%{public}d", errno);
+    }
+}
+
+// A submission is only taken when its completion is sure to find room in the completion ring. A completion leaves
+// inflight_ only after it has been posted, and inflight_ is read before the indexes, so the sum never falls short of
+// the completions owed to the ring.
+bool UsbDdkTransferRing::CanTakeSubmission()
+{
+    uint32_t inflight = inflight_.load();
+    uint32_t head = header_->cqHead.load();
+    uint32_t pending = header_->cqTail.load() - head;
+    uint32_t sqHead = header_->sqHead.load(std::memory_order_relaxed);
+    if (sqHead == header_->sqTail.load() || pending + inflight >= entries_ * COMPLETION_RING_SCALE ||
+        inflight >= entries_) {
+        return false;
+    }
+
+    // submissions are taken in order, so one for an endpoint at its limit holds back the submissions after it
+    const UsbRingSubmission &submission = submissions_[sqHead & (entries_ - 1)];
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = endpointInflight_.find(EndpointKey(submission.interfaceHandle, submission.endpoint));
+    return iter == endpointInflight_.end() || iter->second < UsbDdkRequestQueue::MAX_INFLIGHT_PER_ENDPOINT;
+}
+
+void UsbDdkTransferRing::ReleaseSlot(uint32_t index)
+{
+    auto iter = endpointInflight_.find(slotEndpoints_[index]);
+    if (iter != endpointInflight_.end() && --(iter->second) == 0) {
+        endpointInflight_.erase(iter);
+    }
+    freeSlots_.push_back(index);
+}
+
+void UsbDdkTransferRing::SubmitLoop()
+{
+    while (!stopped_) {
+        if (!CanTakeSubmission()) {
+            header_->flags.store(RING_FLAG_NEED_WAKEUP, std::memory_order_seq_cst);
+            if (!CanTakeSubmission() && !stopped_) {
+                uint64_t value = 0;
+                (void)read(wakeFd_, &value, sizeof(value));
+            }
+            header_->flags.store(0, std::memory_order_seq_cst);
+            continue;
+        }
+
+        uint32_t head = header_->sqHead.load(std::memory_order_relaxed);
+        UsbRingSubmission submission = submissions_[head & (entries_ - 1)];
+        header_->sqHead.store(head + 1, std::memory_order_release);
+        if (submission.offset > mapSize_ || submission.length > mapSize_ - submission.offset) {
+            EDM_LOGE(MODULE_USB_DDK, "submission is out of the memory map");
+            PostCompletion(submission.userData, USB_DDK_INVALID_PARAMETER, 0, false);
+            continue;
+        }
+        // an IN transfer into the rings would overwrite their indexes
+        if (submission.offset < ringEnd_ && static_cast<uint64_t>(submission.offset) + submission.length > ringBegin_) {
+            EDM_LOGE(MODULE_USB_DDK, "submission overlaps the rings");
+            PostCompletion(submission.userData, USB_DDK_INVALID_PARAMETER, 0, false);
+            continue;
+        }
+
+        uint32_t index = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            index = freeSlots_.back();
+            freeSlots_.pop_back();
+            slotUserData_[index] = submission.userData;
+            slotEndpoints_[index] = EndpointKey(submission.interfaceHandle, submission.endpoint);
+            ++endpointInflight_[slotEndpoints_[index]];
+            ++inflight_;
+        }
+        UsbDeviceMemMap &slot = slots_[index];
+        slot.offset = serviceBase_ + submission.offset;
+        slot.bufferLength = submission.length;
+        slot.transferedLength = 0;
+        UsbRequestPipe pipe = {submission.interfaceHandle, submission.timeout, submission.endpoint};
+        uint64_t requestId = 0;
+        int32_t ret = queue_.Submit(pipe, &slot, requestId);
+        if (ret != EDM_OK) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                ReleaseSlot(index);
+            }
+            PostCompletion(submission.userData, ret, 0, true);
+            continue;
+        }
+        inflightCond_.notify_one();
+    }
+}
+
+void UsbDdkTransferRing::CompleteLoop()
+{
+    std::vector<UsbPipeRequestCompletion> completions(entries_);
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            inflightCond_.wait(lock, [this] { return stopped_ || inflight_.load() > 0; });
+            if (stopped_) {
+                return;
+            }
+        }
+
+        uint32_t reaped = 0;
+        if (queue_.Reap(completions.data(), completions.size(), REAP_TIMEOUT, reaped) != EDM_OK) {
+            continue;
+        }
+        for (uint32_t i = 0; i < reaped; ++i) {
+            auto index = static_cast<uint32_t>(completions[i].devMmap - slots_.data());
+            uint64_t userData = 0;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                userData = slotUserData_[index];
+                ReleaseSlot(index);
+            }
+            PostCompletion(userData, completions[i].status, completions[i].transferedLength, true);
+        }
+    }
+}
+
+void UsbDdkTransferRing::PostCompletion(uint64_t userData, int32_t status, uint32_t transferedLength, bool inflight)
+{
+    // only the completer and, for rejected submissions, the submitter post, so the tail is updated under the lock
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint32_t tail = header_->cqTail.load(std::memory_order_relaxed);
+        completions_[tail & (entries_ * COMPLETION_RING_SCALE - 1)] = {userData, status, transferedLength};
+        header_->cqTail.store(tail + 1, std::memory_order_seq_cst);
+        // the completion is counted by the tail now, so it stops counting as in flight before the wakeup below
+        if (inflight) {
+            --inflight_;
+        }
+    }
+    uint64_t value = 1;
+    if (write(eventFd_, &value, sizeof(value)) != sizeof(value)) {
+        EDM_LOGE(MODULE_USB_DDK, "notify completion failed, errno=%{public}d", errno);
+    }
+    if ((header_->flags.load(std::memory_order_seq_cst) & RING_FLAG_NEED_WAKEUP) != 0) {
+        WakeSubmitter();
+    }
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef USB_DDK_TRANSFER_RING_H
+#define USB_DDK_TRANSFER_RING_H
+
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "usb_ddk_request_queue.h"
+#include "usb_ddk_types.h"
+namespace OHOS {
+namespace ExternalDeviceManager {
+// A submission ring and a completion ring placed in a device memory map. The driver is the only producer of the
+// submission ring and the only consumer of the completion ring, and it only touches shared memory and atomic
+// indexes. A submitter thread moves submissions to a private request queue and a completer thread posts their
+// results, so the driver needs a system call only to wake the submitter after it went idle.
+class UsbDdkTransferRing final {
+public:
+    static constexpr uint32_t MAX_ENTRIES = 4096;
+
+    // serviceSize and serviceOffset describe the memory map the way the DDK service addresses it.
+    static int32_t Create(UsbDdkRequestQueue::TransferFunc transfer, const UsbDeviceMemMap &devMmap,
+        uint32_t serviceSize, uint32_t serviceOffset, uint32_t entries, std::unique_ptr<UsbDdkTransferRing> &ring);
+    ~UsbDdkTransferRing();
+
+    // Called by the driver thread.
+    int32_t GetSubmission(UsbRingSubmission *&submission);
+    void Submit();
+    void PeekCompletion(UsbRingCompletion *&completion);
+    void AdvanceCompletion(uint32_t count);
+
+    int32_t GetEventFd() const
+    {
+        return eventFd_;
+    }
+
+private:
+    struct RingHeader;
+    using EndpointKey = std::pair<uint64_t, uint8_t>;
+
+    UsbDdkTransferRing(UsbDdkRequestQueue::TransferFunc transfer, const UsbDeviceMemMap &devMmap,
+        uint32_t serviceSize, uint32_t serviceBase, uint32_t entries);
+    UsbDdkTransferRing(const UsbDdkTransferRing &) = delete;
+    UsbDdkTransferRing &operator=(const UsbDdkTransferRing &) = delete;
+
+    void WakeSubmitter();
+    bool CanTakeSubmission();
+    // called with mutex_ held
+    void ReleaseSlot(uint32_t index);
+    void SubmitLoop();
+    void CompleteLoop();
+    // inflight tells whether the request had been counted in inflight_
+    void PostCompletion(uint64_t userData, int32_t status, uint32_t transferedLength, bool inflight);
+
+    UsbDdkRequestQueue queue_;
+    size_t mapSize_;
+    // the rings and their header, which the data buffers of the submissions must stay out of
+    uint64_t ringBegin_ {0};
+    uint64_t ringEnd_ {0};
+    uint32_t serviceSize_;
+    uint32_t serviceBase_;
+    uint32_t entries_;
+    RingHeader *header_ {nullptr};
+    UsbRingSubmission *submissions_ {nullptr};
+    UsbRingCompletion *completions_ {nullptr};
+    // only used by the driver thread
+    uint32_t localSqTail_ {0};
+    int32_t eventFd_ {-1};
+    int32_t wakeFd_ {-1};
+
+    std::mutex mutex_;
+    std::condition_variable inflightCond_;
+    std::vector<UsbDeviceMemMap> slots_;
+    std::vector<uint64_t> slotUserData_;
+    std::vector<EndpointKey> slotEndpoints_;
+    // requests in flight per endpoint, kept within what the request queue accepts for an endpoint
+    std::map<EndpointKey, uint32_t> endpointInflight_;
+    std::vector<uint32_t> freeSlots_;
+    std::atomic<uint32_t> inflight_ {0};
+    std::atomic<bool> stopped_ {false};
+    std::thread submitter_;
+    std::thread completer_;
+};
+} // namespace ExternalDeviceManager
+} // namespace OHOS
+#endif // USB_DDK_TRANSFER_RING_H
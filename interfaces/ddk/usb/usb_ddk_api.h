@@ -45,7 +45,9 @@ extern "C" {
 #endif /* __cplusplus */
 
 /**
- * @brief Initializes the DDK.
+ * @brief Initializes the DDK. The DDK is reference counted: it can be initialized by several modules of a driver,\n
+ * and it is released when <b>OH_Usb_Release</b> has been called as many times as this API. All other APIs are\n
+ * thread-safe and can be called concurrently from multiple threads.
  *
  * @return <b>0</b> if the operation is successful; a negative value otherwise.
  * @since 10
@@ -54,7 +56,7 @@ extern "C" {
 int32_t OH_Usb_Init(void);
 
 /**
- * @brief Releases the DDK.
+ * @brief Releases the DDK. The DDK is released only when it has been released as many times as it is initialized.
  *
  * @since 10
  * @version 1.0
@@ -74,7 +76,8 @@ int32_t OH_Usb_GetDeviceDescriptor(uint64_t deviceId, struct UsbDeviceDescriptor
 
 /**
  * @brief Obtains the configuration descriptor. To avoid memory leakage, use <b>OH_Usb_FreeConfigDescriptor</b>\n
- * to release a descriptor after use.
+ * to release a descriptor after use. Descriptors are cached while the device is attached, and the same descriptor\n
+ * may be returned to several callers, so it must not be modified.
  *
  * @param deviceId ID of the device whose configuration descriptor is to be obtained.
  * @param configIndex Configuration index, which corresponds to <b>bConfigurationValue</b> in the USB protocol.
@@ -97,6 +100,156 @@ int32_t OH_Usb_GetConfigDescriptor(
  */
 void OH_Usb_FreeConfigDescriptor(struct UsbDdkConfigDescriptor * const config);
 
+/**
+ * @brief Obtains all configuration descriptors of a device. They are parsed into one block of memory and indexed by\n
+ * configuration value, and they are cached and shared in the same way as the descriptors obtained by calling\n
+ * <b>OH_Usb_GetConfigDescriptor</b>, so they must not be modified. To avoid memory leakage, use\n
+ * <b>OH_Usb_FreeConfigDescriptorTable</b> to release the table after use.
+ *
+ * @param deviceId ID of the device whose configuration descriptors are to be obtained.
+ * @param table Table of the configuration descriptors.
+ * @return <b>0</b> if the operation is successful; a negative value otherwise.
+ * @since 11
+ * @version 1.0
+ */
+int32_t OH_Usb_GetConfigDescriptorTable(uint64_t deviceId, struct UsbDdkConfigDescriptorTable ** const table);
+
+/**
+ * @brief Releases a table of configuration descriptors.
+ *
+ * @param table Table obtained by calling <b>OH_Usb_GetConfigDescriptorTable</b>.
+ * @since 11
+ * @version 1.0
+ */
+void OH_Usb_FreeConfigDescriptorTable(struct UsbDdkConfigDescriptorTable * const table);
+
+/**
+ * @brief Sets the directory in which parsed configuration descriptors are kept as images. An image is written the\n
+ * first time a configuration of a device model is parsed, and later calls of <b>OH_Usb_GetConfigDescriptor</b> for\n
+ * devices of that model, also after a restart, map the image instead of loading and parsing the descriptors again.\n
+ * A device model is identified by the vendor ID, product ID and release number in the device descriptor, so images\n
+ * are used for a device only after <b>OH_Usb_GetDeviceDescriptor</b> has been called for it.
+ *
+ * @param directory Directory writable by the caller, or an empty string to stop using images.
+ * @return <b>0</b> if the operation is successful; a negative value otherwise.
+ * @since 11
+ * @version 1.0
+ */
+int32_t OH_Usb_SetDescriptorImageDirectory(const char *directory);
+
+/**
+ * @brief Obtains a read-only view of the configuration descriptor. The view is an index over the raw descriptors:\n
+ * interfaces and endpoints are looked up in constant time and descriptors are iterated without memory allocation.\n
+ * All descriptors returned through the view point into the raw descriptors, with multi-byte fields in USB byte\n
+ * order. To avoid memory leakage, use <b>OH_Usb_FreeConfigDescriptorView</b> to release a view after use.
+ *
+ * @param deviceId ID of the device whose configuration descriptor is to be obtained.
+ * @param configIndex Configuration index, which corresponds to <b>bConfigurationValue</b> in the USB protocol.
+ * @param view View of the configuration descriptor.
+ * @return <b>0</b> if the operation is successful; a negative value otherwise.
+ * @since 11
+ * @version 1.0
+ */
+int32_t OH_Usb_GetConfigDescriptorView(uint64_t deviceId, uint8_t configIndex, const UsbConfigDescriptorView **view);
+
+/**
+ * @brief Releases a view of the configuration descriptor.
+ *
+ * @param view View obtained by calling <b>OH_Usb_GetConfigDescriptorView</b>.
+ * @since 11
+ * @version 1.0
+ */
+void OH_Usb_FreeConfigDescriptorView(const UsbConfigDescriptorView *view);
+
+/**
+ * @brief Looks up an interface descriptor in a view.
+ *
+ * @param view View of the configuration descriptor.
+ * @param interfaceNumber Interface number, which corresponds to <b>bInterfaceNumber</b> in the USB protocol.
+ * @param alternateSetting Alternate setting, which corresponds to <b>bAlternateSetting</b> in the USB protocol.
+ * @param desc Interface descriptor. It is set to <b>NULL</b> if the alternate setting does not exist.
+ * @return <b>0</b> if the operation is successful; a negative value otherwise.
+ * @since 11
+ * @version 1.0
+ */
+int32_t OH_Usb_GetViewInterface(const UsbConfigDescriptorView *view, uint8_t interfaceNumber,
+    uint8_t alternateSetting, const struct UsbInterfaceDescriptor **desc);
+
+/**
+ * @brief Looks up an endpoint descriptor of an alternate setting in a view.
+ *
+ * @param view View of the configuration descriptor.
+ * @param interfaceNumber Interface number.
+ * @param alternateSetting Alternate setting of the interface.
+ * @param endpointAddress Endpoint address, including the direction bit.
+ * @param desc Endpoint descriptor. It is set to <b>NULL</b> if the endpoint does not exist.
+ * @return <b>0</b> if the operation is successful; a negative value otherwise.
+ * @since 11
+ * @version 1.0
+ */
+int32_t OH_Usb_GetViewEndpoint(const UsbConfigDescriptorView *view, uint8_t interfaceNumber,
+    uint8_t alternateSetting, uint8_t endpointAddress, const struct UsbEndpointDescriptor **desc);
+
+/**
+ * @brief Obtains an interface of a view as parsed structures, with all its alternate settings and endpoints.\n
+ * Only the requested interface is parsed, on the first call for it, so drivers that use a few interfaces of a\n
+ * composite device do not pay for the others. The interface is owned by the view and released with it.
+ *
+ * @param view View of the configuration descriptor.
+ * @param interfaceNumber Interface number.
+ * @param usbInterface Parsed interface. It is set to <b>NULL</b> if the interface does not exist.
+ * @return <b>0</b> if the operation is successful; a negative value otherwise.
+ * @since 11
+ * @version 1.0
+ */
+int32_t OH_Usb_GetViewParsedInterface(
+    const UsbConfigDescriptorView *view, uint8_t interfaceNumber, const struct UsbDdkInterface **usbInterface);
+
+/**
+ * @brief Initializes an iterator over all descriptors of a view, in the order of the raw descriptors.
+ *
+ * @param view View of the configuration descriptor.
+ * @param descriptorType Type of the descriptors to iterate, for example a class-specific type. The value <b>0</b>\n
+ * means all types.
+ * @param iter Iterator to initialize.
+ * @return <b>0</b> if the operation is successful; a negative value otherwise.
+ * @since 11
+ * @version 1.0
+ */
+int32_t OH_Usb_InitViewIterator(
+    const UsbConfigDescriptorView *view, uint8_t descriptorType, UsbDescriptorIterator *iter);
+
+/**
+ * @brief Initializes an iterator over the descriptors of an alternate setting, from its interface descriptor up to\n
+ * the next interface descriptor.
+ *
+ * @param view View of the configuration descriptor.
+ * @param interfaceNumber Interface number.
+ * @param alternateSetting Alternate setting of the interface.
+ * @param descriptorType Type of the descriptors to iterate. The value <b>0</b> means all types.
+ * @param iter Iterator to initialize.
+ * @return <b>0</b> if the operation is successful; <b>USB_DDK_INVALID_PARAMETER</b> if the alternate setting does\n
+ * not exist; a negative value otherwise.
+ * @since 11
+ * @version 1.0
+ */
+int32_t OH_Usb_InitViewInterfaceIterator(const UsbConfigDescriptorView *view, uint8_t interfaceNumber,
+    uint8_t alternateSetting, uint8_t descriptorType, UsbDescriptorIterator *iter);
+
+/**
+ * @brief Obtains the next descriptor of an iterator.
+ *
+ * @param view View of the configuration descriptor.
+ * @param iter Iterator initialized on the view.
+ * @param desc Raw descriptor, starting with <b>bLength</b> and <b>bDescriptorType</b>. It is set to <b>NULL</b>\n
+ * when the iteration is complete.
+ * @return <b>0</b> if the operation is successful; a negative value otherwise.
+ * @since 11
+ * @version 1.0
+ */
+int32_t OH_Usb_NextViewDescriptor(
+    const UsbConfigDescriptorView *view, UsbDescriptorIterator *iter, const uint8_t **desc);
+
 /**
  * @brief Claims a USB interface.
  *
@@ -174,6 +327,59 @@ int32_t OH_Usb_SendControlReadRequest(uint64_t interfaceHandle, const struct Usb
 int32_t OH_Usb_SendControlWriteRequest(uint64_t interfaceHandle, const struct UsbControlRequestSetup *setup,
     uint32_t timeout, const uint8_t *data, uint32_t dataLen);
 
+/**
+ * @brief Sends a batch of control transfer requests in order. This API works in a synchronous manner. The batch\n
+ * stops at the first transfer that fails, and the transfers after it are not sent and their status is set to\n
+ * <b>USB_DDK_INVALID_OPERATION</b>.
+ *
+ * @param interfaceHandle Interface operation handle.
+ * @param timeout Timeout duration of each transfer, in milliseconds.
+ * @param transfers Control transfers. The transferred length and the status of each transfer are returned in it.
+ * @param count Number of control transfers.
+ * @param completed Number of transfers that are completed successfully.
+ * @return <b>0</b> if all transfers are successful; the status of the failed transfer otherwise.
+ * @since 11
+ * @version 1.0
+ */
+int32_t OH_Usb_SendControlRequests(uint64_t interfaceHandle, uint32_t timeout, struct UsbControlTransfer *transfers,
+    uint32_t count, uint32_t *completed);
+
+/**
+ * @brief Sends a control read transfer request and reads the data into a device memory map. This API works in a\n
+ * synchronous manner. The data is still copied through a buffer kept by the calling thread, so the request\n
+ * costs the same as <b>OH_Usb_SendControlReadRequest</b>. It allows the data of control transfers to be kept\n
+ * in the same memory map as the data of pipe requests.
+ *
+ * @param interfaceHandle Interface operation handle.
+ * @param setup Request data, which corresponds to <b>Setup Data</b> in the USB protocol.
+ * @param timeout Timeout duration, in milliseconds.
+ * @param devMmap Device memory map. The data is read into the buffer starting at <b>offset</b>, and at most\n
+ * <b>bufferLength</b> bytes are read. The length of the actually read data is returned in <b>transferedLength</b>.
+ * @return <b>0</b> if the operation is successful; a negative value otherwise.
+ * @since 11
+ * @version 1.0
+ */
+int32_t OH_Usb_SendControlReadRequestWithMemMap(uint64_t interfaceHandle, const struct UsbControlRequestSetup *setup,
+    uint32_t timeout, UsbDeviceMemMap *devMmap);
+
+/**
+ * @brief Sends a control write transfer request with the data in a device memory map. This API works in a\n
+ * synchronous manner. The data is still copied through a buffer kept by the calling thread, so the request\n
+ * costs the same as <b>OH_Usb_SendControlWriteRequest</b>. It allows the data of control transfers to be kept\n
+ * in the same memory map as the data of pipe requests.
+ *
+ * @param interfaceHandle Interface operation handle.
+ * @param setup Request data, which corresponds to <b>Setup Data</b> in the USB protocol.
+ * @param timeout Timeout duration, in milliseconds.
+ * @param devMmap Device memory map. The <b>bufferLength</b> bytes starting at <b>offset</b> are written.\n
+ * The length of the actually written data is returned in <b>transferedLength</b>.
+ * @return <b>0</b> if the operation is successful; a negative value otherwise.
+ * @since 11
+ * @version 1.0
+ */
+int32_t OH_Usb_SendControlWriteRequestWithMemMap(uint64_t interfaceHandle, const struct UsbControlRequestSetup *setup,
+    uint32_t timeout, UsbDeviceMemMap *devMmap);
+
 /**
  * @brief Sends a pipe request. This API works in a synchronous manner. This API applies to interrupt transfer\n
  * and bulk transfer.
@@ -186,6 +392,255 @@ int32_t OH_Usb_SendControlWriteRequest(uint64_t interfaceHandle, const struct Us
  */
 int32_t OH_Usb_SendPipeRequest(const struct UsbRequestPipe *pipe, UsbDeviceMemMap *devMmap);
 
+/**
+ * @brief Sends a pipe request over several segments of one device memory map. This API works in a synchronous\n
+ * manner. This API applies to interrupt transfer and bulk transfer. Segments that are adjacent in the memory map\n
+ * are sent in one transfer, and the other segments are sent in order as a chain of transfers. For an OUT endpoint,\n
+ * make every segment that is not followed by an adjacent one a multiple of the maximum packet size of the endpoint\n
+ * if the device expects the chain as one transfer. The chain stops when a segment is not transferred completely.
+ *
+ * @param pipe Pipe used to transfer data.
+ * @param devMmap Device memory map, which can be obtained by calling <b>OH_Usb_CreateDeviceMemMap</b>.
+ * @param segments Segments of the memory map. The transferred length of each segment is returned in it.
+ * @param count Number of segments.
+ * @param transferedLength Total length of the transferred data.
+ * @return <b>0</b> if the operation is successful; a negative value otherwise.
+ * @since 11
+ * @version 1.0
+ */
+int32_t OH_Usb_SendPipeRequestVectored(const struct UsbRequestPipe *pipe, UsbDeviceMemMap *devMmap,
+    struct UsbMemMapSegment *segments, uint32_t count, uint32_t *transferedLength);
+
+/**
+ * @brief Submits a pipe request. This API works in an asynchronous manner and returns once the request is queued.\n
+ * This API applies to interrupt transfer and bulk transfer. Up to 32 requests can be outstanding on each endpoint.\n
+ * Use a separate device memory map for each outstanding request, and do not access the buffer until the request\n
+ * is reaped by calling <b>OH_Usb_ReapPipeRequests</b>.
+ *
+ * @param pipe Pipe used to transfer data.
+ * @param devMmap Device memory map, which can be obtained by calling <b>OH_Usb_CreateDeviceMemMap</b>.
+ * @param requestId Request ID, which is returned in the completion of the request.
+ * @return <b>0</b> if the operation is successful; a negative value otherwise.
+ * @since 11
+ * @version 1.0
+ */
+int32_t OH_Usb_SubmitPipeRequest(const struct UsbRequestPipe *pipe, UsbDeviceMemMap *devMmap, uint64_t *requestId);
+
+/**
+ * @brief Obtains the completions of pipe requests submitted by calling <b>OH_Usb_SubmitPipeRequest</b>.\n
+ * Requests may complete in an order different from the order in which they are submitted.
+ *
+ * @param completions Array used to return the completions.
+ * @param count Number of elements in the array.
+ * @param timeout Maximum time to wait for a completion, in milliseconds. The value <b>0</b> means that the API\n
+ * returns immediately.
+ * @param reaped Number of completions returned.
+ * @return <b>0</b> if the operation is successful; <b>USB_DDK_TIMEOUT</b> if no request completes within the\n
+ * timeout; a negative value otherwise.
+ * @since 11
+ * @version 1.0
+ */
+int32_t OH_Usb_ReapPipeRequests(
+    struct UsbPipeRequestCompletion *completions, uint32_t count, uint32_t timeout, uint32_t *reaped);
+
+/**
+ * @brief Creates a transfer ring. A transfer ring is a pair of a submission ring and a completion ring placed in the\n
+ * used buffer of a device memory map. The driver writes pipe requests into the submission ring and reads their\n
+ * results from the completion ring without locks, and the requests are executed in the background. The data\n
+ * buffers of the requests must be in the same memory map, outside the rings. Up to 32 requests of each endpoint\n
+ * are executed at a time, and the requests after one that would exceed the limit wait until a request of its\n
+ * endpoint completes. A ring must be used by one driver thread at a time. To avoid resource leakage, destroy a\n
+ * ring by calling <b>OH_Usb_DestroyTransferRing</b> after use.
+ *
+ * @param devMmap Device memory map, which must remain valid until the ring is destroyed.
+ * @param entries Number of entries of the submission ring, which must be a power of 2 not larger than 4096.\n
+ * The completion ring has twice as many entries.
+ * @param ring Transfer ring, through which the created ring is returned to the caller.
+ * @return <b>0</b> if the operation is successful; a negative value otherwise.
+ * @since 11
+ * @version 1.0
+ */
+int32_t OH_Usb_CreateTransferRing(UsbDeviceMemMap *devMmap, uint32_t entries, UsbTransferRing **ring);
+
+/**
+ * @brief Obtains a free entry of the submission ring. The entry is executed after it is filled and submitted by\n
+ * calling <b>OH_Usb_SubmitTransferRing</b>.
+ *
+ * @param ring Transfer ring.
+ * @param submission Entry of the submission ring.
+ * @return <b>0</b> if the operation is successful; <b>USB_DDK_DEVICE_BUSY</b> if the submission ring is full;\n
+ * a negative value otherwise.
+ * @since 11
+ * @version 1.0
+ */
+int32_t OH_Usb_GetRingSubmission(UsbTransferRing *ring, struct UsbRingSubmission **submission);
+
+/**
+ * @brief Submits all entries obtained by calling <b>OH_Usb_GetRingSubmission</b>.
+ *
+ * @param ring Transfer ring.
+ * @return <b>0</b> if the operation is successful; a negative value otherwise.
+ * @since 11
+ * @version 1.0
+ */
+int32_t OH_Usb_SubmitTransferRing(UsbTransferRing *ring);
+
+/**
+ * @brief Obtains the oldest entry of the completion ring without removing it. Completions are posted in the order\n
+ * in which the requests are completed. The event fd obtained by calling <b>OH_Usb_GetTransferRingEventFd</b>\n
+ * becomes readable when a completion is posted.
+ *
+ * @param ring Transfer ring.
+ * @param completion Entry of the completion ring. It is set to <b>NULL</b> if the completion ring is empty.
+ * @return <b>0</b> if the operation is successful; a negative value otherwise.
+ * @since 11
+ * @version 1.0
+ */
+int32_t OH_Usb_PeekRingCompletion(UsbTransferRing *ring, struct UsbRingCompletion **completion);
+
+/**
+ * @brief Removes consumed entries from the completion ring.
+ *
+ * @param ring Transfer ring.
+ * @param count Number of entries to remove.
+ * @return <b>0</b> if the operation is successful; a negative value otherwise.
+ * @since 11
+ * @version 1.0
+ */
+int32_t OH_Usb_AdvanceRingCompletion(UsbTransferRing *ring, uint32_t count);
+
+/**
+ * @brief Obtains the event fd of a transfer ring, which can be polled to wait for completions. It is owned by the\n
+ * ring and must not be closed.
+ *
+ * @param ring Transfer ring.
+ * @param fd Event fd of the ring.
+ * @return <b>0</b> if the operation is successful; a negative value otherwise.
+ * @since 11
+ * @version 1.0
+ */
+int32_t OH_Usb_GetTransferRingEventFd(UsbTransferRing *ring, int32_t *fd);
+
+/**
+ * @brief Destroys a transfer ring. Requests that have not been started are cancelled.
+ *
+ * @param ring Transfer ring created by calling <b>OH_Usb_CreateTransferRing</b>.
+ * @since 11
+ * @version 1.0
+ */
+void OH_Usb_DestroyTransferRing(UsbTransferRing *ring);
+
+/**
+ * @brief Creates a read stream on a bulk or interrupt IN endpoint. The used buffer of the device memory map is\n
+ * divided into <b>bufferCount</b> buffers of equal size, and all of them are queued on the endpoint back-to-back\n
+ * so that the endpoint is never idle. Choose a buffer size that is a multiple of the maximum packet size of the\n
+ * endpoint. To avoid resource leakage, destroy a stream by calling <b>OH_Usb_DestroyReadStream</b> after use.
+ *
+ * @param pipe Pipe of the IN endpoint.
+ * @param devMmap Device memory map, which must remain valid until the stream is destroyed.
+ * @param bufferCount Number of buffers. At most 32 buffers are supported.
+ * @param stream Read stream, through which the created stream is returned to the caller.
+ * @return <b>0</b> if the operation is successful; a negative value otherwise.
+ * @since 11
+ * @version 1.0
+ */
+int32_t OH_Usb_CreateReadStream(
+    const struct UsbRequestPipe *pipe, UsbDeviceMemMap *devMmap, uint32_t bufferCount, UsbReadStream **stream);
+
+/**
+ * @brief Obtains the next completed buffer of a read stream. Buffers are returned in the order in which they were\n
+ * queued. The buffer is not queued again until it is released by calling <b>OH_Usb_ReleaseReadStreamBuffer</b>.
+ *
+ * @param stream Read stream.
+ * @param timeout Timeout duration, in milliseconds. The value <b>0</b> indicates that the API returns immediately.
+ * @param buffer Buffer of the stream.
+ * @return <b>0</b> if the operation is successful; <b>USB_DDK_TIMEOUT</b> if no buffer is completed in time;\n
+ * a negative value otherwise.
+ * @since 11
+ * @version 1.0
+ */
+int32_t OH_Usb_AcquireReadStreamBuffer(UsbReadStream *stream, uint32_t timeout, struct UsbStreamBuffer *buffer);
+
+/**
+ * @brief Releases a buffer obtained by calling <b>OH_Usb_AcquireReadStreamBuffer</b> and queues it on the endpoint\n
+ * again.
+ *
+ * @param stream Read stream.
+ * @param buffer Buffer of the stream.
+ * @return <b>0</b> if the operation is successful; a negative value otherwise.
+ * @since 11
+ * @version 1.0
+ */
+int32_t OH_Usb_ReleaseReadStreamBuffer(UsbReadStream *stream, const struct UsbStreamBuffer *buffer);
+
+/**
+ * @brief Destroys a read stream. Buffers that have not been started are cancelled.
+ *
+ * @param stream Read stream created by calling <b>OH_Usb_CreateReadStream</b>.
+ * @since 11
+ * @version 1.0
+ */
+void OH_Usb_DestroyReadStream(UsbReadStream *stream);
+
+/**
+ * @brief Creates an isochronous stream. The stream lays out a table of packet descriptors followed by the packet\n
+ * data in the used buffer of a device memory map, and divides the packets into a ring of transfers. For an IN\n
+ * endpoint, all transfers are submitted when the stream is created. For an OUT endpoint, the transfers are held by\n
+ * the driver until they are submitted by calling <b>OH_Usb_SubmitIsoPackets</b>. To avoid resource leakage,\n
+ * destroy a stream by calling <b>OH_Usb_DestroyIsoStream</b> after use.
+ *
+ * @param pipe Pipe of the isochronous endpoint.
+ * @param devMmap Device memory map, which holds the packet descriptors and the packet data. It must remain valid\n
+ * until the stream is destroyed.
+ * @param params Parameters of the stream.
+ * @param stream Isochronous stream, through which the created stream is returned to the caller.
+ * @return <b>0</b> if the operation is successful; a negative value otherwise.
+ * @since 11
+ * @version 1.0
+ */
+int32_t OH_Usb_CreateIsoStream(const struct UsbRequestPipe *pipe, UsbDeviceMemMap *devMmap,
+    const struct UsbIsoStreamParams *params, UsbIsoStream **stream);
+
+/**
+ * @brief Obtains the packets of the next transfer of an isochronous stream. Transfers are returned in ring order.\n
+ * For an IN stream, the packets contain the received data. For an OUT stream, the packets are ready to be filled\n
+ * with new data. The packets are held by the driver until they are submitted by calling\n
+ * <b>OH_Usb_SubmitIsoPackets</b>.
+ *
+ * @param stream Isochronous stream.
+ * @param timeout Timeout duration, in milliseconds. The value <b>0</b> indicates that the API returns immediately.
+ * @param packets Packet descriptors of the transfer, which point into the device memory map of the stream.
+ * @param packetCount Number of packets in the transfer.
+ * @return <b>0</b> if the operation is successful; <b>USB_DDK_TIMEOUT</b> if no transfer is completed in time;\n
+ * a negative value otherwise.
+ * @since 11
+ * @version 1.0
+ */
+int32_t OH_Usb_AcquireIsoPackets(
+    UsbIsoStream *stream, uint32_t timeout, struct UsbIsoPacketDescriptor **packets, uint32_t *packetCount);
+
+/**
+ * @brief Submits the packets of a transfer obtained by calling <b>OH_Usb_AcquireIsoPackets</b> to the device.\n
+ * For an OUT stream, set the length of each packet before the submission. Packets shorter than the packet size are\n
+ * sent one after another.
+ *
+ * @param stream Isochronous stream.
+ * @param packets Packet descriptors obtained by calling <b>OH_Usb_AcquireIsoPackets</b>.
+ * @return <b>0</b> if the operation is successful; a negative value otherwise.
+ * @since 11
+ * @version 1.0
+ */
+int32_t OH_Usb_SubmitIsoPackets(UsbIsoStream *stream, struct UsbIsoPacketDescriptor *packets);
+
+/**
+ * @brief Destroys an isochronous stream. Transfers that have not been started are cancelled.
+ *
+ * @param stream Isochronous stream created by calling <b>OH_Usb_CreateIsoStream</b>.
+ * @since 11
+ * @version 1.0
+ */
+void OH_Usb_DestroyIsoStream(UsbIsoStream *stream);
+
 /**
  * @brief Creates a buffer. To avoid resource leakage, destroy a buffer by calling\n
  * <b>OH_Usb_DestroyDeviceMemMap</b> after use.
@@ -193,7 +648,8 @@ int32_t OH_Usb_SendPipeRequest(const struct UsbRequestPipe *pipe, UsbDeviceMemMa
  * @param deviceId ID of the device for which the buffer is to be created.
  * @param size Buffer size.
  * @param devMmap Data memory map, through which the created buffer is returned to the caller.
- * @return <b>0</b> if the operation is successful; a negative value otherwise.
+ * @return <b>0</b> if the operation is successful; <b>USB_DDK_DEVICE_BUSY</b> if the device has a pool created by\n
+ * calling <b>OH_Usb_CreateDeviceMemMapPool</b>; a negative value otherwise.
  * @since 10
  * @version 1.0
  */
@@ -207,6 +663,87 @@ int32_t OH_Usb_CreateDeviceMemMap(uint64_t deviceId, size_t size, UsbDeviceMemMa
  * @version 1.0
  */
 void OH_Usb_DestroyDeviceMemMap(UsbDeviceMemMap *devMmap);
+
+/**
+ * @brief Creates a pool of device memory maps. The pool maps the shared memory of the device once and divides it\n
+ * into memory maps of the same size, so that allocating and releasing a memory map does not require a system call.\n
+ * A device can have only one pool, and a pool cannot be used together with <b>OH_Usb_CreateDeviceMemMap</b>\n
+ * on the same device because they share the same memory. While the pool exists, <b>OH_Usb_CreateDeviceMemMap</b>\n
+ * fails for the device. To avoid resource leakage, destroy a pool by calling\n
+ * <b>OH_Usb_DestroyDeviceMemMapPool</b> after use.
+ *
+ * @param deviceId ID of the device for which the pool is to be created.
+ * @param sliceSize Size of each memory map. It is rounded up to a multiple of 1024 bytes.
+ * @param sliceCount Number of memory maps in the pool.
+ * @param flags Flags defined in <b>UsbDeviceMemMapPoolFlag</b>.
+ * @param pool Pool of device memory maps, through which the created pool is returned to the caller.
+ * @return <b>0</b> if the operation is successful; a negative value otherwise.
+ * @since 11
+ * @version 1.0
+ */
+int32_t OH_Usb_CreateDeviceMemMapPool(
+    uint64_t deviceId, uint32_t sliceSize, uint32_t sliceCount, uint32_t flags, UsbDeviceMemMapPool **pool);
+
+/**
+ * @brief Allocates a device memory map from a pool. The memory map can be used in the same way as the one created\n
+ * by calling <b>OH_Usb_CreateDeviceMemMap</b>. Release it by calling <b>OH_Usb_FreeDeviceMemMap</b>.
+ *
+ * @param pool Pool of device memory maps.
+ * @param devMmap Device memory map, through which the allocated buffer is returned to the caller.
+ * @return <b>0</b> if the operation is successful; <b>USB_DDK_MEMORY_ERROR</b> if the pool is exhausted;\n
+ * a negative value otherwise.
+ * @since 11
+ * @version 1.0
+ */
+int32_t OH_Usb_AllocDeviceMemMap(UsbDeviceMemMapPool *pool, UsbDeviceMemMap **devMmap);
+
+/**
+ * @brief Returns a device memory map to its pool.
+ *
+ * @param pool Pool of device memory maps.
+ * @param devMmap Device memory map allocated by calling <b>OH_Usb_AllocDeviceMemMap</b>.
+ * @since 11
+ * @version 1.0
+ */
+void OH_Usb_FreeDeviceMemMap(UsbDeviceMemMapPool *pool, UsbDeviceMemMap *devMmap);
+
+/**
+ * @brief Obtains the statistics of a pool of device memory maps.
+ *
+ * @param pool Pool of device memory maps.
+ * @param stats Statistics of the pool.
+ * @return <b>0</b> if the operation is successful; a negative value otherwise.
+ * @since 11
+ * @version 1.0
+ */
+int32_t OH_Usb_GetDeviceMemMapPoolStats(UsbDeviceMemMapPool *pool, struct UsbDeviceMemMapPoolStats *stats);
+
+/**
+ * @brief Destroys a pool of device memory maps. All memory maps allocated from the pool become invalid.
+ *
+ * @param pool Pool of device memory maps created by calling <b>OH_Usb_CreateDeviceMemMapPool</b>.
+ * @since 11
+ * @version 1.0
+ */
+void OH_Usb_DestroyDeviceMemMapPool(UsbDeviceMemMapPool *pool);
+
+/**
+ * @brief Obtains the throughput of an endpoint and the transfer sizes that keep it busy. The plan takes the bus speed,\n
+ * the maximum packet size with its additional transactions, the service interval and the SuperSpeed endpoint\n
+ * companion descriptor in the extra descriptors of the endpoint into account. A transfer of the recommended size\n
+ * covers about one millisecond of data, and the recommended number of transfers covers about eight milliseconds, so\n
+ * the memory map of the endpoint should hold <b>transferSize</b> times <b>transferCount</b> bytes. For an\n
+ * isochronous stream, the number of packets in a transfer is <b>transferSize</b> divided by <b>packetSize</b>.
+ *
+ * @param endpoint Endpoint descriptor obtained by calling <b>OH_Usb_GetConfigDescriptor</b>.
+ * @param speed Bus speed of the device.
+ * @param plan Transfer plan of the endpoint.
+ * @return <b>0</b> if the operation is successful; a negative value otherwise.
+ * @since 11
+ * @version 1.0
+ */
+int32_t OH_Usb_GetEndpointTransferPlan(
+    const struct UsbDdkEndpointDescriptor *endpoint, UsbDdkSpeed speed, struct UsbEndpointTransferPlan *plan);
 /** @} */
 #ifdef __cplusplus
 }
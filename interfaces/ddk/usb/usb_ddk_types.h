@@ -245,6 +245,65 @@ typedef struct UsbDdkConfigDescriptor {
     uint32_t extraLength;
 } UsbDdkConfigDescriptor;
 
+/**
+ * @brief All configuration descriptors of a device, obtained by calling <b>OH_Usb_GetConfigDescriptorTable</b>.
+ *
+ * @since 11
+ * @version 1.0
+ */
+typedef struct UsbDdkConfigDescriptorTable {
+    /** Number of configurations of the device. */
+    uint8_t numConfigurations;
+    /** Configurations indexed by <b>bConfigurationValue</b>. An entry is <b>NULL</b> if no configuration has\n
+     * the value. */
+    struct UsbDdkConfigDescriptor *configs[256];
+} UsbDdkConfigDescriptorTable;
+
+/**
+ * @brief Read-only view of the raw bytes of a configuration descriptor, created by calling\n
+ * <b>OH_Usb_GetConfigDescriptorView</b>.
+ *
+ * @since 11
+ * @version 1.0
+ */
+typedef struct UsbConfigDescriptorView UsbConfigDescriptorView;
+
+/**
+ * @brief Iterator over the descriptors of a configuration descriptor view. It is initialized by calling\n
+ * <b>OH_Usb_InitViewIterator</b> or <b>OH_Usb_InitViewInterfaceIterator</b> and must not be modified.
+ *
+ * @since 11
+ * @version 1.0
+ */
+typedef struct UsbDescriptorIterator {
+    /** Index of the next descriptor. */
+    uint32_t next;
+    /** Index after the last descriptor. */
+    uint32_t end;
+    /** Type of the descriptors to return. The value <b>0</b> means all types. */
+    uint8_t descriptorType;
+} UsbDescriptorIterator;
+
+/**
+ * @brief Control transfer in a batch sent by calling <b>OH_Usb_SendControlRequests</b>. The direction of the\n
+ * transfer is given by bit 7 of <b>bmRequestType</b> in the setup data.
+ *
+ * @since 11
+ * @version 1.0
+ */
+typedef struct UsbControlTransfer {
+    /** Setup data of the transfer. */
+    struct UsbControlRequestSetup setup;
+    /** Data buffer. For a read transfer, the data read is stored in it. */
+    uint8_t *data;
+    /** Length of the data buffer. */
+    uint32_t dataLen;
+    /** Length of the transferred data. */
+    uint32_t transferedLength;
+    /** Status of the transfer. The value <b>0</b> indicates success. */
+    int32_t status;
+} UsbControlTransfer;
+
 /**
  * @brief Request pipe.
  *
@@ -284,6 +343,233 @@ typedef struct UsbDeviceMemMap {
     uint32_t transferedLength;
 } UsbDeviceMemMap;
 
+/**
+ * @brief Segment of a device memory map used by <b>OH_Usb_SendPipeRequestVectored</b>.
+ *
+ * @since 11
+ * @version 1.0
+ */
+typedef struct UsbMemMapSegment {
+    /** Offset of the segment from the address of the device memory map. */
+    uint32_t offset;
+    /** Length of the segment. */
+    uint32_t length;
+    /** Length of the transferred data of the segment. */
+    uint32_t transferedLength;
+} UsbMemMapSegment;
+
+/**
+ * @brief Pool of device memory maps created by calling <b>OH_Usb_CreateDeviceMemMapPool</b>. All memory maps\n
+ * allocated from a pool are slices of one shared memory mapping.
+ *
+ * @since 11
+ * @version 1.0
+ */
+typedef struct UsbDeviceMemMapPool UsbDeviceMemMapPool;
+
+/**
+ * @brief Flags for creating a pool of device memory maps.
+ *
+ * @since 11
+ * @version 1.0
+ */
+typedef enum {
+    /** Pre-fault the pages of the pool when it is created, so that no page fault occurs on the data path. */
+    USB_DDK_MEM_MAP_POOL_PREFAULT = 1,
+} UsbDeviceMemMapPoolFlag;
+
+/**
+ * @brief Statistics of a pool of device memory maps.
+ *
+ * @since 11
+ * @version 1.0
+ */
+typedef struct UsbDeviceMemMapPoolStats {
+    /** Size of each memory map in the pool, in bytes. */
+    uint32_t sliceSize;
+    /** Number of memory maps in the pool. */
+    uint32_t sliceCount;
+    /** Number of memory maps that are currently allocated. */
+    uint32_t inUse;
+    /** Maximum number of memory maps that have been allocated at the same time. */
+    uint32_t highWaterMark;
+    /** Number of allocations served by the pool. */
+    uint64_t hits;
+    /** Number of allocations that failed because the pool was exhausted. */
+    uint64_t misses;
+} UsbDeviceMemMapPoolStats;
+
+/**
+ * @brief Packet descriptor of an isochronous stream. The descriptors of a stream are stored in the device memory\n
+ * map of the stream.
+ *
+ * @since 11
+ * @version 1.0
+ */
+typedef struct UsbIsoPacketDescriptor {
+    /** Offset of the packet data from the address of the device memory map. */
+    uint32_t offset;
+    /** Length of the packet. For an OUT stream, the driver sets it to the number of bytes to send. */
+    uint32_t length;
+    /** Length of the transferred data of the packet. */
+    uint32_t actualLength;
+    /** Transfer status of the packet. The value <b>0</b> indicates success. */
+    int32_t status;
+} UsbIsoPacketDescriptor;
+
+/**
+ * @brief Parameters of an isochronous stream.
+ *
+ * @since 11
+ * @version 1.0
+ */
+typedef struct UsbIsoStreamParams {
+    /** Maximum size of a packet, which is usually the maximum packet size of the endpoint. */
+    uint32_t packetSize;
+    /** Number of packets in a transfer. A transfer is submitted to the device in one request. */
+    uint32_t packetsPerTransfer;
+    /** Number of transfers in the ring. At most 32 transfers are supported. */
+    uint32_t transferCount;
+} UsbIsoStreamParams;
+
+/**
+ * @brief Isochronous stream created by calling <b>OH_Usb_CreateIsoStream</b>.
+ *
+ * @since 11
+ * @version 1.0
+ */
+typedef struct UsbIsoStream UsbIsoStream;
+
+/**
+ * @brief Buffer of a read stream obtained by calling <b>OH_Usb_AcquireReadStreamBuffer</b>.
+ *
+ * @since 11
+ * @version 1.0
+ */
+typedef struct UsbStreamBuffer {
+    /** Index of the buffer in the stream. */
+    uint32_t index;
+    /** Offset of the buffer data from the address of the device memory map. */
+    uint32_t offset;
+    /** Length of the transferred data. */
+    uint32_t transferedLength;
+    /** Transfer status of the buffer. The value <b>0</b> indicates success. */
+    int32_t status;
+} UsbStreamBuffer;
+
+/**
+ * @brief Read stream created by calling <b>OH_Usb_CreateReadStream</b>.
+ *
+ * @since 11
+ * @version 1.0
+ */
+typedef struct UsbReadStream UsbReadStream;
+
+/**
+ * @brief Entry of the submission ring of a transfer ring. It describes a pipe request on a buffer in the device\n
+ * memory map of the ring.
+ *
+ * @since 11
+ * @version 1.0
+ */
+typedef struct UsbRingSubmission {
+    /** Data that is returned unchanged in the completion of the request. */
+    uint64_t userData;
+    /** Interface operation handle. */
+    uint64_t interfaceHandle;
+    /** Offset of the buffer from the address of the device memory map. */
+    uint32_t offset;
+    /** Length of the buffer. */
+    uint32_t length;
+    /** Timeout duration, in milliseconds. */
+    uint32_t timeout;
+    /** Endpoint address. */
+    uint8_t endpoint;
+} UsbRingSubmission;
+
+/**
+ * @brief Entry of the completion ring of a transfer ring.
+ *
+ * @since 11
+ * @version 1.0
+ */
+typedef struct UsbRingCompletion {
+    /** User data of the submission. */
+    uint64_t userData;
+    /** Transfer status. The value <b>0</b> indicates success. */
+    int32_t status;
+    /** Length of the transferred data. */
+    uint32_t transferedLength;
+} UsbRingCompletion;
+
+/**
+ * @brief Transfer ring created by calling <b>OH_Usb_CreateTransferRing</b>.
+ *
+ * @since 11
+ * @version 1.0
+ */
+typedef struct UsbTransferRing UsbTransferRing;
+
+/**
+ * @brief Completion of a pipe request submitted by calling <b>OH_Usb_SubmitPipeRequest</b>.
+ *
+ * @since 11
+ * @version 1.0
+ */
+typedef struct UsbPipeRequestCompletion {
+    /** Request ID returned by <b>OH_Usb_SubmitPipeRequest</b>. */
+    uint64_t requestId;
+    /** Device memory map used by the request. */
+    UsbDeviceMemMap *devMmap;
+    /** Result of the request. The value <b>0</b> indicates success; a negative value indicates failure. */
+    int32_t status;
+    /** Length of the transferred data. */
+    uint32_t transferedLength;
+} UsbPipeRequestCompletion;
+
+/**
+ * @brief Bus speed of a USB device.
+ *
+ * @since 11
+ * @version 1.0
+ */
+typedef enum {
+    /** Low speed, 1.5 Mbit/s. */
+    USB_DDK_SPEED_LOW = 1,
+    /** Full speed, 12 Mbit/s. */
+    USB_DDK_SPEED_FULL = 2,
+    /** High speed, 480 Mbit/s. */
+    USB_DDK_SPEED_HIGH = 3,
+    /** SuperSpeed, 5 Gbit/s. */
+    USB_DDK_SPEED_SUPER = 4,
+    /** SuperSpeedPlus, 10 Gbit/s. */
+    USB_DDK_SPEED_SUPER_PLUS = 5,
+} UsbDdkSpeed;
+
+/**
+ * @brief Throughput of an endpoint and the transfer sizes recommended for it, obtained by calling\n
+ * <b>OH_Usb_GetEndpointTransferPlan</b>.
+ *
+ * @since 11
+ * @version 1.0
+ */
+typedef struct UsbEndpointTransferPlan {
+    /** Transfer type of the endpoint: <b>1</b> for isochronous, <b>2</b> for bulk and <b>3</b> for interrupt. */
+    uint8_t transferType;
+    /** Maximum size of a packet, in bytes. */
+    uint32_t packetSize;
+    /** Maximum number of packets in a service interval, or in a burst for a bulk endpoint. */
+    uint32_t packetsPerInterval;
+    /** Service interval, in microseconds. The value <b>0</b> indicates a bulk endpoint, which is not periodic. */
+    uint32_t intervalUs;
+    /** Maximum throughput, in bytes per second. For a bulk endpoint, this is the limit of the bus. */
+    uint64_t maxBytesPerSecond;
+    /** Recommended size of a transfer, in bytes, which is a multiple of <b>packetSize</b>. */
+    uint32_t transferSize;
+    /** Recommended number of transfers queued on the endpoint at the same time. */
+    uint32_t transferCount;
+} UsbEndpointTransferPlan;
+
 /**
  * @brief Defines error codes for USB DDK.
  *
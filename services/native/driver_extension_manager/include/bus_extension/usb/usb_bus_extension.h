@@ -33,6 +33,8 @@ public:
     ~UsbBusExtension();
     int32_t SetDevChangeCallback(shared_ptr<IDevChangeCallback> callback) override;
     bool MatchDriver(const DriverInfo &driver, const DeviceInfo &device) override;
+    bool GetDeviceMatchKey(const DeviceInfo &device, uint64_t &matchKey) override;
+    vector<uint64_t> GetDriverMatchKeys(const DriverInfo &driver) override;
     shared_ptr<DriverInfoExt> ParseDriverInfo(const vector<Metadata> &metadata) override;
     shared_ptr<DriverInfoExt> GetNewDriverInfoExtObject() override;
     void SetUsbInferface(sptr<IUsbInterface> iusb);
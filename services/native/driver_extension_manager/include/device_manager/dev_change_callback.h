@@ -15,17 +15,44 @@
 #ifndef DEV_CHANGE_CALLBACK_H
 #define DEV_CHANGE_CALLBACK_H
 
+#include <map>
 #include <memory>
+#include <mutex>
 #include "ext_object.h"
 #include "idev_change_callback.h"
+#include "timer.h"
 
 namespace OHOS {
 namespace ExternalDeviceManager {
 class DevChangeCallback final : public IDevChangeCallback {
 public:
     DevChangeCallback() = default;
+    // Collects the events of batchWindowMs and registers them as one batch, so that a hub attaching many devices
+    // at once costs one update of the device manager. A window of 0 passes every event on at once.
+    explicit DevChangeCallback(uint32_t batchWindowMs);
+    ~DevChangeCallback();
     int32_t OnDeviceAdd(std::shared_ptr<DeviceInfo> device) override;
     int32_t OnDeviceRemove(std::shared_ptr<DeviceInfo> device) override;
+    // passes the collected events on now
+    int32_t Flush();
+
+private:
+    // the last events of a device in the window, an add that is followed by a remove is dropped
+    struct PendingChange {
+        std::shared_ptr<DeviceInfo> removed;
+        std::shared_ptr<DeviceInfo> added;
+    };
+
+    // returns false when no timer could be armed for the batch, the event is passed on at once then
+    bool ArmBatchTimer();
+
+    uint32_t batchWindowMs_ {0};
+    std::mutex batchMutex_;
+    std::map<uint64_t, PendingChange> pendingChanges_;
+    // keeps the batches in order when the timer and Flush hand them over at the same time
+    std::mutex flushMutex_;
+    Utils::Timer batchTimer_ {"devChangeBatchTimer"};
+    uint32_t batchTimerId_ {UINT32_MAX};
 };
 } // namespace ExternalDeviceManager
 } // namespace OHOS
@@ -31,15 +31,40 @@ class Device : public std::enable_shared_from_this<Device> {
 public:
     explicit Device(std::shared_ptr<DeviceInfo> info) : info_(info) {}
 
-    int32_t Connect();
-    int32_t Connect(const sptr<IDriverExtMgrCallback> &connectCallback);
-    int32_t Disconnect();
+    // Registers the callback of an application binding the device. A connection that is up already is reported at
+    // once, the connect worker makes a missing one and the callback is told when it is done.
+    int32_t RegisterConnectCallback(const sptr<IDriverExtMgrCallback> &connectCallback);
+    void UnregisterConnectCallback(const sptr<IDriverExtMgrCallback> &connectCallback);
+
+    // The connect worker brings the driver extension connection of the device to the bundle set here, an empty
+    // bundleInfo asks for no connection. With reconnect, a connection to the bundle is taken down and made again, so
+    // that an updated driver is restarted. Returns true when the device has to be handed to the worker.
+    bool SetConnectTarget(const std::string &bundleInfo, bool reconnect = false);
+    // Called by the connect worker only. Returns the bundle that the next connect or disconnect of the device works
+    // on, an empty bundleInfo once the connection reached its target.
+    std::string GetNextConnectStep();
+    // Called by the connect worker only, connects or disconnects the bundle returned by GetNextConnectStep.
+    void RunConnectStep(const std::string &bundleInfo);
+
+    std::string GetConnectedBundleInfo()
+    {
+        std::lock_guard<std::mutex> lock(connStateMutex_);
+        return connectedBundleInfo_;
+    }
 
     bool HasDriver() const
     {
+        std::lock_guard<std::mutex> lock(connStateMutex_);
         return !bundleInfo_.empty();
     };
 
+    // Tells whether the device is connected or the connect worker is about to change its connection.
+    bool HasConnection() const
+    {
+        std::lock_guard<std::mutex> lock(connStateMutex_);
+        return !connectedBundleInfo_.empty() || !targetBundleInfo_.empty() || connState_ != ConnectState::IDLE;
+    }
+
     std::shared_ptr<DeviceInfo> GetDeviceInfo() const
     {
         return info_;
@@ -47,16 +72,19 @@ public:
 
     void AddBundleInfo(const std::string &bundleInfo)
     {
+        std::lock_guard<std::mutex> lock(connStateMutex_);
         bundleInfo_ = bundleInfo;
     }
 
     void RemoveBundleInfo()
     {
+        std::lock_guard<std::mutex> lock(connStateMutex_);
         bundleInfo_.clear();
     }
 
     std::string GetBundleInfo() const
     {
+        std::lock_guard<std::mutex> lock(connStateMutex_);
         return bundleInfo_;
     }
 
@@ -91,6 +119,14 @@ public:
     static std::string GetAbilityName(const std::string &bundleInfo);
 
 private:
+    enum class ConnectState {
+        IDLE,    // the connection is at its target
+        QUEUED,  // waiting for the connect worker
+        RUNNING, // the connect worker is connecting or disconnecting, or waits for the bundle of the next step
+    };
+
+    int32_t ConnectBundle(const std::string &bundleInfo);
+    int32_t DisconnectBundle(const std::string &bundleInfo);
     void OnConnect(const sptr<IRemoteObject> &remote, int resultCode);
     void OnDisconnect(int resultCode);
     void UpdateDrvExtConnNotify();
@@ -115,7 +151,7 @@ private:
     friend class DriverExtMgrCallbackDeathRecipient;
     friend class DrvExtConnNotify;
     static std::string stiching_;
-    std::string bundleInfo_;
+    std::string bundleInfo_; // guarded by connStateMutex_
     std::shared_ptr<DriverInfo> driver_;
     std::shared_ptr<DeviceInfo> info_;
 
@@ -123,6 +159,13 @@ private:
     sptr<IRemoteObject> drvExtRemote_;
     std::set<sptr<IDriverExtMgrCallback>, DrvExtMgrCallbackCompare> callbacks_;
     std::shared_ptr<DrvExtConnNotify> connectNofitier_;
+
+    mutable std::mutex connStateMutex_;
+    ConnectState connState_ {ConnectState::IDLE};
+    std::string targetBundleInfo_;
+    std::string connectedBundleInfo_;
+    // the connection has to be taken down before the target is connected, even if it is the target
+    bool reconnect_ {false};
 };
 
 class DriverExtMgrCallbackDeathRecipient : public IRemoteObject::DeathRecipient {
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DEVICE_MANAGER_DEVICE_CONNECT_WORKER_H
+#define DEVICE_MANAGER_DEVICE_CONNECT_WORKER_H
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+#include "device.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+// Connects and disconnects driver extensions on threads of its own, so that the ability manager calls are made
+// without any lock of the device manager held. A device is queued once however often its target changes before a
+// worker gets to it. Up to maxConcurrency devices are worked on at the same time, but only one connect or disconnect
+// of a bundle runs at any time, so a bank of devices is ready after its slowest driver rather than after all of them.
+class DeviceConnectWorker final {
+public:
+    explicit DeviceConnectWorker(size_t maxConcurrency = 1);
+    ~DeviceConnectWorker();
+    DeviceConnectWorker(const DeviceConnectWorker &) = delete;
+    DeviceConnectWorker &operator=(const DeviceConnectWorker &) = delete;
+
+    // sets the connect target of the device and queues it if needed, see Device::SetConnectTarget
+    void Request(const std::shared_ptr<Device> &device, const std::string &bundleInfo, bool reconnect = false);
+    // waits until every queued device reached its target
+    void WaitIdle();
+
+private:
+    void WorkLoop();
+    // takes the first queued device whose next step works on a bundle no other worker is busy with, and drops the
+    // devices that reached their target on the way
+    bool TakeDevice(std::shared_ptr<Device> &device, std::string &bundleInfo);
+
+    size_t maxConcurrency_;
+    std::mutex mutex_;
+    std::condition_variable workCond_;
+    std::condition_variable idleCond_;
+    std::deque<std::shared_ptr<Device>> queue_;
+    // bundle names of the steps that are running
+    std::unordered_set<std::string> busyBundles_;
+    size_t running_ {0};
+    size_t waiting_ {0};
+    bool stop_ {false};
+    std::vector<std::thread> workers_;
+};
+} // namespace ExternalDeviceManager
+} // namespace OHOS
+#endif // DEVICE_MANAGER_DEVICE_CONNECT_WORKER_H
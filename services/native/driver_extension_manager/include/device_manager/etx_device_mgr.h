@@ -22,6 +22,7 @@
 #include <unordered_map>
 #include <unordered_set>
 #include "device.h"
+#include "device_connect_worker.h"
 #include "ext_object.h"
 #include "single_instance.h"
 #include "timer.h"
@@ -37,16 +38,31 @@ public:
     int32_t Init();
     int32_t RegisterDevice(shared_ptr<DeviceInfo> devInfo);
     int32_t UnRegisterDevice(const shared_ptr<DeviceInfo> devInfo);
+    // removes and then adds devices under one lock, matching the added ones against the drivers in one pass
+    int32_t UpdateDevices(
+        const vector<shared_ptr<DeviceInfo>> &removedDevInfos, const vector<shared_ptr<DeviceInfo>> &addedDevInfos);
     vector<shared_ptr<DeviceInfo>> QueryDevice(const BusType busType);
     static int32_t UpdateBundleStatusCallback(
         int32_t bundleStatus, int32_t busType, const string &bundleName, const string &abilityName);
+    // Both only hand the request to the connect worker and return before the connection is made or taken down, the
+    // callback registered by ConnectDevice is told about the result.
     int32_t ConnectDevice(uint64_t deviceId, const sptr<IDriverExtMgrCallback> &connectCallback);
     int32_t DisConnectDevice(uint64_t deviceId);
 
 private:
-    ExtDeviceManager() = default;
+    // Immutable copy of deviceMap_ for readers. Writers build a new one under deviceMapMutex_ and swap it in with
+    // atomic_store, so queries never wait for hotplug or bundle updates.
+    struct DeviceSnapshot {
+        unordered_map<BusType, unordered_map<uint64_t, shared_ptr<Device>>> devices;
+        unordered_map<BusType, vector<shared_ptr<DeviceInfo>>> deviceInfos;
+    };
+
+    ExtDeviceManager();
     void PrintMatchDriverMap();
-    int32_t AddDevIdOfBundleInfoMap(shared_ptr<Device> device, string &bundleInfo);
+    shared_ptr<Device> AddDevice(shared_ptr<DeviceInfo> devInfo, bool &changed);
+    int32_t RemoveDevice(shared_ptr<DeviceInfo> devInfo, bool &changed);
+    int32_t MatchAndConnectDevices(const vector<shared_ptr<Device>> &devices);
+    int32_t AddDevIdOfBundleInfoMap(shared_ptr<Device> device, string &bundleInfo, bool reconnect = false);
     int32_t RemoveDevIdOfBundleInfoMap(shared_ptr<Device> device, string &bundleInfo);
     int32_t RemoveAllDevIdOfBundleInfoMap(shared_ptr<Device> device, string &bundleInfo);
     int32_t AddBundleInfo(enum BusType busType, const string &bundleName, const string &abilityName);
@@ -55,12 +71,18 @@ private:
     std::shared_ptr<Device> QueryDeviceByDeviceID(uint64_t deviceId);
     void UnLoadSelf(void);
     size_t GetTotalDeviceNum(void) const;
+    void PublishDeviceSnapshot(void);
+    void AddDevIdOfMatchKeyMap(shared_ptr<DeviceInfo> devInfo);
+    void RemoveDevIdOfMatchKeyMap(shared_ptr<DeviceInfo> devInfo);
     unordered_map<BusType, unordered_map<uint64_t, shared_ptr<Device>>> deviceMap_;
     unordered_map<string, unordered_set<uint64_t>> bundleMatchMap_; // driver matching table
+    unordered_map<uint64_t, unordered_set<uint64_t>> matchKeyMap_; // match key of devices, guarded by deviceMapMutex_
+    shared_ptr<const DeviceSnapshot> deviceSnapshot_ {make_shared<const DeviceSnapshot>()};
     mutex deviceMapMutex_;
     mutex bundleMatchMapMutex_;
     Utils::Timer unloadSelftimer_ {"unLoadSelfTimer"};
     uint32_t unloadSelftimerId_ {UINT32_MAX};
+    DeviceConnectWorker connectWorker_;
 };
 } // namespace ExternalDeviceManager
 } // namespace OHOS
@@ -54,6 +54,10 @@ public:
      */
     int32_t Init();
     shared_ptr<BundleInfoNames> QueryMatchDriver(shared_ptr<DeviceInfo> devInfo);
+    // the driver of each device, or nullptr, with the installed drivers read once for all of them
+    vector<shared_ptr<BundleInfoNames>> QueryMatchDrivers(const vector<shared_ptr<DeviceInfo>> &devInfos);
+    bool QueryDeviceMatchKey(shared_ptr<DeviceInfo> devInfo, uint64_t &matchKey);
+    bool QueryDriverMatchKeys(const string &bundleName, const string &abilityName, vector<uint64_t> &matchKeys);
     int32_t RegisterOnBundleUpdate(PCALLBACKFUN pFun);
     int32_t UnRegisterOnBundleUpdate();
     ~DriverPkgManager();
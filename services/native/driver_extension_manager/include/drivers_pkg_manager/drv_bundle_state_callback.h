@@ -80,6 +80,8 @@ public:
 
     bool GetAllDriverInfos(std::map<string, DriverInfo> &driverInfos);
 
+    bool GetDriverInfo(const string &drvInfoKey, DriverInfo &driverInfo);
+
     bool CheckBundleMgrProxyPermission();
 
     string GetStiching();
@@ -107,5 +107,15 @@ std::shared_ptr<IBusExtension> BusExtensionCore::GetBusExtensionByName(std::stri
     }
     return busExtensions_[busType];
 }
+
+std::shared_ptr<IBusExtension> BusExtensionCore::GetBusExtensionByType(BusType busType)
+{
+    auto iterExtension = busExtensions_.find(busType);
+    if (iterExtension == busExtensions_.end()) {
+        EDM_LOGD(MODULE_DEV_MGR, "busType %{public}d bus extension not found", busType);
+        return nullptr;
+    }
+    return iterExtension->second;
+}
 } // namespace ExternalDeviceManager
 } // namespace OHOS
\ No newline at end of file
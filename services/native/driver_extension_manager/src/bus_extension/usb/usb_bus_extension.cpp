@@ -30,6 +30,12 @@
 namespace OHOS {
 namespace ExternalDeviceManager {
 using namespace std;
+constexpr uint32_t MATCH_KEY_VID_SHIFT = 16;
+
+static uint64_t GetUsbMatchKey(uint16_t vid, uint16_t pid)
+{
+    return (static_cast<uint64_t>(vid) << MATCH_KEY_VID_SHIFT) | pid;
+}
 
 UsbBusExtension::UsbBusExtension()
 {
@@ -120,6 +126,39 @@ bool UsbBusExtension::MatchDriver(const DriverInfo &driver, const DeviceInfo &de
     return true;
 }
 
+bool UsbBusExtension::GetDeviceMatchKey(const DeviceInfo &device, uint64_t &matchKey)
+{
+    if (device.GetBusType() != BusType::BUS_TYPE_USB) {
+        EDM_LOGW(MODULE_BUS_USB, "deivce type not support %{public}u", (uint32_t)device.GetBusType());
+        return false;
+    }
+    const UsbDeviceInfo &usbDeviceInfo = static_cast<const UsbDeviceInfo &>(device);
+    matchKey = GetUsbMatchKey(usbDeviceInfo.idVendor_, usbDeviceInfo.idProduct_);
+    return true;
+}
+
+vector<uint64_t> UsbBusExtension::GetDriverMatchKeys(const DriverInfo &driver)
+{
+    vector<uint64_t> matchKeys;
+    if (LowerStr(driver.GetBusName()) != "usb") {
+        EDM_LOGW(MODULE_BUS_USB, "driver bus not support by this module [UsbBusExtension]");
+        return matchKeys;
+    }
+    const UsbDriverInfo *usbDriverInfo = static_cast<const UsbDriverInfo *>(driver.GetInfoExt().get());
+    if (usbDriverInfo == nullptr) {
+        EDM_LOGE(MODULE_BUS_USB, "static_cast error, the usbDriverInfo is nullptr");
+        return matchKeys;
+    }
+    // MatchDriver takes any of the vids together with any of the pids
+    matchKeys.reserve(usbDriverInfo->vids_.size() * usbDriverInfo->pids_.size());
+    for (uint16_t vid : usbDriverInfo->vids_) {
+        for (uint16_t pid : usbDriverInfo->pids_) {
+            matchKeys.push_back(GetUsbMatchKey(vid, pid));
+        }
+    }
+    return matchKeys;
+}
+
 shared_ptr<DriverInfoExt> UsbBusExtension::ParseDriverInfo(const vector<Metadata> &metadata)
 {
     shared_ptr<UsbDriverInfo> usbDriverInfo = make_shared<UsbDriverInfo>();
@@ -14,22 +14,116 @@
  */
 
 #include "dev_change_callback.h"
+#include <cinttypes>
+#include <vector>
 #include "edm_errors.h"
 #include "etx_device_mgr.h"
 #include "hilog_wrapper.h"
 
 namespace OHOS {
 namespace ExternalDeviceManager {
+DevChangeCallback::DevChangeCallback(uint32_t batchWindowMs) : batchWindowMs_(batchWindowMs)
+{
+    if (batchWindowMs_ == 0) {
+        return;
+    }
+    if (auto ret = batchTimer_.Setup(); ret != Utils::TIMER_ERR_OK) {
+        EDM_LOGE(MODULE_DEV_MGR, "set up batch timer failed %{public}u, events are not batched", ret);
+        batchWindowMs_ = 0;
+    }
+}
+
+DevChangeCallback::~DevChangeCallback()
+{
+    if (batchWindowMs_ != 0) {
+        batchTimer_.Shutdown();
+        // the changes still waiting for the window are not dropped with the callback
+        (void)Flush();
+    }
+}
+
 int32_t DevChangeCallback::OnDeviceAdd(std::shared_ptr<DeviceInfo> device)
 {
     EDM_LOGD(MODULE_DEV_MGR, "OnDeviceAdd start");
-    return ExtDeviceManager::GetInstance().RegisterDevice(device);
+    if (batchWindowMs_ == 0) {
+        return ExtDeviceManager::GetInstance().RegisterDevice(device);
+    }
+
+    std::unique_lock<std::mutex> lock(batchMutex_);
+    if (!ArmBatchTimer()) {
+        lock.unlock();
+        return ExtDeviceManager::GetInstance().RegisterDevice(device);
+    }
+    pendingChanges_[device->GetDeviceId()].added = device;
+    return EDM_OK;
 }
 
 int32_t DevChangeCallback::OnDeviceRemove(std::shared_ptr<DeviceInfo> device)
 {
     EDM_LOGD(MODULE_DEV_MGR, "OnDeviceRemove start");
-    return ExtDeviceManager::GetInstance().UnRegisterDevice(device);
+    if (batchWindowMs_ == 0) {
+        return ExtDeviceManager::GetInstance().UnRegisterDevice(device);
+    }
+
+    std::unique_lock<std::mutex> lock(batchMutex_);
+    if (!ArmBatchTimer()) {
+        lock.unlock();
+        return ExtDeviceManager::GetInstance().UnRegisterDevice(device);
+    }
+    PendingChange &change = pendingChanges_[device->GetDeviceId()];
+    if (change.added != nullptr) {
+        // the device never reaches the device manager, the remove finds nothing unless the device was known before
+        EDM_LOGD(MODULE_DEV_MGR, "add and remove of deviceId %{public}016" PRIX64 " cancelled", device->GetDeviceId());
+        change.added = nullptr;
+    }
+    if (change.removed == nullptr) {
+        change.removed = device;
+    }
+    return EDM_OK;
+}
+
+bool DevChangeCallback::ArmBatchTimer()
+{
+    // Please call with batchMutex_ held. The first event of a batch arms the timer for all of them.
+    if (!pendingChanges_.empty()) {
+        return true;
+    }
+    uint32_t timerId = batchTimer_.Register([this]() { (void)Flush(); }, batchWindowMs_, true);
+    if (timerId == Utils::TIMER_ERR_DEAL_FAILED) {
+        EDM_LOGE(MODULE_DEV_MGR, "register batch timer failed, the event is passed on at once");
+        return false;
+    }
+    batchTimerId_ = timerId;
+    return true;
+}
+
+int32_t DevChangeCallback::Flush()
+{
+    std::lock_guard<std::mutex> flushLock(flushMutex_);
+    std::map<uint64_t, PendingChange> changes;
+    {
+        std::lock_guard<std::mutex> lock(batchMutex_);
+        changes.swap(pendingChanges_);
+        batchTimer_.Unregister(batchTimerId_);
+        batchTimerId_ = UINT32_MAX;
+    }
+    if (changes.empty()) {
+        return EDM_OK;
+    }
+
+    std::vector<std::shared_ptr<DeviceInfo>> removedDevInfos;
+    std::vector<std::shared_ptr<DeviceInfo>> addedDevInfos;
+    for (auto &[_, change] : changes) {
+        if (change.removed != nullptr) {
+            removedDevInfos.push_back(change.removed);
+        }
+        if (change.added != nullptr) {
+            addedDevInfos.push_back(change.added);
+        }
+    }
+    EDM_LOGI(MODULE_DEV_MGR, "device batch: %{public}zu removed, %{public}zu added", removedDevInfos.size(),
+        addedDevInfos.size());
+    return ExtDeviceManager::GetInstance().UpdateDevices(removedDevInfos, addedDevInfos);
 }
 } // namespace ExternalDeviceManager
 } // namespace OHOS
\ No newline at end of file
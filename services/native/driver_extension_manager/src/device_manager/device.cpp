@@ -14,6 +14,7 @@
  */
 
 #include "device.h"
+#include <cinttypes>
 #include "hilog_wrapper.h"
 
 namespace OHOS {
@@ -40,15 +41,15 @@ std::string Device::GetAbilityName(const std::string &bundleInfo)
     return bundleInfo.substr(pos + stiching_.length());
 }
 
-int32_t Device::Connect()
+int32_t Device::ConnectBundle(const std::string &bundleInfo)
 {
     EDM_LOGI(MODULE_DEV_MGR, "%{public}s enter", __func__);
     std::lock_guard<std::recursive_mutex> lock(deviceMutex_);
     uint32_t busDevId = GetDeviceInfo()->GetBusDevId();
-    std::string bundleInfo = GetBundleInfo();
     std::string bundleName = Device::GetBundleName(bundleInfo);
     std::string abilityName = Device::GetAbilityName(bundleInfo);
-    AddDrvExtConnNotify();
+    // the controller takes a notifier for one connection only, and the callbacks of an old one are dropped with it
+    UpdateDrvExtConnNotify();
     int32_t ret = DriverExtensionController::GetInstance().ConnectDriverExtension(
         bundleName, abilityName, connectNofitier_, busDevId);
     if (ret != UsbErrCode::EDM_OK) {
@@ -58,48 +59,33 @@ int32_t Device::Connect()
     return UsbErrCode::EDM_OK;
 }
 
-int32_t Device::Connect(const sptr<IDriverExtMgrCallback> &connectCallback)
+int32_t Device::RegisterConnectCallback(const sptr<IDriverExtMgrCallback> &connectCallback)
 {
     EDM_LOGI(MODULE_DEV_MGR, "%{public}s enter", __func__);
     std::lock_guard<std::recursive_mutex> lock(deviceMutex_);
-    uint64_t deviceId = GetDeviceInfo()->GetDeviceId();
-    if (drvExtRemote_ != nullptr) {
-        connectCallback->OnConnect(deviceId, drvExtRemote_, {UsbErrCode::EDM_OK, ""});
-        int32_t ret = RegisterDrvExtMgrCallback(connectCallback);
-        if (ret != UsbErrCode::EDM_OK) {
-            EDM_LOGE(MODULE_DEV_MGR, "failed to register callback object");
-            return ret;
-        }
-    }
-
     int32_t ret = RegisterDrvExtMgrCallback(connectCallback);
     if (ret != UsbErrCode::EDM_OK) {
         EDM_LOGE(MODULE_DEV_MGR, "failed to register callback object");
         return ret;
     }
 
-    UpdateDrvExtConnNotify();
-    std::string bundleInfo = GetBundleInfo();
-    std::string bundleName = Device::GetBundleName(bundleInfo);
-    std::string abilityName = Device::GetAbilityName(bundleInfo);
-    AddDrvExtConnNotify();
-    uint32_t busDevId = GetDeviceInfo()->GetBusDevId();
-    ret = DriverExtensionController::GetInstance().ConnectDriverExtension(
-        bundleName, abilityName, connectNofitier_, busDevId);
-    if (ret != UsbErrCode::EDM_OK) {
-        EDM_LOGE(MODULE_DEV_MGR, "failed to connect driver extension");
-        UnregisterDrvExtMgrCallback(connectCallback);
-        return ret;
+    if (drvExtRemote_ != nullptr) {
+        connectCallback->OnConnect(GetDeviceInfo()->GetDeviceId(), drvExtRemote_, {UsbErrCode::EDM_OK, ""});
     }
     return UsbErrCode::EDM_OK;
 }
 
-int32_t Device::Disconnect()
+void Device::UnregisterConnectCallback(const sptr<IDriverExtMgrCallback> &connectCallback)
+{
+    EDM_LOGI(MODULE_DEV_MGR, "%{public}s enter", __func__);
+    UnregisterDrvExtMgrCallback(connectCallback);
+}
+
+int32_t Device::DisconnectBundle(const std::string &bundleInfo)
 {
     EDM_LOGI(MODULE_DEV_MGR, "%{public}s enter", __func__);
     std::lock_guard<std::recursive_mutex> lock(deviceMutex_);
     uint32_t busDevId = GetDeviceInfo()->GetBusDevId();
-    std::string bundleInfo = GetBundleInfo();
     std::string bundleName = Device::GetBundleName(bundleInfo);
     std::string abilityName = Device::GetAbilityName(bundleInfo);
     int32_t ret = DriverExtensionController::GetInstance().DisconnectDriverExtension(
@@ -112,11 +98,71 @@ int32_t Device::Disconnect()
     return UsbErrCode::EDM_OK;
 }
 
+bool Device::SetConnectTarget(const std::string &bundleInfo, bool reconnect)
+{
+    std::lock_guard<std::mutex> lock(connStateMutex_);
+    targetBundleInfo_ = bundleInfo;
+    if (reconnect && !targetBundleInfo_.empty() && !connectedBundleInfo_.empty()) {
+        reconnect_ = true;
+    }
+    // a queued or running device picks up the new target by itself
+    if (connState_ != ConnectState::IDLE || (targetBundleInfo_ == connectedBundleInfo_ && !reconnect_)) {
+        return false;
+    }
+    connState_ = ConnectState::QUEUED;
+    return true;
+}
+
+std::string Device::GetNextConnectStep()
+{
+    std::lock_guard<std::mutex> lock(connStateMutex_);
+    if (targetBundleInfo_ == connectedBundleInfo_ && !reconnect_) {
+        connState_ = ConnectState::IDLE;
+        return "";
+    }
+    connState_ = ConnectState::RUNNING;
+    // a connection to another bundle is taken down first
+    return connectedBundleInfo_.empty() ? targetBundleInfo_ : connectedBundleInfo_;
+}
+
+void Device::RunConnectStep(const std::string &bundleInfo)
+{
+    std::unique_lock<std::mutex> lock(connStateMutex_);
+    // only the connect worker sets connectedBundleInfo_, OnDisconnect may clear it meanwhile
+    bool connected = !connectedBundleInfo_.empty();
+    lock.unlock();
+    int32_t ret = connected ? DisconnectBundle(bundleInfo) : ConnectBundle(bundleInfo);
+    lock.lock();
+    if (connected) {
+        // a failed disconnect leaves nothing to disconnect
+        connectedBundleInfo_.clear();
+        reconnect_ = false;
+        return;
+    }
+    if (ret == UsbErrCode::EDM_OK) {
+        connectedBundleInfo_ = bundleInfo;
+        return;
+    }
+
+    EDM_LOGE(MODULE_DEV_MGR, "deviceId %{public}016" PRIX64 " connect %{public}s failed[%{public}d]",
+        GetDeviceInfo()->GetDeviceId(), Device::GetAbilityName(bundleInfo).c_str(), ret);
+    // given up until the next request, unless the target changed meanwhile
+    if (targetBundleInfo_ == bundleInfo) {
+        targetBundleInfo_.clear();
+    }
+    lock.unlock();
+    // applications waiting for the connection are told about the failure
+    OnConnect(nullptr, ret);
+}
+
 void Device::OnConnect(const sptr<IRemoteObject> &remote, int resultCode)
 {
     EDM_LOGI(MODULE_DEV_MGR, "%{public}s enter", __func__);
     if (remote == nullptr || resultCode != UsbErrCode::EDM_OK) {
         EDM_LOGE(MODULE_DEV_MGR, "failed to connect driver extension %{public}d", resultCode);
+        std::lock_guard<std::mutex> stateLock(connStateMutex_);
+        connectedBundleInfo_.clear();
+        reconnect_ = false;
     }
 
     std::lock_guard<std::recursive_mutex> lock(deviceMutex_);
@@ -135,6 +181,13 @@ void Device::OnDisconnect(int resultCode)
         EDM_LOGE(MODULE_DEV_MGR, "failed to disconnect driver extension %{public}d", resultCode);
     }
 
+    {
+        // the extension is gone, also when it stopped or died by itself, so the next request connects it again
+        std::lock_guard<std::mutex> stateLock(connStateMutex_);
+        connectedBundleInfo_.clear();
+        reconnect_ = false;
+    }
+
     std::lock_guard<std::recursive_mutex> lock(deviceMutex_);
     drvExtRemote_ = nullptr;
     for (auto &callback : callbacks_) {
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "device_connect_worker.h"
+#include <algorithm>
+#include "hilog_wrapper.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+DeviceConnectWorker::DeviceConnectWorker(size_t maxConcurrency) : maxConcurrency_(std::max<size_t>(maxConcurrency, 1))
+{
+}
+
+DeviceConnectWorker::~DeviceConnectWorker()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    workCond_.notify_all();
+    idleCond_.notify_all();
+    for (auto &worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void DeviceConnectWorker::Request(const std::shared_ptr<Device> &device, const std::string &bundleInfo, bool reconnect)
+{
+    if (device == nullptr || !device->SetConnectTarget(bundleInfo, reconnect)) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stop_) {
+        EDM_LOGE(MODULE_DEV_MGR, "connect worker is stopped");
+        return;
+    }
+    queue_.push_back(device);
+    // workers are started as the queue grows beyond the waiting ones
+    if (queue_.size() > waiting_ && workers_.size() < maxConcurrency_) {
+        workers_.emplace_back(&DeviceConnectWorker::WorkLoop, this);
+    }
+    workCond_.notify_one();
+}
+
+void DeviceConnectWorker::WaitIdle()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    idleCond_.wait(lock, [this] { return stop_ || (queue_.empty() && running_ == 0); });
+}
+
+bool DeviceConnectWorker::TakeDevice(std::shared_ptr<Device> &device, std::string &bundleInfo)
+{
+    for (auto it = queue_.begin(); it != queue_.end();) {
+        std::string nextBundleInfo = (*it)->GetNextConnectStep();
+        if (nextBundleInfo.empty()) {
+            it = queue_.erase(it);
+            continue;
+        }
+        if (busyBundles_.count(Device::GetBundleName(nextBundleInfo)) == 0) {
+            device = std::move(*it);
+            queue_.erase(it);
+            bundleInfo = std::move(nextBundleInfo);
+            return true;
+        }
+        ++it;
+    }
+    return false;
+}
+
+void DeviceConnectWorker::WorkLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_) {
+        std::shared_ptr<Device> device;
+        std::string bundleInfo;
+        if (!TakeDevice(device, bundleInfo)) {
+            if (queue_.empty() && running_ == 0) {
+                idleCond_.notify_all();
+            }
+            // woken by new requests and by finished steps, which may free the bundle of a queued device
+            ++waiting_;
+            workCond_.wait(lock);
+            --waiting_;
+            continue;
+        }
+
+        std::string bundleName = Device::GetBundleName(bundleInfo);
+        busyBundles_.insert(bundleName);
+        ++running_;
+        lock.unlock();
+        device->RunConnectStep(bundleInfo);
+        lock.lock();
+        busyBundles_.erase(bundleName);
+        --running_;
+        // the device goes to the back of the queue for its next step, which lets the other bundles have their turn
+        queue_.push_back(std::move(device));
+        workCond_.notify_all();
+    }
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
@@ -26,9 +26,13 @@
 namespace OHOS {
 namespace ExternalDeviceManager {
 constexpr uint32_t UNLOAD_SA_TIMER_INTERVAL = 30 * 1000;
+// driver extensions of different bundles started at the same time
+constexpr size_t MAX_CONCURRENT_CONNECTS = 4;
 std::string Device::stiching_ = "_stiching_";
 IMPLEMENT_SINGLE_INSTANCE(ExtDeviceManager);
 
+ExtDeviceManager::ExtDeviceManager() : connectWorker_(MAX_CONCURRENT_CONNECTS) {}
+
 ExtDeviceManager::~ExtDeviceManager()
 {
     unloadSelftimer_.Unregister(unloadSelftimerId_);
@@ -61,7 +65,7 @@ int32_t ExtDeviceManager::Init()
     return EDM_OK;
 }
 
-int32_t ExtDeviceManager::AddDevIdOfBundleInfoMap(shared_ptr<Device> device, string &bundleInfo)
+int32_t ExtDeviceManager::AddDevIdOfBundleInfoMap(shared_ptr<Device> device, string &bundleInfo, bool reconnect)
 {
     if (bundleInfo.empty() || device == nullptr) {
         EDM_LOGE(MODULE_DEV_MGR, "bundleInfo or device is null");
@@ -87,13 +91,7 @@ int32_t ExtDeviceManager::AddDevIdOfBundleInfoMap(shared_ptr<Device> device, str
     }
 
     // start ability
-    int32_t ret = device->Connect();
-    if (ret != EDM_OK) {
-        EDM_LOGE(MODULE_DEV_MGR,
-            "deviceId[%{public}016" PRIX64 "] connect driver extension ability[%{public}s] failed[%{public}d]",
-            deviceId, Device::GetAbilityName(bundleInfo).c_str(), ret);
-        return EDM_NOK;
-    }
+    connectWorker_.Request(device, bundleInfo, reconnect);
     PrintMatchDriverMap();
     return EDM_OK;
 }
@@ -126,13 +124,7 @@ int32_t ExtDeviceManager::RemoveDevIdOfBundleInfoMap(shared_ptr<Device> device,
     bundleMatchMap_.erase(pos);
 
     // stop ability and destory sa
-    int32_t ret = device->Disconnect();
-    if (ret != EDM_OK) {
-        EDM_LOGE(MODULE_DEV_MGR,
-            "deviceId[%{public}016" PRIX64 "] disconnect driver extension ability[%{public}s] failed[%{public}d]",
-            deviceId, Device::GetAbilityName(bundleInfo).c_str(), ret);
-        return ret;
-    }
+    connectWorker_.Request(device, "");
     PrintMatchDriverMap();
     return EDM_OK;
 }
@@ -143,22 +135,38 @@ int32_t ExtDeviceManager::RemoveAllDevIdOfBundleInfoMap(shared_ptr<Device> devic
         EDM_LOGE(MODULE_DEV_MGR, "device is null");
         return EDM_ERR_INVALID_PARAM;
     }
-    // update bundle info
+    // update bundle info, the first device of the bundle erases it for all of them
     lock_guard<mutex> lock(bundleMatchMapMutex_);
-    auto pos = bundleMatchMap_.find(bundleInfo);
-    if (pos == bundleMatchMap_.end()) {
-        return EDM_OK;
+    bundleMatchMap_.erase(bundleInfo);
+    // stop ability and destory sa
+    connectWorker_.Request(device, "");
+    return EDM_OK;
+}
+
+void ExtDeviceManager::AddDevIdOfMatchKeyMap(shared_ptr<DeviceInfo> devInfo)
+{
+    uint64_t matchKey = 0;
+    if (!DriverPkgManager::GetInstance().QueryDeviceMatchKey(devInfo, matchKey)) {
+        EDM_LOGD(MODULE_DEV_MGR, "deviceId %{public}016" PRIX64 " has no match key", devInfo->GetDeviceId());
+        return;
     }
+    matchKeyMap_[matchKey].emplace(devInfo->GetDeviceId());
+}
 
-    bundleMatchMap_.erase(pos);
-    // stop ability and destory sa
-    int32_t ret = device->Disconnect();
-    if (ret != EDM_OK) {
-        EDM_LOGE(MODULE_DEV_MGR, "disconnect driver extension ability[%{public}s] failed[%{public}d]",
-            Device::GetAbilityName(bundleInfo).c_str(), ret);
-        return ret;
+void ExtDeviceManager::RemoveDevIdOfMatchKeyMap(shared_ptr<DeviceInfo> devInfo)
+{
+    uint64_t matchKey = 0;
+    if (!DriverPkgManager::GetInstance().QueryDeviceMatchKey(devInfo, matchKey)) {
+        return;
+    }
+    auto pos = matchKeyMap_.find(matchKey);
+    if (pos == matchKeyMap_.end()) {
+        return;
+    }
+    pos->second.erase(devInfo->GetDeviceId());
+    if (pos->second.empty()) {
+        matchKeyMap_.erase(pos);
     }
-    return EDM_OK;
 }
 
 int32_t ExtDeviceManager::AddBundleInfo(enum BusType busType, const string &bundleName, const string &abilityName)
@@ -173,7 +181,12 @@ int32_t ExtDeviceManager::AddBundleInfo(enum BusType busType, const string &bund
         return EDM_ERR_INVALID_PARAM;
     }
 
-    // iterate over device, find bundleInfo and ability status
+    vector<uint64_t> matchKeys;
+    if (!DriverPkgManager::GetInstance().QueryDriverMatchKeys(bundleName, abilityName, matchKeys)) {
+        EDM_LOGE(MODULE_DEV_MGR, "bundle[%{public}s] match keys not found", bundleName.c_str());
+        return EDM_OK;
+    }
+
     lock_guard<mutex> lock(deviceMapMutex_);
 
     // find device
@@ -185,25 +198,32 @@ int32_t ExtDeviceManager::AddBundleInfo(enum BusType busType, const string &bund
     string bundleInfo = bundleName + Device::GetStiching() + abilityName;
     unordered_map<uint64_t, shared_ptr<Device>> &map = deviceMap_[busType];
 
-    for (auto iter : map) {
-        shared_ptr<Device> device = iter.second;
-
-        // iterate over device by bustype
-        auto bundleInfoNames = DriverPkgManager::GetInstance().QueryMatchDriver(device->GetDeviceInfo());
-        if (bundleInfoNames == nullptr) {
-            EDM_LOGD(MODULE_DEV_MGR, "deviceId[%{public}016" PRIX64 "], not find driver",
-                device->GetDeviceInfo()->GetDeviceId());
+    // only the devices sharing a match key with the driver are visited
+    for (uint64_t matchKey : matchKeys) {
+        auto keyIter = matchKeyMap_.find(matchKey);
+        if (keyIter == matchKeyMap_.end()) {
             continue;
         }
+        for (uint64_t deviceId : keyIter->second) {
+            auto deviceIter = map.find(deviceId);
+            if (deviceIter == map.end()) {
+                continue;
+            }
+            shared_ptr<Device> device = deviceIter->second;
+            // a device keeps the driver it is already bound to
+            if (device->HasDriver() && bundleInfo.compare(device->GetBundleInfo()) != 0) {
+                EDM_LOGD(MODULE_DEV_MGR, "deviceId[%{public}016" PRIX64 "] has driver[%{public}s]", deviceId,
+                    device->GetBundleInfo().c_str());
+                continue;
+            }
 
-        if (bundleName.compare(bundleInfoNames->bundleName) == 0 &&
-            abilityName.compare(bundleInfoNames->abilityName) == 0) {
             device->AddBundleInfo(bundleInfo);
-            int32_t ret = AddDevIdOfBundleInfoMap(device, bundleInfo);
+            // a device still connected to the bundle, as after an update, is connected again to run the new driver
+            int32_t ret = AddDevIdOfBundleInfoMap(device, bundleInfo, true);
             if (ret != EDM_OK) {
                 EDM_LOGE(MODULE_DEV_MGR,
                     "deviceId[%{public}016" PRIX64 "] start driver extension ability[%{public}s] fail[%{public}d]",
-                    device->GetDeviceInfo()->GetDeviceId(), Device::GetAbilityName(bundleInfo).c_str(), ret);
+                    deviceId, Device::GetAbilityName(bundleInfo).c_str(), ret);
             }
         }
     }
@@ -229,14 +249,25 @@ int32_t ExtDeviceManager::RemoveBundleInfo(enum BusType busType, const string &b
         return EDM_OK;
     }
 
-    // iterate over device, remove bundleInfo
+    // the driver matching table holds every device bound to the bundle
     string bundleInfo = bundleName + Device::GetStiching() + abilityName;
     unordered_map<uint64_t, shared_ptr<Device>> &deviceMap = deviceMap_[busType];
+    unordered_set<uint64_t> deviceIds;
+    {
+        lock_guard<mutex> matchLock(bundleMatchMapMutex_);
+        auto pos = bundleMatchMap_.find(bundleInfo);
+        if (pos != bundleMatchMap_.end()) {
+            deviceIds = pos->second;
+        }
+    }
 
-    for (auto iter : deviceMap) {
-        shared_ptr<Device> device = iter.second;
+    for (uint64_t deviceId : deviceIds) {
+        auto deviceIter = deviceMap.find(deviceId);
+        if (deviceIter == deviceMap.end()) {
+            continue;
+        }
+        shared_ptr<Device> device = deviceIter->second;
 
-        // iterate over device by bustype
         if (bundleInfo.compare(device->GetBundleInfo()) == 0) {
             device->RemoveBundleInfo(); // update device
             int32_t ret = RemoveAllDevIdOfBundleInfoMap(device, bundleInfo);
@@ -307,10 +338,56 @@ int32_t ExtDeviceManager::UpdateBundleStatusCallback(
 
 int32_t ExtDeviceManager::RegisterDevice(shared_ptr<DeviceInfo> devInfo)
 {
+    return UpdateDevices({}, {devInfo});
+}
+
+int32_t ExtDeviceManager::UnRegisterDevice(const shared_ptr<DeviceInfo> devInfo)
+{
+    return UpdateDevices({devInfo}, {});
+}
+
+int32_t ExtDeviceManager::UpdateDevices(
+    const vector<shared_ptr<DeviceInfo>> &removedDevInfos, const vector<shared_ptr<DeviceInfo>> &addedDevInfos)
+{
+    int32_t ret = EDM_OK;
+    bool changed = false;
+    lock_guard<mutex> lock(deviceMapMutex_);
+    for (auto &devInfo : removedDevInfos) {
+        int32_t removeRet = RemoveDevice(devInfo, changed);
+        if (removeRet != EDM_OK) {
+            ret = removeRet;
+        }
+    }
+
+    vector<shared_ptr<Device>> devices;
+    for (auto &devInfo : addedDevInfos) {
+        shared_ptr<Device> device = AddDevice(devInfo, changed);
+        if (device != nullptr) {
+            devices.push_back(device);
+        }
+    }
+    if (changed) {
+        PublishDeviceSnapshot();
+    }
+
+    if (!addedDevInfos.empty()) {
+        unloadSelftimer_.Unregister(unloadSelftimerId_);
+    } else if (changed) {
+        UnLoadSelf();
+    }
+
+    if (MatchAndConnectDevices(devices) != EDM_OK) {
+        ret = EDM_NOK;
+    }
+    return ret;
+}
+
+shared_ptr<Device> ExtDeviceManager::AddDevice(shared_ptr<DeviceInfo> devInfo, bool &changed)
+{
+    // Please call with deviceMapMutex_ held.
     BusType type = devInfo->GetBusType();
     uint64_t deviceId = devInfo->GetDeviceId();
     shared_ptr<Device> device;
-    lock_guard<mutex> lock(deviceMapMutex_);
     if (deviceMap_.find(type) != deviceMap_.end()) {
         unordered_map<uint64_t, shared_ptr<Device>> &map = deviceMap_[type];
         if (map.find(deviceId) != map.end()) {
@@ -318,9 +395,9 @@ int32_t ExtDeviceManager::RegisterDevice(shared_ptr<DeviceInfo> devInfo)
             // device has been registered and do not need to connect again
             if (device->GetDrvExtRemote() != nullptr) {
                 EDM_LOGI(MODULE_DEV_MGR, "device has been registered, deviceId is %{public}016" PRIx64 "", deviceId);
-                return EDM_OK;
+                return nullptr;
             }
-            // device has been registered and need to connect
+            // device has been registered and need to connect, the connect worker reconnects a disconnected one
             EDM_LOGI(MODULE_DEV_MGR, "device has been registered, deviceId is %{public}016" PRIx64 "", deviceId);
         }
     }
@@ -329,55 +406,30 @@ int32_t ExtDeviceManager::RegisterDevice(shared_ptr<DeviceInfo> devInfo)
     if (device == nullptr) {
         device = make_shared<Device>(devInfo);
         deviceMap_[type].emplace(deviceId, device);
+        AddDevIdOfMatchKeyMap(devInfo);
+        changed = true;
         EDM_LOGI(MODULE_DEV_MGR, "successfully registered device, deviceId = %{public}016" PRIx64 "", deviceId);
     }
-    // driver match
-    std::string bundleInfo = device->GetBundleInfo();
-    // if device does not have a matching driver, match driver here
-    if (bundleInfo.empty()) {
-        auto bundleInfoNames = DriverPkgManager::GetInstance().QueryMatchDriver(devInfo);
-        if (bundleInfoNames != nullptr) {
-            bundleInfo = bundleInfoNames->bundleName + Device::GetStiching() + bundleInfoNames->abilityName;
-            device->AddBundleInfo(bundleInfo);
-        }
-    }
-    unloadSelftimer_.Unregister(unloadSelftimerId_);
-
-    // match driver failed, waitting to install driver package
-    if (bundleInfo.empty()) {
-        EDM_LOGD(MODULE_DEV_MGR,
-            "deviceId %{public}016" PRIX64 "match driver failed, waitting to install ext driver package", deviceId);
-        return EDM_OK;
-    }
-
-    int32_t ret = AddDevIdOfBundleInfoMap(device, bundleInfo);
-    if (ret != EDM_OK) {
-        EDM_LOGE(MODULE_DEV_MGR, "deviceId[%{public}016" PRIX64 "] update bundle info map failed[%{public}d]", deviceId,
-            ret);
-        return EDM_NOK;
-    }
-    EDM_LOGI(MODULE_DEV_MGR, "successfully match driver[%{public}s], deviceId is %{public}016" PRIx64 "",
-        bundleInfo.c_str(), deviceId);
-
-    return ret;
+    return device;
 }
 
-int32_t ExtDeviceManager::UnRegisterDevice(const shared_ptr<DeviceInfo> devInfo)
+int32_t ExtDeviceManager::RemoveDevice(shared_ptr<DeviceInfo> devInfo, bool &changed)
 {
+    // Please call with deviceMapMutex_ held.
     BusType type = devInfo->GetBusType();
     uint64_t deviceId = devInfo->GetDeviceId();
     shared_ptr<Device> device;
     string bundleInfo;
 
-    lock_guard<mutex> lock(deviceMapMutex_);
     if (deviceMap_.find(type) != deviceMap_.end()) {
         unordered_map<uint64_t, shared_ptr<Device>> &map = deviceMap_[type];
         if (map.find(deviceId) != map.end()) {
             device = map[deviceId];
             bundleInfo = map[deviceId]->GetBundleInfo();
             map.erase(deviceId);
+            RemoveDevIdOfMatchKeyMap(device->GetDeviceInfo());
+            changed = true;
             EDM_LOGI(MODULE_DEV_MGR, "successfully unregistered device, deviceId is %{public}016" PRIx64 "", deviceId);
-            UnLoadSelf();
         }
     }
 
@@ -399,23 +451,79 @@ int32_t ExtDeviceManager::UnRegisterDevice(const shared_ptr<DeviceInfo> devInfo)
     return EDM_OK;
 }
 
-vector<shared_ptr<DeviceInfo>> ExtDeviceManager::QueryDevice(const BusType busType)
+int32_t ExtDeviceManager::MatchAndConnectDevices(const vector<shared_ptr<Device>> &devices)
 {
-    vector<shared_ptr<DeviceInfo>> devInfoVec;
+    // Please call with deviceMapMutex_ held. Devices without driver are matched in one pass over the drivers.
+    vector<shared_ptr<DeviceInfo>> unmatchedDevInfos;
+    for (auto &device : devices) {
+        if (device->GetBundleInfo().empty()) {
+            unmatchedDevInfos.push_back(device->GetDeviceInfo());
+        }
+    }
+    vector<shared_ptr<BundleInfoNames>> bundleInfoNames;
+    if (!unmatchedDevInfos.empty()) {
+        bundleInfoNames = DriverPkgManager::GetInstance().QueryMatchDrivers(unmatchedDevInfos);
+    }
+
+    int32_t ret = EDM_OK;
+    size_t unmatchedIndex = 0;
+    for (auto &device : devices) {
+        uint64_t deviceId = device->GetDeviceInfo()->GetDeviceId();
+        // driver match
+        std::string bundleInfo = device->GetBundleInfo();
+        // if device does not have a matching driver, match driver here
+        if (bundleInfo.empty()) {
+            auto &names = bundleInfoNames[unmatchedIndex++];
+            if (names != nullptr) {
+                bundleInfo = names->bundleName + Device::GetStiching() + names->abilityName;
+                device->AddBundleInfo(bundleInfo);
+            }
+        }
 
-    lock_guard<mutex> lock(deviceMapMutex_);
-    if (deviceMap_.find(busType) == deviceMap_.end()) {
-        EDM_LOGE(MODULE_DEV_MGR, "no device is found and busType %{public}d is invalid", busType);
-        return devInfoVec;
+        // match driver failed, waitting to install driver package
+        if (bundleInfo.empty()) {
+            EDM_LOGD(MODULE_DEV_MGR,
+                "deviceId %{public}016" PRIX64 "match driver failed, waitting to install ext driver package", deviceId);
+            continue;
+        }
+
+        if (AddDevIdOfBundleInfoMap(device, bundleInfo) != EDM_OK) {
+            EDM_LOGE(MODULE_DEV_MGR, "deviceId[%{public}016" PRIX64 "] update bundle info map failed", deviceId);
+            ret = EDM_NOK;
+            continue;
+        }
+        EDM_LOGI(MODULE_DEV_MGR, "successfully match driver[%{public}s], deviceId is %{public}016" PRIx64 "",
+            bundleInfo.c_str(), deviceId);
     }
+    return ret;
+}
 
-    unordered_map<uint64_t, shared_ptr<Device>> map = deviceMap_[busType];
-    for (auto device : map) {
-        devInfoVec.emplace_back(device.second->GetDeviceInfo());
+vector<shared_ptr<DeviceInfo>> ExtDeviceManager::QueryDevice(const BusType busType)
+{
+    shared_ptr<const DeviceSnapshot> snapshot = atomic_load(&deviceSnapshot_);
+    auto iter = snapshot->deviceInfos.find(busType);
+    if (iter == snapshot->deviceInfos.end()) {
+        EDM_LOGE(MODULE_DEV_MGR, "no device is found and busType %{public}d is invalid", busType);
+        return {};
     }
-    EDM_LOGD(MODULE_DEV_MGR, "find %{public}zu device of busType %{public}d", devInfoVec.size(), busType);
 
-    return devInfoVec;
+    EDM_LOGD(MODULE_DEV_MGR, "find %{public}zu device of busType %{public}d", iter->second.size(), busType);
+    return iter->second;
+}
+
+void ExtDeviceManager::PublishDeviceSnapshot(void)
+{
+    // Please call with deviceMapMutex_ held, so that snapshots are published in the order of the changes.
+    auto snapshot = make_shared<DeviceSnapshot>();
+    snapshot->devices = deviceMap_;
+    for (auto &[busType, devices] : deviceMap_) {
+        vector<shared_ptr<DeviceInfo>> &devInfoVec = snapshot->deviceInfos[busType];
+        devInfoVec.reserve(devices.size());
+        for (auto &[_, device] : devices) {
+            devInfoVec.emplace_back(device->GetDeviceInfo());
+        }
+    }
+    atomic_store(&deviceSnapshot_, shared_ptr<const DeviceSnapshot>(move(snapshot)));
 }
 
 size_t ExtDeviceManager::GetTotalDeviceNum(void) const
@@ -462,8 +570,9 @@ std::shared_ptr<Device> ExtDeviceManager::QueryDeviceByDeviceID(uint64_t deviceI
 {
     BusType busType = *reinterpret_cast<BusType *>(&deviceId);
     EDM_LOGI(MODULE_DEV_MGR, "the busType: %{public}d", static_cast<uint32_t>(busType));
-    auto deviceMapIter = deviceMap_.find(busType);
-    if (deviceMapIter == deviceMap_.end()) {
+    shared_ptr<const DeviceSnapshot> snapshot = atomic_load(&deviceSnapshot_);
+    auto deviceMapIter = snapshot->devices.find(busType);
+    if (deviceMapIter == snapshot->devices.end()) {
         EDM_LOGE(MODULE_DEV_MGR, "can not find device by %{public}d busType", static_cast<uint32_t>(busType));
         return nullptr;
     }
@@ -482,25 +591,52 @@ std::shared_ptr<Device> ExtDeviceManager::QueryDeviceByDeviceID(uint64_t deviceI
 int32_t ExtDeviceManager::ConnectDevice(uint64_t deviceId, const sptr<IDriverExtMgrCallback> &connectCallback)
 {
     // find device by deviceId
-    lock_guard<mutex> lock(deviceMapMutex_);
     std::shared_ptr<Device> device = QueryDeviceByDeviceID(deviceId);
     if (device == nullptr) {
         EDM_LOGI(MODULE_DEV_MGR, "failed to find device with %{public}016" PRIX64 " deviceId", deviceId);
         return EDM_NOK;
     }
-    return device->Connect(connectCallback);
+
+    if (!device->HasDriver()) {
+        EDM_LOGE(MODULE_DEV_MGR, "deviceId %{public}016" PRIX64 " has no driver", deviceId);
+        return EDM_NOK;
+    }
+    int32_t ret = device->RegisterConnectCallback(connectCallback);
+    if (ret != EDM_OK) {
+        return ret;
+    }
+
+    {
+        // the connect worker makes the connection like any other, the lock keeps a bundle removal from slipping in
+        // between reading the driver of the device and the request
+        lock_guard<mutex> lock(deviceMapMutex_);
+        string bundleInfo = device->GetBundleInfo();
+        if (!bundleInfo.empty()) {
+            connectWorker_.Request(device, bundleInfo);
+            return EDM_OK;
+        }
+    }
+    // the driver was removed after the check above, the callback would never be told about a connection
+    EDM_LOGE(MODULE_DEV_MGR, "deviceId %{public}016" PRIX64 " lost its driver", deviceId);
+    device->UnregisterConnectCallback(connectCallback);
+    return EDM_NOK;
 }
 
 int32_t ExtDeviceManager::DisConnectDevice(uint64_t deviceId)
 {
-    lock_guard<mutex> lock(deviceMapMutex_);
     std::shared_ptr<Device> device = QueryDeviceByDeviceID(deviceId);
     if (device == nullptr) {
         EDM_LOGI(MODULE_DEV_MGR, "failed to find device with %{public}016" PRIX64 " deviceId", deviceId);
         return EDM_NOK;
     }
+    if (!device->HasDriver() && !device->HasConnection()) {
+        EDM_LOGE(MODULE_DEV_MGR, "deviceId %{public}016" PRIX64 " has no driver and no connection", deviceId);
+        return EDM_NOK;
+    }
 
-    return device->Disconnect();
+    lock_guard<mutex> lock(deviceMapMutex_);
+    connectWorker_.Request(device, "");
+    return EDM_OK;
 }
 } // namespace ExternalDeviceManager
 } // namespace OHOS
\ No newline at end of file
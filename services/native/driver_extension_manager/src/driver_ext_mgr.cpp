@@ -27,6 +27,8 @@
 
 namespace OHOS {
 namespace ExternalDeviceManager {
+// a hub enumerates its devices one after another, this covers a hub of a couple of dozen devices
+constexpr uint32_t DEV_CHANGE_BATCH_WINDOW_MS = 100;
 const bool G_REGISTER_RESULT =
     SystemAbility::MakeAndRegisterAbility(DelayedSingleton<DriverExtMgr>::GetInstance().get());
 
@@ -46,7 +48,7 @@ void DriverExtMgr::OnStart()
     if (ret != EDM_OK) {
         EDM_LOGE(MODULE_SERVICE, "ExtDeviceManager Init failed %{public}d", ret);
     }
-    std::shared_ptr<DevChangeCallback> callback = std::make_shared<DevChangeCallback>();
+    std::shared_ptr<DevChangeCallback> callback = std::make_shared<DevChangeCallback>(DEV_CHANGE_BATCH_WINDOW_MS);
     ret = BusExtensionCore::GetInstance().Init(callback);
     if (ret != EDM_OK) {
         EDM_LOGE(MODULE_SERVICE, "BusExtensionCore Init failed %{public}d", ret);
@@ -86,48 +86,100 @@ int32_t DriverPkgManager::Init()
 shared_ptr<BundleInfoNames> DriverPkgManager::QueryMatchDriver(shared_ptr<DeviceInfo> devInfo)
 {
     EDM_LOGE(MODULE_PKG_MGR, "Enter QueryMatchDriver");
-    shared_ptr<IBusExtension> extInstance = nullptr;
-    auto ret = make_shared<BundleInfoNames>();
-    ret->bundleName.clear();
-    ret->abilityName.clear();
+    return QueryMatchDrivers({devInfo})[0];
+}
 
+vector<shared_ptr<BundleInfoNames>> DriverPkgManager::QueryMatchDrivers(const vector<shared_ptr<DeviceInfo>> &devInfos)
+{
+    vector<shared_ptr<BundleInfoNames>> ret(devInfos.size());
     if (bundleStateCallback_ == nullptr) {
         EDM_LOGE(MODULE_PKG_MGR, "QueryMatchDriver bundleStateCallback_ null");
-        return nullptr;
+        return ret;
     }
 
     std::map<string, DriverInfo> drvInfos_;
     if (!bundleStateCallback_->GetAllDriverInfos(drvInfos_)) {
         EDM_LOGE(MODULE_PKG_MGR, "QueryMatchDriver GetAllDriverInfos Err");
-        return nullptr;
+        return ret;
     }
 
     if (drvInfos_.empty()) {
         EDM_LOGE(MODULE_PKG_MGR, "QueryMatchDriver drvInfos_ Empty");
-        return nullptr;
+        return ret;
     }
 
-    for (auto [key, val] : drvInfos_) {
-        extInstance = BusExtensionCore::GetInstance().GetBusExtensionByName(val.GetBusName());
+    // the drivers are read once for all devices
+    vector<pair<const string *, DriverInfo *>> drivers;
+    vector<shared_ptr<IBusExtension>> extInstances;
+    for (auto &[key, val] : drvInfos_) {
+        shared_ptr<IBusExtension> extInstance = BusExtensionCore::GetInstance().GetBusExtensionByName(val.GetBusName());
         if (extInstance == nullptr) {
             EDM_LOGE(MODULE_PKG_MGR, "QueryMatchDriver GetInstance at bus:%{public}s", val.GetBusName().c_str());
             continue;
         }
+        drivers.emplace_back(&key, &val);
+        extInstances.push_back(extInstance);
+    }
 
-        if (extInstance->MatchDriver(val, *devInfo)) {
-            string bundleName = key;
-            ret->bundleName = bundleName.substr(0, bundleName.find_first_of(bundleStateCallback_->GetStiching()));
-            ret->abilityName = bundleName.substr(bundleName.find_last_of(bundleStateCallback_->GetStiching()) + 1);
-            return ret;
-        } else {
-            string drvInfoStr;
-            val.Serialize(drvInfoStr);
-            EDM_LOGE(MODULE_PKG_MGR, "PKG Serialize:%{public}s", drvInfoStr.c_str());
+    for (size_t i = 0; i < devInfos.size(); i++) {
+        for (size_t j = 0; j < drivers.size(); j++) {
+            DriverInfo &val = *drivers[j].second;
+            if (extInstances[j]->MatchDriver(val, *devInfos[i])) {
+                const string &bundleName = *drivers[j].first;
+                ret[i] = make_shared<BundleInfoNames>();
+                string stiching = bundleStateCallback_->GetStiching();
+                ret[i]->bundleName = bundleName.substr(0, bundleName.find_first_of(stiching));
+                ret[i]->abilityName = bundleName.substr(bundleName.find_last_of(stiching) + 1);
+                break;
+            } else {
+                string drvInfoStr;
+                val.Serialize(drvInfoStr);
+                EDM_LOGE(MODULE_PKG_MGR, "PKG Serialize:%{public}s", drvInfoStr.c_str());
+            }
+        }
+        if (ret[i] == nullptr) {
+            EDM_LOGE(MODULE_PKG_MGR, "QueryMatchDriver return null");
         }
     }
+    return ret;
+}
 
-    EDM_LOGE(MODULE_PKG_MGR, "QueryMatchDriver return null");
-    return nullptr;
+bool DriverPkgManager::QueryDeviceMatchKey(shared_ptr<DeviceInfo> devInfo, uint64_t &matchKey)
+{
+    if (devInfo == nullptr) {
+        return false;
+    }
+    shared_ptr<IBusExtension> extInstance =
+        BusExtensionCore::GetInstance().GetBusExtensionByType(devInfo->GetBusType());
+    if (extInstance == nullptr) {
+        return false;
+    }
+    return extInstance->GetDeviceMatchKey(*devInfo, matchKey);
+}
+
+bool DriverPkgManager::QueryDriverMatchKeys(
+    const string &bundleName, const string &abilityName, vector<uint64_t> &matchKeys)
+{
+    if (bundleStateCallback_ == nullptr) {
+        EDM_LOGE(MODULE_PKG_MGR, "QueryDriverMatchKeys bundleStateCallback_ null");
+        return false;
+    }
+
+    DriverInfo driverInfo;
+    if (!bundleStateCallback_->GetDriverInfo(bundleName + bundleStateCallback_->GetStiching() + abilityName,
+        driverInfo)) {
+        EDM_LOGE(MODULE_PKG_MGR, "QueryDriverMatchKeys %{public}s not found", bundleName.c_str());
+        return false;
+    }
+
+    shared_ptr<IBusExtension> extInstance =
+        BusExtensionCore::GetInstance().GetBusExtensionByName(driverInfo.GetBusName());
+    if (extInstance == nullptr) {
+        EDM_LOGE(MODULE_PKG_MGR, "QueryDriverMatchKeys GetInstance at bus:%{public}s", driverInfo.GetBusName().c_str());
+        return false;
+    }
+    matchKeys = extInstance->GetDriverMatchKeys(driverInfo);
+    return true;
 }
 
 int32_t DriverPkgManager::RegisterCallback(const sptr<IBundleStatusCallback> &callback)
@@ -160,6 +160,21 @@ bool DrvBundleStateCallback::GetAllDriverInfos(std::map<string, DriverInfo> &dri
     return true;
 }
 
+bool DrvBundleStateCallback::GetDriverInfo(const string &drvInfoKey, DriverInfo &driverInfo)
+{
+    if (!initOnce) {
+        std::map<string, DriverInfo> driverInfos;
+        (void)GetAllDriverInfos(driverInfos);
+    }
+
+    auto iter = allDrvInfos_.find(drvInfoKey);
+    if (iter == allDrvInfos_.end()) {
+        return false;
+    }
+    driverInfo = iter->second;
+    return true;
+}
+
 string DrvBundleStateCallback::GetStiching()
 {
     return stiching;
@@ -278,12 +293,13 @@ bool DrvBundleStateCallback::ParseBaseDriverInfo(int bundleStatus)
             continue;
         }
 
+        // the driver is visible to queries before the device manager is told about it
+        string drvInfoKey = bundleName + stiching + abilityName;
+        innerDrvInfos_[drvInfoKey] = tmpDrvInfo;
+        allDrvInfos_[drvInfoKey] = tmpDrvInfo;
         if (m_pFun != nullptr) {
             m_pFun(bundleStatus, BusType::BUS_TYPE_USB, bundleName, abilityName);
         }
-
-        bundleName += stiching + abilityName;
-        innerDrvInfos_[bundleName] = tmpDrvInfo;
         ret = true;
     }
     return ret;
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <vector>
+#include "usb_config_desc_image.h"
+#include "usb_config_desc_parser.h"
+#include "usb_ddk_benchmark_utils.h"
+#include "usb_ddk_descriptor_view.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+namespace {
+constexpr int64_t MIN_FRAME_COUNT = 16;
+constexpr int64_t MAX_FRAME_COUNT = 1024;
+
+void RunParse(benchmark::State &state, const std::vector<uint8_t> &configBuffer)
+{
+    AllocationStats begin = GetAllocationStats();
+    for (auto _ : state) {
+        UsbDdkConfigDescriptor *config = nullptr;
+        int32_t ret = ParseUsbConfigDescriptor(configBuffer, &config);
+        if (ret != 0) {
+            state.SkipWithError("parse failed");
+            break;
+        }
+        benchmark::DoNotOptimize(config);
+        FreeUsbConfigDescriptor(config);
+    }
+    ReportAllocations(state, begin);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(configBuffer.size()));
+    state.counters["descriptorBytes"] = static_cast<double>(configBuffer.size());
+}
+
+void BM_ParseConfig(benchmark::State &state, UsbCorpusDevice device)
+{
+    RunParse(state, BuildCorpusConfig(device));
+}
+
+void BM_ParseUvcConfig(benchmark::State &state)
+{
+    RunParse(state, BuildUvcConfig(static_cast<uint32_t>(state.range(0))));
+}
+
+// Maps the image of a configuration, as a driver instance does for a device model that has been parsed before.
+void BM_MapConfigImage(benchmark::State &state, UsbCorpusDevice device)
+{
+    std::vector<uint8_t> configBuffer = BuildCorpusConfig(device);
+    FILE *file = tmpfile();
+    if (file == nullptr || WriteUsbConfigImage(fileno(file), configBuffer) != 0) {
+        state.SkipWithError("write image failed");
+        if (file != nullptr) {
+            (void)fclose(file);
+        }
+        return;
+    }
+    AllocationStats begin = GetAllocationStats();
+    for (auto _ : state) {
+        UsbConfigImage image = {};
+        if (MapUsbConfigImage(fileno(file), image) != 0) {
+            state.SkipWithError("map image failed");
+            break;
+        }
+        benchmark::DoNotOptimize(image.config);
+        UnmapUsbConfigImage(image.config);
+    }
+    ReportAllocations(state, begin);
+    (void)fclose(file);
+}
+
+// Indexes a configuration and parses only the interface a driver uses, to compare with parsing all of it.
+void BM_ParseInterfaceLazily(benchmark::State &state, UsbCorpusDevice device, uint8_t interfaceNumber)
+{
+    std::vector<uint8_t> configBuffer = BuildCorpusConfig(device);
+    AllocationStats begin = GetAllocationStats();
+    for (auto _ : state) {
+        std::unique_ptr<UsbDdkDescriptorView> view;
+        const UsbDdkInterface *usbInterface = nullptr;
+        if (UsbDdkDescriptorView::Create(configBuffer.data(), configBuffer.size(), view) != 0 ||
+            view->GetParsedInterface(interfaceNumber, usbInterface) != 0 || usbInterface == nullptr) {
+            state.SkipWithError("parse failed");
+            break;
+        }
+        benchmark::DoNotOptimize(usbInterface);
+    }
+    ReportAllocations(state, begin);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(configBuffer.size()));
+}
+} // namespace
+
+BENCHMARK_CAPTURE(BM_ParseConfig, hid, UsbCorpusDevice::HID);
+BENCHMARK_CAPTURE(BM_ParseConfig, uvc, UsbCorpusDevice::UVC);
+BENCHMARK_CAPTURE(BM_ParseConfig, uac, UsbCorpusDevice::UAC);
+BENCHMARK_CAPTURE(BM_ParseConfig, cdc, UsbCorpusDevice::CDC);
+BENCHMARK_CAPTURE(BM_ParseConfig, msc, UsbCorpusDevice::MSC);
+BENCHMARK_CAPTURE(BM_ParseConfig, composite, UsbCorpusDevice::COMPOSITE);
+BENCHMARK_CAPTURE(BM_MapConfigImage, uvc, UsbCorpusDevice::UVC);
+BENCHMARK_CAPTURE(BM_MapConfigImage, composite, UsbCorpusDevice::COMPOSITE);
+BENCHMARK_CAPTURE(BM_ParseInterfaceLazily, composite_hid, UsbCorpusDevice::COMPOSITE, 8);
+BENCHMARK_CAPTURE(BM_ParseInterfaceLazily, composite_msc, UsbCorpusDevice::COMPOSITE, 7);
+BENCHMARK(BM_ParseUvcConfig)->RangeMultiplier(2)->Range(MIN_FRAME_COUNT, MAX_FRAME_COUNT);
+} // namespace ExternalDeviceManager
+} // namespace OHOS
+
+BENCHMARK_MAIN();
@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "usb_ddk_api.h"
+#include "usb_ddk_benchmark_utils.h"
+#include "v1_0/usb_ddk_service.h"
+
+namespace OHOS {
+namespace HDI {
+namespace Usb {
+namespace Ddk {
+namespace V1_0 {
+namespace {
+constexpr uint32_t CONTROL_READ_LENGTH = 18;
+constexpr uint32_t MAX_CONFIG_INDEX = 1;
+
+// Serves the descriptor corpus from memory, the device id selects the corpus device. Transfers complete at once, so
+// the benchmarks measure the cost of the DDK shim and not of the device.
+class FakeUsbDdk : public IUsbDdk {
+public:
+    int32_t Init() override
+    {
+        return 0;
+    }
+    int32_t Release() override
+    {
+        return 0;
+    }
+    int32_t GetDeviceDescriptor(uint64_t deviceId, UsbDeviceDescriptor &desc) override
+    {
+        desc = {};
+        desc.bLength = sizeof(desc);
+        desc.bDescriptorType = 0x01;
+        desc.bNumConfigurations = MAX_CONFIG_INDEX;
+        return 0;
+    }
+    int32_t GetConfigDescriptor(uint64_t deviceId, uint8_t configIndex, std::vector<uint8_t> &configDesc) override
+    {
+        if (configIndex > MAX_CONFIG_INDEX) {
+            return -1;
+        }
+        configDesc = ExternalDeviceManager::BuildCorpusConfig(
+            static_cast<ExternalDeviceManager::UsbCorpusDevice>(deviceId));
+        return configDesc.empty() ? -1 : 0;
+    }
+    int32_t ClaimInterface(uint64_t deviceId, uint8_t interfaceIndex, uint64_t &interfaceHandle) override
+    {
+        interfaceHandle = (deviceId << 8) | interfaceIndex;
+        return 0;
+    }
+    int32_t ReleaseInterface(uint64_t interfaceHandle) override
+    {
+        return 0;
+    }
+    int32_t SelectInterfaceSetting(uint64_t interfaceHandle, uint8_t settingIndex) override
+    {
+        return 0;
+    }
+    int32_t GetCurrentInterfaceSetting(uint64_t interfaceHandle, uint8_t &settingIndex) override
+    {
+        settingIndex = 0;
+        return 0;
+    }
+    int32_t SendControlReadRequest(uint64_t interfaceHandle, const UsbControlRequestSetup &setup, uint32_t timeout,
+        std::vector<uint8_t> &data) override
+    {
+        data.assign(CONTROL_READ_LENGTH, 0);
+        return 0;
+    }
+    int32_t SendControlWriteRequest(uint64_t interfaceHandle, const UsbControlRequestSetup &setup, uint32_t timeout,
+        const std::vector<uint8_t> &data) override
+    {
+        return 0;
+    }
+    int32_t SendPipeRequest(const UsbRequestPipe &pipe, uint32_t size, uint32_t offset, uint32_t length,
+        uint32_t &transferedLength) override
+    {
+        transferedLength = length;
+        return 0;
+    }
+    int32_t GetDeviceMemMapFd(uint64_t deviceId, int &fd) override
+    {
+        fd = -1;
+        return -1;
+    }
+};
+} // namespace
+
+// Replaces the proxy of the DDK service for the benchmark process.
+sptr<IUsbDdk> IUsbDdk::Get(bool isStub)
+{
+    return new FakeUsbDdk();
+}
+} // namespace V1_0
+} // namespace Ddk
+} // namespace Usb
+} // namespace HDI
+
+namespace ExternalDeviceManager {
+namespace {
+constexpr uint32_t PIPE_BUFFER_SIZE = 4096;
+constexpr uint8_t CONTROL_BUFFER_SIZE = 64;
+
+void BM_GetDeviceDescriptor(benchmark::State &state)
+{
+    OH_Usb_Init();
+    UsbDeviceDescriptor desc = {};
+    AllocationStats begin = GetAllocationStats();
+    for (auto _ : state) {
+        int32_t ret = OH_Usb_GetDeviceDescriptor(static_cast<uint64_t>(UsbCorpusDevice::HID), &desc);
+        benchmark::DoNotOptimize(ret);
+    }
+    ReportAllocations(state, begin);
+    OH_Usb_Release();
+}
+
+void BM_GetConfigDescriptor(benchmark::State &state, UsbCorpusDevice device)
+{
+    OH_Usb_Init();
+    AllocationStats begin = GetAllocationStats();
+    for (auto _ : state) {
+        UsbDdkConfigDescriptor *config = nullptr;
+        if (OH_Usb_GetConfigDescriptor(static_cast<uint64_t>(device), 1, &config) != 0) {
+            state.SkipWithError("get config descriptor failed");
+            break;
+        }
+        benchmark::DoNotOptimize(config);
+        OH_Usb_FreeConfigDescriptor(config);
+    }
+    ReportAllocations(state, begin);
+    OH_Usb_Release();
+}
+
+void BM_ClaimReleaseInterface(benchmark::State &state)
+{
+    OH_Usb_Init();
+    AllocationStats begin = GetAllocationStats();
+    for (auto _ : state) {
+        uint64_t interfaceHandle = 0;
+        OH_Usb_ClaimInterface(static_cast<uint64_t>(UsbCorpusDevice::HID), 0, &interfaceHandle);
+        OH_Usb_ReleaseInterface(interfaceHandle);
+    }
+    ReportAllocations(state, begin);
+    OH_Usb_Release();
+}
+
+void BM_SendControlReadRequest(benchmark::State &state)
+{
+    OH_Usb_Init();
+    UsbControlRequestSetup setup = {0x80, 0x06, 0x0100, 0x0000, CONTROL_BUFFER_SIZE};
+    uint8_t data[CONTROL_BUFFER_SIZE] = {0};
+    AllocationStats begin = GetAllocationStats();
+    for (auto _ : state) {
+        uint32_t dataLen = sizeof(data);
+        if (OH_Usb_SendControlReadRequest(0, &setup, 0, data, &dataLen) != 0) {
+            state.SkipWithError("control read failed");
+            break;
+        }
+    }
+    ReportAllocations(state, begin);
+    OH_Usb_Release();
+}
+
+void BM_SendPipeRequest(benchmark::State &state)
+{
+    OH_Usb_Init();
+    std::vector<uint8_t> buffer(PIPE_BUFFER_SIZE);
+    UsbDeviceMemMap devMmap = {buffer.data(), PIPE_BUFFER_SIZE, 0, PIPE_BUFFER_SIZE, 0};
+    UsbRequestPipe pipe = {0, 0, 0x81};
+    AllocationStats begin = GetAllocationStats();
+    for (auto _ : state) {
+        if (OH_Usb_SendPipeRequest(&pipe, &devMmap) != 0) {
+            state.SkipWithError("pipe request failed");
+            break;
+        }
+    }
+    ReportAllocations(state, begin);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * PIPE_BUFFER_SIZE);
+    OH_Usb_Release();
+}
+} // namespace
+
+BENCHMARK(BM_GetDeviceDescriptor);
+BENCHMARK_CAPTURE(BM_GetConfigDescriptor, hid, UsbCorpusDevice::HID);
+BENCHMARK_CAPTURE(BM_GetConfigDescriptor, uvc, UsbCorpusDevice::UVC);
+BENCHMARK_CAPTURE(BM_GetConfigDescriptor, uac, UsbCorpusDevice::UAC);
+BENCHMARK_CAPTURE(BM_GetConfigDescriptor, cdc, UsbCorpusDevice::CDC);
+BENCHMARK_CAPTURE(BM_GetConfigDescriptor, msc, UsbCorpusDevice::MSC);
+BENCHMARK_CAPTURE(BM_GetConfigDescriptor, composite, UsbCorpusDevice::COMPOSITE);
+BENCHMARK(BM_ClaimReleaseInterface);
+BENCHMARK(BM_SendControlReadRequest);
+BENCHMARK(BM_SendPipeRequest);
+} // namespace ExternalDeviceManager
+} // namespace OHOS
+
+BENCHMARK_MAIN();
@@ -0,0 +1,307 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "usb_ddk_benchmark_utils.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+std::atomic<uint64_t> g_allocationCount {0};
+std::atomic<uint64_t> g_allocationBytes {0};
+
+void *CountedAlloc(std::size_t size)
+{
+    g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    g_allocationBytes.fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void *CountedAllocOrThrow(std::size_t size)
+{
+    void *ptr = CountedAlloc(size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+} // namespace
+
+void *operator new(std::size_t size)
+{
+    return CountedAllocOrThrow(size);
+}
+
+void *operator new[](std::size_t size)
+{
+    return CountedAllocOrThrow(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    return CountedAlloc(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    return CountedAlloc(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept
+{
+    std::free(ptr);
+}
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+namespace {
+constexpr uint8_t USB_DT_INTERFACE_ASSOCIATION = 0x0b;
+constexpr uint8_t USB_DT_CS_INTERFACE = 0x24;
+constexpr uint8_t USB_DT_CS_ENDPOINT = 0x25;
+constexpr uint8_t UVC_UNIT_COUNT = 8;
+constexpr uint8_t UVC_ALT_SETTING_COUNT = 6;
+constexpr uint32_t UVC_FRAMES_PER_FORMAT = 32;
+constexpr uint32_t CORPUS_UVC_FRAME_COUNT = 32;
+constexpr uint8_t ENDPOINT_BULK = 0x02;
+constexpr uint8_t ENDPOINT_INTERRUPT = 0x03;
+constexpr uint8_t ENDPOINT_ISO_ASYNC = 0x05;
+constexpr uint8_t ENDPOINT_ISO_ADAPTIVE = 0x09;
+
+void Append(std::vector<uint8_t> &config, std::initializer_list<uint8_t> desc)
+{
+    config.insert(config.end(), desc);
+}
+
+// Appends a class-specific descriptor of the given length, which is all the parser looks at.
+void AppendClassSpecific(std::vector<uint8_t> &config, uint8_t length, uint8_t type, uint8_t subtype)
+{
+    config.push_back(length);
+    config.push_back(type);
+    config.push_back(subtype);
+    config.insert(config.end(), length - 3, 0);
+}
+
+void AppendAssociation(std::vector<uint8_t> &config, uint8_t firstInterface, uint8_t count, uint8_t functionClass,
+    uint8_t functionSubClass)
+{
+    Append(config, {0x08, USB_DT_INTERFACE_ASSOCIATION, firstInterface, count, functionClass, functionSubClass, 0x00,
+        0x00});
+}
+
+void AppendInterface(std::vector<uint8_t> &config, uint8_t number, uint8_t alternateSetting, uint8_t numEndpoints,
+    std::initializer_list<uint8_t> classSubClassProtocol)
+{
+    Append(config, {0x09, 0x04, number, alternateSetting, numEndpoints});
+    config.insert(config.end(), classSubClassProtocol);
+    config.push_back(0x00);
+}
+
+void AppendEndpoint(
+    std::vector<uint8_t> &config, uint8_t address, uint8_t attributes, uint16_t maxPacketSize, uint8_t interval)
+{
+    Append(config, {0x07, 0x05, address, attributes, static_cast<uint8_t>(maxPacketSize & 0xff),
+        static_cast<uint8_t>(maxPacketSize >> 8), interval});
+}
+
+// Appends a video control interface with a chain of units and a video streaming interface, whose alternate setting 0
+// carries the formats and frames, followed by isochronous alternate settings.
+void AppendUvcFunction(std::vector<uint8_t> &config, uint8_t firstInterface, uint32_t frameCount)
+{
+    AppendAssociation(config, firstInterface, 0x02, 0x0e, 0x03);
+    AppendInterface(config, firstInterface, 0x00, 0x01, {0x0e, 0x01, 0x00});
+    AppendClassSpecific(config, 0x0d, USB_DT_CS_INTERFACE, 0x01);
+    AppendClassSpecific(config, 0x12, USB_DT_CS_INTERFACE, 0x02);
+    for (uint8_t i = 0; i < UVC_UNIT_COUNT; ++i) {
+        AppendClassSpecific(config, 0x1b, USB_DT_CS_INTERFACE, 0x06);
+    }
+    AppendClassSpecific(config, 0x09, USB_DT_CS_INTERFACE, 0x03);
+    AppendEndpoint(config, 0x83, ENDPOINT_INTERRUPT, 0x10, 0x06);
+    AppendClassSpecific(config, 0x05, USB_DT_CS_ENDPOINT, 0x03);
+
+    uint8_t streaming = firstInterface + 1;
+    AppendInterface(config, streaming, 0x00, 0x00, {0x0e, 0x02, 0x00});
+    uint32_t formatCount = (frameCount + UVC_FRAMES_PER_FORMAT - 1) / UVC_FRAMES_PER_FORMAT;
+    AppendClassSpecific(config, static_cast<uint8_t>(0x0d + formatCount), USB_DT_CS_INTERFACE, 0x01);
+    for (uint32_t frame = 0; frame < frameCount; ++frame) {
+        if (frame % UVC_FRAMES_PER_FORMAT == 0) {
+            AppendClassSpecific(config, 0x1b, USB_DT_CS_INTERFACE, 0x04);
+        }
+        AppendClassSpecific(config, 0x1e, USB_DT_CS_INTERFACE, 0x05);
+        if (frame % UVC_FRAMES_PER_FORMAT == UVC_FRAMES_PER_FORMAT - 1 || frame == frameCount - 1) {
+            AppendClassSpecific(config, 0x06, USB_DT_CS_INTERFACE, 0x0d);
+        }
+    }
+    for (uint8_t alt = 1; alt <= UVC_ALT_SETTING_COUNT; ++alt) {
+        AppendInterface(config, streaming, alt, 0x01, {0x0e, 0x02, 0x00});
+        AppendEndpoint(config, 0x81, ENDPOINT_ISO_ASYNC, static_cast<uint16_t>(alt) << 8, 0x01);
+    }
+}
+
+// Appends a streaming interface of an audio function: an idle alternate setting and one with an audio endpoint.
+void AppendUacStreaming(std::vector<uint8_t> &config, uint8_t number, uint8_t endpoint)
+{
+    AppendInterface(config, number, 0x00, 0x00, {0x01, 0x02, 0x00});
+    AppendInterface(config, number, 0x01, 0x01, {0x01, 0x02, 0x00});
+    AppendClassSpecific(config, 0x07, USB_DT_CS_INTERFACE, 0x01);
+    AppendClassSpecific(config, 0x0b, USB_DT_CS_INTERFACE, 0x02);
+    Append(config, {0x09, 0x05, endpoint, ENDPOINT_ISO_ADAPTIVE, 0xc0, 0x00, 0x01, 0x00, 0x00});
+    AppendClassSpecific(config, 0x07, USB_DT_CS_ENDPOINT, 0x01);
+}
+
+// Appends an audio control interface with a speaker and a microphone terminal chain, and their streaming interfaces.
+void AppendUacFunction(std::vector<uint8_t> &config, uint8_t firstInterface)
+{
+    AppendAssociation(config, firstInterface, 0x03, 0x01, 0x00);
+    AppendInterface(config, firstInterface, 0x00, 0x00, {0x01, 0x01, 0x00});
+    AppendClassSpecific(config, 0x0a, USB_DT_CS_INTERFACE, 0x01);
+    for (uint8_t i = 0; i < 0x02; ++i) {
+        AppendClassSpecific(config, 0x0c, USB_DT_CS_INTERFACE, 0x02);
+        AppendClassSpecific(config, 0x0a, USB_DT_CS_INTERFACE, 0x06);
+        AppendClassSpecific(config, 0x09, USB_DT_CS_INTERFACE, 0x03);
+    }
+    AppendUacStreaming(config, firstInterface + 1, 0x04);
+    AppendUacStreaming(config, firstInterface + 2, 0x85);
+}
+
+void AppendHidFunction(std::vector<uint8_t> &config, uint8_t number, uint8_t endpoint)
+{
+    AppendInterface(config, number, 0x00, 0x01, {0x03, 0x01, 0x02});
+    Append(config, {0x09, 0x21, 0x11, 0x01, 0x00, 0x01, 0x22, 0x3e, 0x00});
+    AppendEndpoint(config, endpoint, ENDPOINT_INTERRUPT, 0x08, 0x0a);
+}
+
+// Appends an abstract control model communication interface with its functional descriptors, and a data interface.
+void AppendCdcFunction(std::vector<uint8_t> &config, uint8_t firstInterface)
+{
+    AppendAssociation(config, firstInterface, 0x02, 0x02, 0x02);
+    AppendInterface(config, firstInterface, 0x00, 0x01, {0x02, 0x02, 0x01});
+    AppendClassSpecific(config, 0x05, USB_DT_CS_INTERFACE, 0x00);
+    AppendClassSpecific(config, 0x05, USB_DT_CS_INTERFACE, 0x01);
+    AppendClassSpecific(config, 0x04, USB_DT_CS_INTERFACE, 0x02);
+    AppendClassSpecific(config, 0x05, USB_DT_CS_INTERFACE, 0x06);
+    AppendEndpoint(config, 0x86, ENDPOINT_INTERRUPT, 0x08, 0x10);
+    AppendInterface(config, firstInterface + 1, 0x00, 0x02, {0x0a, 0x00, 0x00});
+    AppendEndpoint(config, 0x07, ENDPOINT_BULK, 0x0200, 0x00);
+    AppendEndpoint(config, 0x87, ENDPOINT_BULK, 0x0200, 0x00);
+}
+
+void AppendMscFunction(std::vector<uint8_t> &config, uint8_t number)
+{
+    AppendInterface(config, number, 0x00, 0x02, {0x08, 0x06, 0x50});
+    AppendEndpoint(config, 0x88, ENDPOINT_BULK, 0x0400, 0x00);
+    Append(config, {0x06, 0x30, 0x0f, 0x00, 0x00, 0x00});
+    AppendEndpoint(config, 0x09, ENDPOINT_BULK, 0x0400, 0x00);
+    Append(config, {0x06, 0x30, 0x0f, 0x00, 0x00, 0x00});
+}
+
+std::vector<uint8_t> StartConfig()
+{
+    return {0x09, 0x02, 0x00, 0x00, 0x00, 0x01, 0x00, 0x80, 0xfa};
+}
+
+void FinishConfig(std::vector<uint8_t> &config, uint8_t numInterfaces)
+{
+    config[2] = static_cast<uint8_t>(config.size() & 0xff);
+    config[3] = static_cast<uint8_t>(config.size() >> 8);
+    config[4] = numInterfaces;
+}
+} // namespace
+
+std::vector<uint8_t> BuildUvcConfig(uint32_t frameCount)
+{
+    std::vector<uint8_t> config = StartConfig();
+    AppendUvcFunction(config, 0x00, frameCount);
+    FinishConfig(config, 0x02);
+    return config;
+}
+
+std::vector<uint8_t> BuildCorpusConfig(UsbCorpusDevice device)
+{
+    std::vector<uint8_t> config = StartConfig();
+    switch (device) {
+        case UsbCorpusDevice::HID:
+            AppendHidFunction(config, 0x00, 0x81);
+            FinishConfig(config, 0x01);
+            break;
+        case UsbCorpusDevice::UVC:
+            return BuildUvcConfig(CORPUS_UVC_FRAME_COUNT);
+        case UsbCorpusDevice::UAC:
+            AppendUacFunction(config, 0x00);
+            AppendHidFunction(config, 0x03, 0x81);
+            FinishConfig(config, 0x04);
+            break;
+        case UsbCorpusDevice::CDC:
+            AppendCdcFunction(config, 0x00);
+            FinishConfig(config, 0x02);
+            break;
+        case UsbCorpusDevice::MSC:
+            AppendMscFunction(config, 0x00);
+            FinishConfig(config, 0x01);
+            break;
+        case UsbCorpusDevice::COMPOSITE:
+            AppendUvcFunction(config, 0x00, CORPUS_UVC_FRAME_COUNT);
+            AppendUacFunction(config, 0x02);
+            AppendCdcFunction(config, 0x05);
+            AppendMscFunction(config, 0x07);
+            AppendHidFunction(config, 0x08, 0x8a);
+            FinishConfig(config, 0x09);
+            break;
+        default:
+            return {};
+    }
+    return config;
+}
+
+AllocationStats GetAllocationStats()
+{
+    return {g_allocationCount.load(std::memory_order_relaxed), g_allocationBytes.load(std::memory_order_relaxed)};
+}
+
+void ReportAllocations(benchmark::State &state, const AllocationStats &begin)
+{
+    AllocationStats end = GetAllocationStats();
+    state.counters["allocs/op"] =
+        benchmark::Counter(static_cast<double>(end.count - begin.count), benchmark::Counter::kAvgIterations);
+    state.counters["bytes/op"] =
+        benchmark::Counter(static_cast<double>(end.bytes - begin.bytes), benchmark::Counter::kAvgIterations);
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef USB_DDK_BENCHMARK_UTILS_H
+#define USB_DDK_BENCHMARK_UTILS_H
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <vector>
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+// Configuration descriptors modelled on real devices.
+enum class UsbCorpusDevice {
+    // boot mouse: one interrupt endpoint behind a HID descriptor
+    HID,
+    // camera: video control and video streaming interfaces with 32 frames and isochronous alternate settings
+    UVC,
+    // headset: audio control, speaker and microphone streaming interfaces with audio endpoints, and a HID interface
+    UAC,
+    // serial port: communication interface with functional descriptors and a data interface
+    CDC,
+    // SuperSpeed mass storage: bulk endpoints followed by endpoint companion descriptors
+    MSC,
+    // camera, headset, serial port and mass storage functions of one device, each behind an association descriptor
+    COMPOSITE,
+};
+
+std::vector<uint8_t> BuildCorpusConfig(UsbCorpusDevice device);
+// Builds a camera configuration whose streaming interface carries frameCount frame descriptors.
+std::vector<uint8_t> BuildUvcConfig(uint32_t frameCount);
+
+// Counts the calls of operator new in the benchmark process.
+struct AllocationStats {
+    uint64_t count;
+    uint64_t bytes;
+};
+
+AllocationStats GetAllocationStats();
+// Reports the allocations since begin as the allocs/op and bytes/op counters of the benchmark.
+void ReportAllocations(benchmark::State &state, const AllocationStats &begin);
+} // namespace ExternalDeviceManager
+} // namespace OHOS
+#endif // USB_DDK_BENCHMARK_UTILS_H
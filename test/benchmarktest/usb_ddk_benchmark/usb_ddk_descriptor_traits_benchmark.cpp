@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "securec.h"
+#include "usb_ddk_descriptor_traits.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+namespace {
+constexpr uint32_t INTERFACE_COUNT = 64;
+constexpr uint32_t ENDPOINTS_PER_INTERFACE = 2;
+
+enum LegacyDescriptorType {
+    LEGACY_CONFIG_DESCRIPTOR_TYPE,
+    LEGACY_INTERFACE_DESCRIPTOR_TYPE,
+    LEGACY_ENDPOINT_DESCRIPTOR_TYPE,
+};
+
+// The decoder the parser used before the descriptor traits: the length is looked up at run time, the descriptor is
+// copied with memcpy_s, and the 16-bit fields are swapped in a second switch.
+uint16_t LegacyLe16ToHost(uint16_t number)
+{
+    uint8_t *addr = reinterpret_cast<uint8_t *>(&number);
+    return static_cast<uint16_t>(addr[1] << 8) | addr[0];
+}
+
+int32_t LegacyGetDescriptorLength(LegacyDescriptorType descriptorType)
+{
+    switch (descriptorType) {
+        case LEGACY_CONFIG_DESCRIPTOR_TYPE:
+            return UsbDescriptorTraits<UsbConfigDescriptor>::MIN_LENGTH;
+        case LEGACY_INTERFACE_DESCRIPTOR_TYPE:
+            return UsbDescriptorTraits<UsbInterfaceDescriptor>::MIN_LENGTH;
+        case LEGACY_ENDPOINT_DESCRIPTOR_TYPE:
+            return UsbDescriptorTraits<UsbEndpointDescriptor>::MIN_LENGTH;
+        default:
+            break;
+    }
+    return INT32_MAX;
+}
+
+int32_t LegacyParseDescriptor(
+    LegacyDescriptorType descriptorType, uint8_t *dest, uint32_t destLen, const uint8_t *source, int32_t sourceLen)
+{
+    int32_t descriptorLen = LegacyGetDescriptorLength(descriptorType);
+    if (descriptorLen == INT32_MAX || sourceLen < descriptorLen) {
+        return -1;
+    }
+    if (memcpy_s(dest, destLen, source, descriptorLen) != EOK) {
+        return -1;
+    }
+    switch (descriptorType) {
+        case LEGACY_CONFIG_DESCRIPTOR_TYPE: {
+            auto desc = reinterpret_cast<UsbConfigDescriptor *>(dest);
+            desc->wTotalLength = LegacyLe16ToHost(desc->wTotalLength);
+            break;
+        }
+        case LEGACY_INTERFACE_DESCRIPTOR_TYPE:
+            break;
+        case LEGACY_ENDPOINT_DESCRIPTOR_TYPE: {
+            auto desc = reinterpret_cast<UsbEndpointDescriptor *>(dest);
+            desc->wMaxPacketSize = LegacyLe16ToHost(desc->wMaxPacketSize);
+            break;
+        }
+        default:
+            return -1;
+    }
+    return 0;
+}
+
+// One configuration with interfaces of two bulk endpoints each.
+std::vector<uint8_t> BuildConfig()
+{
+    std::vector<uint8_t> config = {0x09, 0x02, 0x00, 0x00, INTERFACE_COUNT, 0x01, 0x00, 0x80, 0x32};
+    for (uint32_t i = 0; i < INTERFACE_COUNT; ++i) {
+        config.insert(config.end(),
+            {0x09, 0x04, static_cast<uint8_t>(i), 0x00, ENDPOINTS_PER_INTERFACE, 0xff, 0x00, 0x00, 0x00});
+        config.insert(config.end(), {0x07, 0x05, 0x81, 0x02, 0x00, 0x02, 0x00});
+        config.insert(config.end(), {0x07, 0x05, 0x02, 0x02, 0x00, 0x02, 0x00});
+    }
+    config[2] = static_cast<uint8_t>(config.size() & 0xff);
+    config[3] = static_cast<uint8_t>(config.size() >> 8);
+    return config;
+}
+
+struct Decoded {
+    UsbConfigDescriptor config;
+    UsbInterfaceDescriptor interface;
+    UsbEndpointDescriptor endpoint;
+};
+
+void BM_DecodeLegacy(benchmark::State &state)
+{
+    std::vector<uint8_t> configBuffer = BuildConfig();
+    Decoded decoded = {};
+    for (auto _ : state) {
+        const uint8_t *buffer = configBuffer.data();
+        int32_t size = static_cast<int32_t>(configBuffer.size());
+        while (size > 0) {
+            switch (buffer[1]) {
+                case UsbDescriptorTraits<UsbConfigDescriptor>::TYPE:
+                    LegacyParseDescriptor(LEGACY_CONFIG_DESCRIPTOR_TYPE, reinterpret_cast<uint8_t *>(&decoded.config),
+                        sizeof(decoded.config), buffer, size);
+                    break;
+                case UsbDescriptorTraits<UsbInterfaceDescriptor>::TYPE:
+                    LegacyParseDescriptor(LEGACY_INTERFACE_DESCRIPTOR_TYPE,
+                        reinterpret_cast<uint8_t *>(&decoded.interface), sizeof(decoded.interface), buffer, size);
+                    break;
+                default:
+                    LegacyParseDescriptor(LEGACY_ENDPOINT_DESCRIPTOR_TYPE,
+                        reinterpret_cast<uint8_t *>(&decoded.endpoint), sizeof(decoded.endpoint), buffer, size);
+                    break;
+            }
+            benchmark::DoNotOptimize(decoded);
+            size -= buffer[0];
+            buffer += buffer[0];
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(configBuffer.size()));
+}
+
+void BM_DecodeTraits(benchmark::State &state)
+{
+    std::vector<uint8_t> configBuffer = BuildConfig();
+    Decoded decoded = {};
+    for (auto _ : state) {
+        const uint8_t *buffer = configBuffer.data();
+        int32_t size = static_cast<int32_t>(configBuffer.size());
+        while (size > 0) {
+            switch (buffer[1]) {
+                case UsbDescriptorTraits<UsbConfigDescriptor>::TYPE:
+                    DecodeDescriptor(buffer, decoded.config);
+                    break;
+                case UsbDescriptorTraits<UsbInterfaceDescriptor>::TYPE:
+                    DecodeDescriptor(buffer, decoded.interface);
+                    break;
+                default:
+                    DecodeDescriptor(buffer, decoded.endpoint);
+                    break;
+            }
+            benchmark::DoNotOptimize(decoded);
+            size -= buffer[0];
+            buffer += buffer[0];
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(configBuffer.size()));
+}
+} // namespace
+
+BENCHMARK(BM_DecodeLegacy);
+BENCHMARK(BM_DecodeTraits);
+} // namespace ExternalDeviceManager
+} // namespace OHOS
+
+BENCHMARK_MAIN();
@@ -124,5 +124,37 @@ HWTEST_F(UsbBusExtensionTest, MatchDriverTest, TestSize.Level1)
     isMatched = usbBus->MatchDriver(*drvInfo, *deviceInfo);
     ASSERT_EQ(isMatched, false);
 }
+
+HWTEST_F(UsbBusExtensionTest, MatchKeyTest, TestSize.Level1)
+{
+    auto usbDrvInfo = make_shared<UsbDriverInfo>();
+    usbDrvInfo->pids_ = {0x1234, 0x5678};
+    usbDrvInfo->vids_ = {0x1111, 0x2222};
+    auto drvInfo = make_shared<DriverInfo>();
+    drvInfo->bus_ = "USB";
+    drvInfo->driverInfoExt_ = usbDrvInfo;
+    auto usbBus = make_shared<UsbBusExtension>();
+    vector<uint64_t> drvKeys = usbBus->GetDriverMatchKeys(*drvInfo);
+    ASSERT_EQ(drvKeys.size(), (size_t)4);
+
+    // a device matches the driver exactly when its key is one of the keys of the driver
+    UsbDeviceInfo deviceInfo(0);
+    for (uint16_t vid : {0x1111, 0x2222, 0x9999}) {
+        for (uint16_t pid : {0x1234, 0x5678, 0x9999}) {
+            deviceInfo.idVendor_ = vid;
+            deviceInfo.idProduct_ = pid;
+            uint64_t devKey = 0;
+            ASSERT_TRUE(usbBus->GetDeviceMatchKey(deviceInfo, devKey));
+            bool hasKey = find(drvKeys.begin(), drvKeys.end(), devKey) != drvKeys.end();
+            ASSERT_EQ(hasKey, usbBus->MatchDriver(*drvInfo, deviceInfo));
+        }
+    }
+
+    uint64_t devKey = 0;
+    deviceInfo.devInfo_.devBusInfo.busType = BusType::BUS_TYPE_INVALID;
+    ASSERT_FALSE(usbBus->GetDeviceMatchKey(deviceInfo, devKey));
+    drvInfo->bus_ = "HDMI";
+    ASSERT_TRUE(usbBus->GetDriverMatchKeys(*drvInfo).empty());
+}
 }
 }
@@ -139,6 +139,179 @@ HWTEST_F(DeviceManagerTest, QueryDeviceTest, TestSize.Level1)
     ASSERT_EQ(extMgr.deviceMap_[BusType::BUS_TYPE_TEST].size(), 0);
 }
 
+HWTEST_F(DeviceManagerTest, QueryDeviceSnapshotTest, TestSize.Level1)
+{
+    ExtDeviceManager &extMgr = ExtDeviceManager::GetInstance();
+    std::shared_ptr<DevChangeCallback> callback = std::make_shared<DevChangeCallback>();
+    std::shared_ptr<DeviceInfo> device0 = std::make_shared<DeviceInfo>(0);
+    device0->devInfo_.devBusInfo.busType = BusType::BUS_TYPE_TEST;
+    device0->devInfo_.devBusInfo.busDeviceId = 1;
+    int32_t ret = callback->OnDeviceAdd(device0);
+    ASSERT_EQ(ret, EDM_OK);
+    std::shared_ptr<Device> device = extMgr.QueryDeviceByDeviceID(device0->GetDeviceId());
+    ASSERT_NE(device, nullptr);
+    ASSERT_EQ(device->GetDeviceInfo(), device0);
+
+    // a query result is a snapshot, it does not change when a device is removed
+    std::vector<std::shared_ptr<DeviceInfo>> devVec = extMgr.QueryDevice(BUS_TYPE_TEST);
+    ASSERT_EQ(devVec.size(), 1);
+    ret = callback->OnDeviceRemove(device0);
+    ASSERT_EQ(ret, EDM_OK);
+    ASSERT_EQ(devVec.size(), 1);
+    ASSERT_EQ(devVec[0], device0);
+    ASSERT_EQ(extMgr.QueryDevice(BUS_TYPE_TEST).size(), 0);
+    ASSERT_EQ(extMgr.QueryDeviceByDeviceID(device0->GetDeviceId()), nullptr);
+}
+
+HWTEST_F(DeviceManagerTest, DisConnectDeviceTest, TestSize.Level1)
+{
+    ExtDeviceManager &extMgr = ExtDeviceManager::GetInstance();
+    std::shared_ptr<DevChangeCallback> callback = std::make_shared<DevChangeCallback>();
+    std::shared_ptr<DeviceInfo> devInfo = std::make_shared<DeviceInfo>(0);
+    devInfo->devInfo_.devBusInfo.busType = BusType::BUS_TYPE_TEST;
+    devInfo->devInfo_.devBusInfo.busDeviceId = 1;
+    ASSERT_EQ(callback->OnDeviceAdd(devInfo), EDM_OK);
+
+    // a device without driver and connection has nothing to disconnect
+    ASSERT_EQ(extMgr.DisConnectDevice(devInfo->GetDeviceId()), EDM_NOK);
+    ASSERT_EQ(callback->OnDeviceRemove(devInfo), EDM_OK);
+    ASSERT_EQ(extMgr.DisConnectDevice(devInfo->GetDeviceId()), EDM_NOK);
+}
+
+HWTEST_F(DeviceManagerTest, DeviceConnectWorkerTest, TestSize.Level1)
+{
+    std::shared_ptr<DeviceInfo> devInfo = std::make_shared<DeviceInfo>(0);
+    devInfo->devInfo_.devBusInfo.busType = BusType::BUS_TYPE_TEST;
+    devInfo->devInfo_.devBusInfo.busDeviceId = 1;
+    std::shared_ptr<Device> device = std::make_shared<Device>(devInfo);
+    // a device without connection that shall have none is not queued
+    ASSERT_FALSE(device->SetConnectTarget(""));
+    ASSERT_EQ(device->connState_, Device::ConnectState::IDLE);
+
+    // a request that is withdrawn before or while the worker handles it leaves the device disconnected
+    DeviceConnectWorker worker;
+    worker.Request(device, "testBundle" + Device::GetStiching() + "testAbility");
+    worker.Request(device, "");
+    worker.WaitIdle();
+    ASSERT_EQ(device->connState_, Device::ConnectState::IDLE);
+    ASSERT_TRUE(device->GetConnectedBundleInfo().empty());
+}
+
+HWTEST_F(DeviceManagerTest, DeviceReconnectTest, TestSize.Level1)
+{
+    std::shared_ptr<DeviceInfo> devInfo = std::make_shared<DeviceInfo>(0);
+    devInfo->devInfo_.devBusInfo.busType = BusType::BUS_TYPE_TEST;
+    devInfo->devInfo_.devBusInfo.busDeviceId = 1;
+    std::shared_ptr<Device> device = std::make_shared<Device>(devInfo);
+    std::string bundleInfo = "testBundle" + Device::GetStiching() + "testAbility";
+    // the device is connected by hand, so no driver extension is involved
+    device->connectedBundleInfo_ = bundleInfo;
+    ASSERT_FALSE(device->SetConnectTarget(bundleInfo));
+
+    // a bundle update withdraws the target and sets it again before the worker gets to the device
+    ASSERT_TRUE(device->SetConnectTarget(""));
+    ASSERT_FALSE(device->SetConnectTarget(bundleInfo, true));
+    // the connection is still taken down and made again
+    ASSERT_EQ(device->GetNextConnectStep(), bundleInfo);
+    device->RunConnectStep(bundleInfo);
+    ASSERT_TRUE(device->GetConnectedBundleInfo().empty());
+    ASSERT_EQ(device->GetNextConnectStep(), bundleInfo);
+    device->connectedBundleInfo_ = bundleInfo;
+    ASSERT_TRUE(device->GetNextConnectStep().empty());
+    ASSERT_EQ(device->connState_, Device::ConnectState::IDLE);
+
+    // an extension that went away by itself is connected again by the next request
+    device->OnDisconnect(EDM_OK);
+    ASSERT_TRUE(device->GetConnectedBundleInfo().empty());
+    ASSERT_TRUE(device->SetConnectTarget(bundleInfo));
+}
+
+HWTEST_F(DeviceManagerTest, DeviceConnectScheduleTest, TestSize.Level1)
+{
+    std::string bundleA = "bundleA" + Device::GetStiching() + "testAbility";
+    std::string bundleB = "bundleB" + Device::GetStiching() + "testAbility";
+    std::vector<std::shared_ptr<Device>> devices;
+    for (const std::string &bundleInfo : {bundleA, bundleA, bundleB}) {
+        std::shared_ptr<DeviceInfo> devInfo = std::make_shared<DeviceInfo>(0);
+        devInfo->devInfo_.devBusInfo.busType = BusType::BUS_TYPE_TEST;
+        devInfo->devInfo_.devBusInfo.busDeviceId = devices.size() + 1;
+        std::shared_ptr<Device> device = std::make_shared<Device>(devInfo);
+        ASSERT_TRUE(device->SetConnectTarget(bundleInfo));
+        devices.push_back(device);
+    }
+
+    // the queue is set up by hand, so no worker thread is started
+    DeviceConnectWorker worker(2);
+    worker.queue_.assign(devices.begin(), devices.end());
+    worker.busyBundles_.insert("bundleA");
+    std::shared_ptr<Device> device;
+    std::string bundleInfo;
+    // a device of another bundle passes the ones waiting for a busy bundle
+    ASSERT_TRUE(worker.TakeDevice(device, bundleInfo));
+    ASSERT_EQ(device, devices[2]);
+    ASSERT_EQ(bundleInfo, bundleB);
+    ASSERT_FALSE(worker.TakeDevice(device, bundleInfo));
+    ASSERT_EQ(worker.queue_.size(), 2);
+
+    worker.busyBundles_.clear();
+    ASSERT_TRUE(worker.TakeDevice(device, bundleInfo));
+    ASSERT_EQ(device, devices[0]);
+    ASSERT_EQ(bundleInfo, bundleA);
+
+    // a device whose target was withdrawn is dropped from the queue
+    devices[1]->targetBundleInfo_.clear();
+    ASSERT_FALSE(worker.TakeDevice(device, bundleInfo));
+    ASSERT_TRUE(worker.queue_.empty());
+    ASSERT_EQ(devices[1]->connState_, Device::ConnectState::IDLE);
+}
+
+HWTEST_F(DeviceManagerTest, DevChangeBatchTest, TestSize.Level1)
+{
+    ExtDeviceManager &extMgr = ExtDeviceManager::GetInstance();
+    // the window does not run out during the test, the batches are handed over by Flush
+    std::shared_ptr<DevChangeCallback> callback = std::make_shared<DevChangeCallback>(60 * 1000);
+    std::vector<std::shared_ptr<DeviceInfo>> devices;
+    for (uint32_t busDeviceId = 1; busDeviceId <= 3; busDeviceId++) {
+        std::shared_ptr<DeviceInfo> device = std::make_shared<DeviceInfo>(0);
+        device->devInfo_.devBusInfo.busType = BusType::BUS_TYPE_TEST;
+        device->devInfo_.devBusInfo.busDeviceId = busDeviceId;
+        ASSERT_EQ(callback->OnDeviceAdd(device), EDM_OK);
+        devices.push_back(device);
+    }
+    ASSERT_EQ(extMgr.deviceMap_[BusType::BUS_TYPE_TEST].size(), 0);
+
+    // the add and the remove of the same device cancel out
+    ASSERT_EQ(callback->OnDeviceRemove(devices[1]), EDM_OK);
+    ASSERT_EQ(callback->pendingChanges_[devices[1]->GetDeviceId()].added, nullptr);
+    ASSERT_EQ(callback->Flush(), EDM_OK);
+    ASSERT_EQ(extMgr.deviceMap_[BusType::BUS_TYPE_TEST].size(), 2);
+    ASSERT_EQ(extMgr.QueryDevice(BUS_TYPE_TEST).size(), 2);
+    ASSERT_EQ(extMgr.deviceMap_[BusType::BUS_TYPE_TEST].count(devices[1]->GetDeviceId()), 0);
+
+    for (auto &device : devices) {
+        ASSERT_EQ(callback->OnDeviceRemove(device), EDM_OK);
+    }
+    ASSERT_EQ(callback->Flush(), EDM_OK);
+    ASSERT_EQ(extMgr.deviceMap_[BusType::BUS_TYPE_TEST].size(), 0);
+}
+
+HWTEST_F(DeviceManagerTest, DevChangeDestroyTest, TestSize.Level1)
+{
+    ExtDeviceManager &extMgr = ExtDeviceManager::GetInstance();
+    std::shared_ptr<DeviceInfo> device = std::make_shared<DeviceInfo>(0);
+    device->devInfo_.devBusInfo.busType = BusType::BUS_TYPE_TEST;
+    device->devInfo_.devBusInfo.busDeviceId = 1;
+    std::shared_ptr<DevChangeCallback> callback = std::make_shared<DevChangeCallback>(60 * 1000);
+    ASSERT_EQ(callback->OnDeviceAdd(device), EDM_OK);
+    ASSERT_EQ(extMgr.deviceMap_[BusType::BUS_TYPE_TEST].size(), 0);
+
+    // a pending change is passed on when the callback goes away
+    callback = nullptr;
+    ASSERT_EQ(extMgr.deviceMap_[BusType::BUS_TYPE_TEST].count(device->GetDeviceId()), 1);
+    ASSERT_EQ(extMgr.UnRegisterDevice(device), EDM_OK);
+    ASSERT_EQ(extMgr.deviceMap_[BusType::BUS_TYPE_TEST].size(), 0);
+}
+
 HWTEST_F(DeviceManagerTest, GetBusExtensionByNameTest, TestSize.Level1)
 {
     BusExtensionCore &core = BusExtensionCore::GetInstance();
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <unistd.h>
+#include <vector>
+#include "edm_errors.h"
+#include "hilog_wrapper.h"
+#include "usb_config_desc_image.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+using namespace testing::ext;
+
+// one interface with a class-specific descriptor and an alternate setting with a bulk endpoint, followed by an
+// endpoint companion descriptor
+const std::vector<uint8_t> TEST_CONFIG = {
+    0x09, 0x02, 0x2d, 0x00, 0x01, 0x01, 0x00, 0x80, 0x32,
+    0x09, 0x04, 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00,
+    0x05, 0x24, 0x01, 0x00, 0x01,
+    0x09, 0x04, 0x00, 0x01, 0x01, 0xff, 0x00, 0x00, 0x00,
+    0x07, 0x05, 0x81, 0x02, 0x00, 0x04, 0x00,
+    0x06, 0x30, 0x0f, 0x00, 0x00, 0x00,
+};
+
+class UsbConfigDescImageTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        EDM_LOGD(MODULE_USB_DDK, "UsbConfigDescImageTest SetUp");
+        file_ = tmpfile();
+        ASSERT_NE(file_, nullptr);
+    }
+    void TearDown() override
+    {
+        EDM_LOGD(MODULE_USB_DDK, "UsbConfigDescImageTest TearDown");
+        if (file_ != nullptr) {
+            (void)fclose(file_);
+        }
+    }
+
+protected:
+    FILE *file_ {nullptr};
+};
+
+HWTEST_F(UsbConfigDescImageTest, MapImageTest, TestSize.Level1)
+{
+    int32_t fd = fileno(file_);
+    ASSERT_EQ(WriteUsbConfigImage(fd, TEST_CONFIG), EDM_OK);
+
+    UsbConfigImage image = {};
+    ASSERT_EQ(MapUsbConfigImage(fd, image), EDM_OK);
+    ASSERT_EQ(image.parseResult, 0);
+    ASSERT_EQ(std::vector<uint8_t>(image.raw, image.raw + image.rawLen), TEST_CONFIG);
+
+    UsbDdkConfigDescriptor *config = image.config;
+    ASSERT_EQ(config->configDescriptor.wTotalLength, TEST_CONFIG.size());
+    ASSERT_EQ(config->configDescriptor.bNumInterfaces, 1);
+    ASSERT_EQ(config->interface[0].numAltsetting, 2);
+    UsbDdkInterfaceDescriptor &first = config->interface[0].altsetting[0];
+    ASSERT_EQ(first.extraLength, 5);
+    ASSERT_EQ(first.extra[1], 0x24);
+    ASSERT_EQ(first.endPoint, nullptr);
+    UsbDdkInterfaceDescriptor &second = config->interface[0].altsetting[1];
+    ASSERT_EQ(second.interfaceDescriptor.bAlternateSetting, 1);
+    ASSERT_EQ(second.interfaceDescriptor.bNumEndpoints, 1);
+    ASSERT_EQ(second.endPoint[0].endpointDescriptor.bEndpointAddress, 0x81);
+    ASSERT_EQ(second.endPoint[0].endpointDescriptor.wMaxPacketSize, 0x400);
+    // extra descriptors point into the raw descriptors of the image
+    ASSERT_EQ(second.endPoint[0].extra, image.raw + TEST_CONFIG.size() - 6);
+    ASSERT_EQ(second.endPoint[0].extraLength, 6);
+
+    // an image is mapped any number of times, each mapping is relocated on its own
+    UsbConfigImage other = {};
+    ASSERT_EQ(MapUsbConfigImage(fd, other), EDM_OK);
+    ASSERT_NE(other.config, image.config);
+    ASSERT_EQ(other.config->interface[0].altsetting[1].endPoint[0].endpointDescriptor.bEndpointAddress, 0x81);
+    UnmapUsbConfigImage(other.config);
+    UnmapUsbConfigImage(image.config);
+}
+
+HWTEST_F(UsbConfigDescImageTest, InvalidImageTest, TestSize.Level1)
+{
+    int32_t fd = fileno(file_);
+    UsbConfigImage image = {};
+    ASSERT_EQ(MapUsbConfigImage(fd, image), USB_DDK_INVALID_OPERATION);
+
+    ASSERT_EQ(WriteUsbConfigImage(fd, std::vector<uint8_t> {0x09, 0x02}), USB_DDK_INVALID_OPERATION);
+    ASSERT_EQ(WriteUsbConfigImage(fd, TEST_CONFIG), EDM_OK);
+    off_t size = lseek(fd, 0, SEEK_END);
+    ASSERT_GT(size, 0);
+
+    // a flipped byte fails the checksum
+    uint8_t byte = 0;
+    ASSERT_EQ(pread(fd, &byte, sizeof(byte), size - 1), 1);
+    byte ^= 0xff;
+    ASSERT_EQ(pwrite(fd, &byte, sizeof(byte), size - 1), 1);
+    ASSERT_EQ(MapUsbConfigImage(fd, image), USB_DDK_INVALID_OPERATION);
+    byte ^= 0xff;
+    ASSERT_EQ(pwrite(fd, &byte, sizeof(byte), size - 1), 1);
+    ASSERT_EQ(MapUsbConfigImage(fd, image), EDM_OK);
+    UnmapUsbConfigImage(image.config);
+
+    // so does a truncated image
+    ASSERT_EQ(ftruncate(fd, size - 1), 0);
+    ASSERT_EQ(MapUsbConfigImage(fd, image), USB_DDK_INVALID_OPERATION);
+    ASSERT_EQ(MapUsbConfigImage(std::string("/nonexistent/usb.cfg"), image), USB_DDK_FAILED);
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
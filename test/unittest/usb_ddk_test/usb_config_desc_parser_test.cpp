@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "edm_errors.h"
+#include "hilog_wrapper.h"
+#include "usb_config_desc_parser.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+using namespace testing::ext;
+
+// two interfaces, each preceded by an interface association descriptor, with class-specific descriptors after the
+// interfaces and the endpoints, and an alternate setting on the second interface
+const std::vector<uint8_t> TEST_COMPOSITE_CONFIG = {
+    0x09, 0x02, 0x55, 0x00, 0x02, 0x01, 0x00, 0x80, 0x32,
+    0x08, 0x0b, 0x00, 0x01, 0x0e, 0x03, 0x00, 0x00,
+    0x09, 0x04, 0x00, 0x00, 0x01, 0x0e, 0x01, 0x00, 0x00,
+    0x05, 0x24, 0x01, 0x00, 0x01,
+    0x07, 0x05, 0x83, 0x03, 0x10, 0x00, 0x06,
+    0x05, 0x25, 0x03, 0x10, 0x00,
+    0x08, 0x0b, 0x01, 0x01, 0x0e, 0x03, 0x00, 0x00,
+    0x09, 0x04, 0x01, 0x00, 0x00, 0x0e, 0x02, 0x00, 0x00,
+    0x09, 0x04, 0x01, 0x01, 0x01, 0x0e, 0x02, 0x00, 0x00,
+    0x07, 0x05, 0x81, 0x05, 0x00, 0x04, 0x01,
+    0x06, 0x30, 0x00, 0x00, 0x00, 0x00,
+    0x03, 0x24, 0x02,
+};
+
+class UsbConfigDescParserTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        EDM_LOGD(MODULE_USB_DDK, "UsbConfigDescParserTest SetUp");
+    }
+    void TearDown() override
+    {
+        EDM_LOGD(MODULE_USB_DDK, "UsbConfigDescParserTest TearDown");
+    }
+};
+
+HWTEST_F(UsbConfigDescParserTest, ParseCompositeTest, TestSize.Level1)
+{
+    UsbDdkConfigDescriptor *config = nullptr;
+    ASSERT_EQ(ParseUsbConfigDescriptor(TEST_COMPOSITE_CONFIG, &config), 0);
+    ASSERT_NE(config, nullptr);
+    ASSERT_EQ(config->configDescriptor.wTotalLength, TEST_COMPOSITE_CONFIG.size());
+    ASSERT_EQ(config->configDescriptor.bNumInterfaces, 2);
+
+    ASSERT_EQ(config->extraLength, 8);
+    ASSERT_EQ(config->extra[1], 0x0b);
+
+    UsbDdkInterface &first = config->interface[0];
+    ASSERT_EQ(first.numAltsetting, 1);
+    ASSERT_EQ(first.altsetting[0].extraLength, 5);
+    ASSERT_EQ(first.altsetting[0].extra[1], 0x24);
+    ASSERT_EQ(first.altsetting[0].interfaceDescriptor.bNumEndpoints, 1);
+    UsbDdkEndpointDescriptor &interrupt = first.altsetting[0].endPoint[0];
+    ASSERT_EQ(interrupt.endpointDescriptor.bEndpointAddress, 0x83);
+    ASSERT_EQ(interrupt.endpointDescriptor.wMaxPacketSize, 0x10);
+    // everything up to the next interface belongs to the endpoint, including the second association descriptor
+    ASSERT_EQ(interrupt.extraLength, 13);
+    ASSERT_EQ(interrupt.extra[1], 0x25);
+    ASSERT_EQ(interrupt.extra[6], 0x0b);
+
+    UsbDdkInterface &second = config->interface[1];
+    ASSERT_EQ(second.numAltsetting, 2);
+    ASSERT_EQ(second.altsetting[0].endPoint, nullptr);
+    ASSERT_EQ(second.altsetting[1].interfaceDescriptor.bAlternateSetting, 1);
+    UsbDdkEndpointDescriptor &iso = second.altsetting[1].endPoint[0];
+    ASSERT_EQ(iso.endpointDescriptor.wMaxPacketSize, 0x400);
+    ASSERT_EQ(iso.extraLength, 9);
+    ASSERT_EQ(iso.extra[1], 0x30);
+    ASSERT_EQ(iso.extra[7], 0x24);
+    FreeUsbConfigDescriptor(config);
+}
+
+HWTEST_F(UsbConfigDescParserTest, ParseInvalidTest, TestSize.Level1)
+{
+    UsbDdkConfigDescriptor *config = nullptr;
+    std::vector<uint8_t> shortConfig(TEST_COMPOSITE_CONFIG.begin(), TEST_COMPOSITE_CONFIG.begin() + 5);
+    ASSERT_EQ(ParseUsbConfigDescriptor(shortConfig, &config), USB_DDK_INVALID_OPERATION);
+
+    // a configuration without interfaces
+    std::vector<uint8_t> emptyConfig(TEST_COMPOSITE_CONFIG.begin(), TEST_COMPOSITE_CONFIG.begin() + 9);
+    ASSERT_EQ(ParseUsbConfigDescriptor(emptyConfig, &config), USB_DDK_INVALID_OPERATION);
+
+    // an interface with more endpoints than allowed
+    std::vector<uint8_t> badConfig = TEST_COMPOSITE_CONFIG;
+    badConfig[21] = 0x21;
+    ASSERT_EQ(ParseUsbConfigDescriptor(badConfig, &config), USB_DDK_INVALID_OPERATION);
+    ASSERT_EQ(config, nullptr);
+}
+
+HWTEST_F(UsbConfigDescParserTest, ParseUnexpectedEndpointTest, TestSize.Level1)
+{
+    // the endpoint is not announced by the interface and its address looks like the interface number
+    const std::vector<uint8_t> configBuffer = {
+        0x09, 0x02, 0x19, 0x00, 0x01, 0x01, 0x00, 0x80, 0x32,
+        0x09, 0x04, 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00,
+        0x07, 0x05, 0x00, 0x02, 0x00, 0x02, 0x00,
+    };
+    UsbDdkConfigDescriptor *config = nullptr;
+    ASSERT_EQ(ParseUsbConfigDescriptor(configBuffer, &config), 7);
+    ASSERT_NE(config, nullptr);
+    ASSERT_EQ(config->interface[0].numAltsetting, 1);
+    FreeUsbConfigDescriptor(config);
+}
+
+HWTEST_F(UsbConfigDescParserTest, ParseTableTest, TestSize.Level1)
+{
+    std::vector<uint8_t> secondConfig = TEST_COMPOSITE_CONFIG;
+    secondConfig[5] = 0x03;
+    std::vector<const std::vector<uint8_t> *> configBuffers = {&TEST_COMPOSITE_CONFIG, &secondConfig};
+    UsbDdkConfigDescriptorTable *table = nullptr;
+    ASSERT_EQ(ParseUsbConfigDescriptorTable(configBuffers, &table), EDM_OK);
+    ASSERT_EQ(table->numConfigurations, 2);
+    ASSERT_EQ(table->configs[0], nullptr);
+    ASSERT_EQ(table->configs[2], nullptr);
+    ASSERT_NE(table->configs[1], nullptr);
+    ASSERT_NE(table->configs[3], nullptr);
+    ASSERT_EQ(table->configs[3]->configDescriptor.bConfigurationValue, 3);
+    ASSERT_EQ(table->configs[3]->interface[1].altsetting[1].endPoint[0].endpointDescriptor.wMaxPacketSize, 0x400);
+    ASSERT_EQ(table->configs[1]->extra[1], 0x0b);
+    FreeUsbConfigDescriptorTable(table);
+
+    std::vector<uint8_t> badConfig(TEST_COMPOSITE_CONFIG.begin(), TEST_COMPOSITE_CONFIG.begin() + 9);
+    configBuffers.push_back(&badConfig);
+    table = nullptr;
+    ASSERT_EQ(ParseUsbConfigDescriptorTable(configBuffers, &table), USB_DDK_INVALID_OPERATION);
+    ASSERT_EQ(table, nullptr);
+}
+
+// identical raw descriptors share one parsed configuration, which lives until its last reference is freed
+HWTEST_F(UsbConfigDescParserTest, InternTest, TestSize.Level1)
+{
+    UsbDdkConfigDescriptor *first = nullptr;
+    ASSERT_EQ(ParseUsbConfigDescriptor(TEST_COMPOSITE_CONFIG, &first), 0);
+    std::vector<uint8_t> sameConfig(TEST_COMPOSITE_CONFIG);
+    UsbDdkConfigDescriptor *second = nullptr;
+    ASSERT_EQ(ParseUsbConfigDescriptor(sameConfig, &second), 0);
+    ASSERT_EQ(first, second);
+
+    std::vector<uint8_t> otherConfig(TEST_COMPOSITE_CONFIG);
+    otherConfig[5] = 0x02;
+    UsbDdkConfigDescriptor *other = nullptr;
+    ASSERT_EQ(ParseUsbConfigDescriptor(otherConfig, &other), 0);
+    ASSERT_NE(other, first);
+    ASSERT_EQ(other->configDescriptor.bConfigurationValue, 0x02);
+    FreeUsbConfigDescriptor(other);
+
+    FreeUsbConfigDescriptor(first);
+    ASSERT_EQ(second->configDescriptor.wTotalLength, TEST_COMPOSITE_CONFIG.size());
+    ASSERT_EQ(second->interface[1].numAltsetting, 2);
+    FreeUsbConfigDescriptor(second);
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
@@ -0,0 +1,331 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#include "edm_errors.h"
+#include "hilog_wrapper.h"
+#include "usb_ddk_descriptor_cache.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+using namespace testing::ext;
+
+constexpr uint64_t TEST_DEVICE_ID = 1;
+constexpr uint8_t TEST_CONFIG_INDEX = 1;
+constexpr uint16_t TEST_VENDOR_ID = 0x1234;
+constexpr uint16_t TEST_PRODUCT_ID = 0x5678;
+
+// configuration with one interface and one bulk IN endpoint
+const std::vector<uint8_t> TEST_CONFIG = {
+    0x09, 0x02, 0x19, 0x00, 0x01, 0x01, 0x00, 0x80, 0x32,
+    0x09, 0x04, 0x00, 0x00, 0x01, 0xff, 0x00, 0x00, 0x00,
+    0x07, 0x05, 0x81, 0x02, 0x00, 0x02, 0x00,
+};
+
+class UsbDdkDescriptorCacheTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        EDM_LOGD(MODULE_USB_DDK, "UsbDdkDescriptorCacheTest SetUp");
+    }
+    void TearDown() override
+    {
+        EDM_LOGD(MODULE_USB_DDK, "UsbDdkDescriptorCacheTest TearDown");
+    }
+};
+
+HWTEST_F(UsbDdkDescriptorCacheTest, DeviceDescriptorTest, TestSize.Level1)
+{
+    UsbDdkDescriptorCache cache;
+    uint32_t loadCount = 0;
+    auto load = [&loadCount](UsbDeviceDescriptor &desc) {
+        ++loadCount;
+        desc.idVendor = TEST_VENDOR_ID;
+        return static_cast<int32_t>(EDM_OK);
+    };
+    UsbDeviceDescriptor desc = {};
+    ASSERT_EQ(cache.GetDeviceDescriptor(TEST_DEVICE_ID, desc, load), EDM_OK);
+    desc = {};
+    ASSERT_EQ(cache.GetDeviceDescriptor(TEST_DEVICE_ID, desc, load), EDM_OK);
+    ASSERT_EQ(desc.idVendor, TEST_VENDOR_ID);
+    ASSERT_EQ(loadCount, 1);
+
+    cache.Invalidate(TEST_DEVICE_ID);
+    ASSERT_EQ(cache.GetDeviceDescriptor(TEST_DEVICE_ID, desc, load), EDM_OK);
+    ASSERT_EQ(loadCount, 2);
+
+    auto fail = [](UsbDeviceDescriptor &desc) {
+        return static_cast<int32_t>(USB_DDK_FAILED);
+    };
+    ASSERT_EQ(cache.GetDeviceDescriptor(TEST_DEVICE_ID + 1, desc, fail), USB_DDK_FAILED);
+}
+
+// a replugged device that got the id of the cached one is told apart by its device descriptor
+HWTEST_F(UsbDdkDescriptorCacheTest, ValidateTest, TestSize.Level1)
+{
+    UsbDdkDescriptorCache cache;
+    uint16_t productId = TEST_PRODUCT_ID;
+    auto loadDevice = [&productId](UsbDeviceDescriptor &desc) {
+        desc.idVendor = TEST_VENDOR_ID;
+        desc.idProduct = productId;
+        return static_cast<int32_t>(EDM_OK);
+    };
+    uint32_t loadCount = 0;
+    auto loadConfig = [&loadCount](std::vector<uint8_t> &configBuffer) {
+        ++loadCount;
+        configBuffer = TEST_CONFIG;
+        return static_cast<int32_t>(EDM_OK);
+    };
+    UsbDeviceDescriptor desc = {};
+    ASSERT_EQ(cache.GetDeviceDescriptor(TEST_DEVICE_ID, desc, loadDevice), EDM_OK);
+    UsbDdkConfigDescriptor *config = nullptr;
+    ASSERT_EQ(cache.GetConfigDescriptor(TEST_DEVICE_ID, TEST_CONFIG_INDEX, config, loadConfig), EDM_OK);
+    ASSERT_TRUE(cache.ReleaseConfigDescriptor(config));
+
+    // the same device keeps its descriptors
+    cache.Validate(TEST_DEVICE_ID, desc);
+    ASSERT_EQ(cache.GetConfigDescriptor(TEST_DEVICE_ID, TEST_CONFIG_INDEX, config, loadConfig), EDM_OK);
+    ASSERT_TRUE(cache.ReleaseConfigDescriptor(config));
+    ASSERT_EQ(loadCount, 1);
+
+    // another one drops them and is cached in their place
+    UsbDeviceDescriptor other = desc;
+    other.idProduct = TEST_PRODUCT_ID + 1;
+    cache.Validate(TEST_DEVICE_ID, other);
+    productId = 0;
+    ASSERT_EQ(cache.GetDeviceDescriptor(TEST_DEVICE_ID, desc, loadDevice), EDM_OK);
+    ASSERT_EQ(desc.idProduct, TEST_PRODUCT_ID + 1);
+    ASSERT_EQ(cache.GetConfigDescriptor(TEST_DEVICE_ID, TEST_CONFIG_INDEX, config, loadConfig), EDM_OK);
+    ASSERT_TRUE(cache.ReleaseConfigDescriptor(config));
+    ASSERT_EQ(loadCount, 2);
+
+    // configurations cached without a device descriptor cannot be compared, so they are dropped too
+    cache.Clear();
+    ASSERT_EQ(cache.GetConfigDescriptor(TEST_DEVICE_ID, TEST_CONFIG_INDEX, config, loadConfig), EDM_OK);
+    ASSERT_TRUE(cache.ReleaseConfigDescriptor(config));
+    cache.Validate(TEST_DEVICE_ID, desc);
+    ASSERT_EQ(cache.GetConfigDescriptor(TEST_DEVICE_ID, TEST_CONFIG_INDEX, config, loadConfig), EDM_OK);
+    ASSERT_TRUE(cache.ReleaseConfigDescriptor(config));
+    ASSERT_EQ(loadCount, 4);
+}
+
+// a claim only marks the device, its descriptors are validated when the device descriptor is requested next
+HWTEST_F(UsbDdkDescriptorCacheTest, RequestValidationTest, TestSize.Level1)
+{
+    UsbDdkDescriptorCache cache;
+    uint16_t productId = TEST_PRODUCT_ID;
+    uint32_t deviceLoadCount = 0;
+    auto loadDevice = [&productId, &deviceLoadCount](UsbDeviceDescriptor &desc) {
+        ++deviceLoadCount;
+        desc.idVendor = TEST_VENDOR_ID;
+        desc.idProduct = productId;
+        return static_cast<int32_t>(EDM_OK);
+    };
+    uint32_t loadCount = 0;
+    auto loadConfig = [&loadCount](std::vector<uint8_t> &configBuffer) {
+        ++loadCount;
+        configBuffer = TEST_CONFIG;
+        return static_cast<int32_t>(EDM_OK);
+    };
+    // a device without cached descriptors needs no validation
+    cache.RequestValidation(TEST_DEVICE_ID);
+    ASSERT_FALSE(cache.NeedsValidation(TEST_DEVICE_ID));
+
+    UsbDeviceDescriptor desc = {};
+    ASSERT_EQ(cache.GetDeviceDescriptor(TEST_DEVICE_ID, desc, loadDevice), EDM_OK);
+    UsbDdkConfigDescriptor *config = nullptr;
+    ASSERT_EQ(cache.GetConfigDescriptor(TEST_DEVICE_ID, TEST_CONFIG_INDEX, config, loadConfig), EDM_OK);
+    ASSERT_TRUE(cache.ReleaseConfigDescriptor(config));
+
+    // an unchanged device keeps its configurations
+    cache.RequestValidation(TEST_DEVICE_ID);
+    ASSERT_EQ(deviceLoadCount, 1);
+    ASSERT_TRUE(cache.NeedsValidation(TEST_DEVICE_ID));
+    ASSERT_EQ(cache.GetDeviceDescriptor(TEST_DEVICE_ID, desc, loadDevice), EDM_OK);
+    ASSERT_EQ(deviceLoadCount, 2);
+    ASSERT_FALSE(cache.NeedsValidation(TEST_DEVICE_ID));
+    ASSERT_EQ(cache.GetConfigDescriptor(TEST_DEVICE_ID, TEST_CONFIG_INDEX, config, loadConfig), EDM_OK);
+    ASSERT_TRUE(cache.ReleaseConfigDescriptor(config));
+    ASSERT_EQ(loadCount, 1);
+
+    // a replugged one drops them
+    cache.RequestValidation(TEST_DEVICE_ID);
+    productId = TEST_PRODUCT_ID + 1;
+    ASSERT_EQ(cache.GetDeviceDescriptor(TEST_DEVICE_ID, desc, loadDevice), EDM_OK);
+    ASSERT_EQ(desc.idProduct, TEST_PRODUCT_ID + 1);
+    ASSERT_EQ(cache.GetConfigDescriptor(TEST_DEVICE_ID, TEST_CONFIG_INDEX, config, loadConfig), EDM_OK);
+    ASSERT_TRUE(cache.ReleaseConfigDescriptor(config));
+    ASSERT_EQ(loadCount, 2);
+    ASSERT_EQ(cache.GetDeviceDescriptor(TEST_DEVICE_ID, desc, loadDevice), EDM_OK);
+    ASSERT_EQ(deviceLoadCount, 3);
+}
+
+HWTEST_F(UsbDdkDescriptorCacheTest, ConfigDescriptorTest, TestSize.Level1)
+{
+    UsbDdkDescriptorCache cache;
+    uint32_t loadCount = 0;
+    auto load = [&loadCount](std::vector<uint8_t> &configBuffer) {
+        ++loadCount;
+        configBuffer = TEST_CONFIG;
+        return static_cast<int32_t>(EDM_OK);
+    };
+    UsbDdkConfigDescriptor *first = nullptr;
+    UsbDdkConfigDescriptor *second = nullptr;
+    ASSERT_EQ(cache.GetConfigDescriptor(TEST_DEVICE_ID, TEST_CONFIG_INDEX, first, load), EDM_OK);
+    ASSERT_EQ(cache.GetConfigDescriptor(TEST_DEVICE_ID, TEST_CONFIG_INDEX, second, load), EDM_OK);
+    ASSERT_EQ(loadCount, 1);
+    ASSERT_EQ(first, second);
+    ASSERT_EQ(first->configDescriptor.bNumInterfaces, 1);
+    ASSERT_EQ(first->interface[0].altsetting[0].endPoint[0].endpointDescriptor.bEndpointAddress, 0x81);
+
+    // an invalidated configuration stays valid until the last caller releases it
+    cache.Invalidate(TEST_DEVICE_ID);
+    ASSERT_TRUE(cache.ReleaseConfigDescriptor(first));
+    ASSERT_EQ(second->configDescriptor.bConfigurationValue, 1);
+    ASSERT_TRUE(cache.ReleaseConfigDescriptor(second));
+    ASSERT_FALSE(cache.ReleaseConfigDescriptor(second));
+
+    ASSERT_EQ(cache.GetConfigDescriptor(TEST_DEVICE_ID, TEST_CONFIG_INDEX, first, load), EDM_OK);
+    ASSERT_EQ(loadCount, 2);
+    cache.Clear();
+    ASSERT_TRUE(cache.ReleaseConfigDescriptor(first));
+}
+
+HWTEST_F(UsbDdkDescriptorCacheTest, ConfigDescriptorViewTest, TestSize.Level1)
+{
+    UsbDdkDescriptorCache cache;
+    uint32_t loadCount = 0;
+    auto load = [&loadCount](std::vector<uint8_t> &configBuffer) {
+        ++loadCount;
+        configBuffer = TEST_CONFIG;
+        return static_cast<int32_t>(EDM_OK);
+    };
+    const UsbDdkDescriptorView *view = nullptr;
+    UsbDdkConfigDescriptor *config = nullptr;
+    ASSERT_EQ(cache.GetConfigDescriptorView(TEST_DEVICE_ID, TEST_CONFIG_INDEX, view, load), EDM_OK);
+    ASSERT_EQ(cache.GetConfigDescriptor(TEST_DEVICE_ID, TEST_CONFIG_INDEX, config, load), EDM_OK);
+    ASSERT_EQ(loadCount, 1);
+    ASSERT_NE(view->GetEndpoint(0, 0, 0x81), nullptr);
+
+    cache.Invalidate(TEST_DEVICE_ID);
+    ASSERT_TRUE(cache.ReleaseConfigDescriptor(config));
+    ASSERT_EQ(view->GetConfig()->bConfigurationValue, 1);
+    ASSERT_FALSE(cache.ReleaseConfigDescriptorView(nullptr));
+    ASSERT_TRUE(cache.ReleaseConfigDescriptorView(view));
+    ASSERT_FALSE(cache.ReleaseConfigDescriptorView(view));
+}
+
+HWTEST_F(UsbDdkDescriptorCacheTest, ConfigDescriptorTableTest, TestSize.Level1)
+{
+    UsbDdkDescriptorCache cache;
+    std::vector<uint8_t> loaded;
+    auto load = [&loaded](uint8_t configIndex, std::vector<uint8_t> &configBuffer) {
+        loaded.push_back(configIndex);
+        configBuffer = TEST_CONFIG;
+        configBuffer[5] = configIndex;
+        return static_cast<int32_t>(EDM_OK);
+    };
+    // a configuration loaded on its own is not loaded again for the table
+    UsbDdkConfigDescriptor *config = nullptr;
+    ASSERT_EQ(cache.GetConfigDescriptor(TEST_DEVICE_ID, TEST_CONFIG_INDEX, config, [&load](std::vector<uint8_t> &buf) {
+        return load(TEST_CONFIG_INDEX, buf);
+    }), EDM_OK);
+    ASSERT_TRUE(cache.ReleaseConfigDescriptor(config));
+
+    UsbDdkConfigDescriptorTable *first = nullptr;
+    UsbDdkConfigDescriptorTable *second = nullptr;
+    ASSERT_EQ(cache.GetConfigDescriptorTable(TEST_DEVICE_ID, 2, first, load), EDM_OK);
+    ASSERT_EQ(cache.GetConfigDescriptorTable(TEST_DEVICE_ID, 2, second, load), EDM_OK);
+    ASSERT_EQ(first, second);
+    ASSERT_EQ(loaded, std::vector<uint8_t>({1, 2}));
+    ASSERT_EQ(first->numConfigurations, 2);
+    ASSERT_EQ(first->configs[2]->configDescriptor.bConfigurationValue, 2);
+
+    cache.Invalidate(TEST_DEVICE_ID);
+    ASSERT_TRUE(cache.ReleaseConfigDescriptorTable(first));
+    ASSERT_NE(second->configs[1], nullptr);
+    ASSERT_TRUE(cache.ReleaseConfigDescriptorTable(second));
+    ASSERT_FALSE(cache.ReleaseConfigDescriptorTable(second));
+}
+
+HWTEST_F(UsbDdkDescriptorCacheTest, ConfigImageTest, TestSize.Level1)
+{
+    char directory[] = "/data/local/tmp/usb_ddk_image_XXXXXX";
+    ASSERT_NE(mkdtemp(directory), nullptr);
+    auto loadDevice = [](UsbDeviceDescriptor &desc) {
+        desc.idVendor = TEST_VENDOR_ID;
+        desc.idProduct = TEST_PRODUCT_ID;
+        return static_cast<int32_t>(EDM_OK);
+    };
+    uint32_t loadCount = 0;
+    auto load = [&loadCount](std::vector<uint8_t> &configBuffer) {
+        ++loadCount;
+        configBuffer = TEST_CONFIG;
+        return static_cast<int32_t>(EDM_OK);
+    };
+    UsbDeviceDescriptor desc = {};
+    UsbDdkConfigDescriptor *config = nullptr;
+    {
+        // the first instance loads and parses the configuration and writes its image
+        UsbDdkDescriptorCache cache;
+        cache.SetImageDirectory(directory);
+        ASSERT_EQ(cache.GetDeviceDescriptor(TEST_DEVICE_ID, desc, loadDevice), EDM_OK);
+        ASSERT_EQ(cache.GetConfigDescriptor(TEST_DEVICE_ID, TEST_CONFIG_INDEX, config, load), EDM_OK);
+        ASSERT_TRUE(cache.ReleaseConfigDescriptor(config));
+        ASSERT_EQ(loadCount, 1);
+    }
+
+    // a later instance maps the image, for any device of the same model
+    UsbDdkDescriptorCache cache;
+    cache.SetImageDirectory(directory);
+    ASSERT_EQ(cache.GetDeviceDescriptor(TEST_DEVICE_ID + 1, desc, loadDevice), EDM_OK);
+    ASSERT_EQ(cache.GetConfigDescriptor(TEST_DEVICE_ID + 1, TEST_CONFIG_INDEX, config, load), EDM_OK);
+    ASSERT_EQ(loadCount, 1);
+    ASSERT_EQ(config->interface[0].altsetting[0].endPoint[0].endpointDescriptor.bEndpointAddress, 0x81);
+    const UsbDdkDescriptorView *view = nullptr;
+    ASSERT_EQ(cache.GetConfigDescriptorView(TEST_DEVICE_ID + 1, TEST_CONFIG_INDEX, view, load), EDM_OK);
+    ASSERT_EQ(loadCount, 1);
+    ASSERT_NE(view->GetEndpoint(0, 0, 0x81), nullptr);
+    ASSERT_TRUE(cache.ReleaseConfigDescriptorView(view));
+    ASSERT_TRUE(cache.ReleaseConfigDescriptor(config));
+
+    // without a device descriptor the model is unknown, so the configuration is loaded
+    ASSERT_EQ(cache.GetConfigDescriptor(TEST_DEVICE_ID + 2, TEST_CONFIG_INDEX, config, load), EDM_OK);
+    ASSERT_EQ(loadCount, 2);
+    ASSERT_TRUE(cache.ReleaseConfigDescriptor(config));
+    cache.Clear();
+
+    std::string image = std::string(directory) + "/usb_1234_5678_0000_1.cfg";
+    ASSERT_EQ(unlink(image.c_str()), 0);
+    ASSERT_EQ(rmdir(directory), 0);
+}
+
+HWTEST_F(UsbDdkDescriptorCacheTest, InvalidConfigTest, TestSize.Level1)
+{
+    UsbDdkDescriptorCache cache;
+    auto load = [](std::vector<uint8_t> &configBuffer) {
+        configBuffer = {0x09, 0x02};
+        return static_cast<int32_t>(EDM_OK);
+    };
+    UsbDdkConfigDescriptor *config = nullptr;
+    ASSERT_LT(cache.GetConfigDescriptor(TEST_DEVICE_ID, TEST_CONFIG_INDEX, config, load), 0);
+    ASSERT_EQ(config, nullptr);
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
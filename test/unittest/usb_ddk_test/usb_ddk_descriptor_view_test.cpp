@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "edm_errors.h"
+#include "hilog_wrapper.h"
+#include "usb_ddk_descriptor_view.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+using namespace testing::ext;
+
+constexpr uint8_t TEST_CS_INTERFACE = 0x24;
+
+// interface 1 with an alternate setting 1 that comes before alternate setting 0, and interface 0 after interface 1
+const std::vector<uint8_t> TEST_CONFIG = {
+    0x09, 0x02, 0x41, 0x00, 0x02, 0x01, 0x00, 0x80, 0x32,
+    0x08, 0x0b, 0x00, 0x02, 0x0e, 0x03, 0x00, 0x00,
+    0x09, 0x04, 0x01, 0x01, 0x02, 0x0e, 0x02, 0x00, 0x00,
+    0x07, 0x05, 0x81, 0x05, 0x00, 0x04, 0x01,
+    0x07, 0x05, 0x01, 0x05, 0x00, 0x02, 0x01,
+    0x09, 0x04, 0x01, 0x00, 0x00, 0x0e, 0x02, 0x00, 0x00,
+    0x03, 0x24, 0x01,
+    0x09, 0x04, 0x00, 0x00, 0x00, 0x0e, 0x01, 0x00, 0x00,
+    0x04, 0x24, 0x02, 0x00,
+};
+
+class UsbDdkDescriptorViewTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        EDM_LOGD(MODULE_USB_DDK, "UsbDdkDescriptorViewTest SetUp");
+    }
+    void TearDown() override
+    {
+        EDM_LOGD(MODULE_USB_DDK, "UsbDdkDescriptorViewTest TearDown");
+    }
+};
+
+HWTEST_F(UsbDdkDescriptorViewTest, LookupTest, TestSize.Level1)
+{
+    std::unique_ptr<UsbDdkDescriptorView> view;
+    ASSERT_EQ(UsbDdkDescriptorView::Create(TEST_CONFIG.data(), TEST_CONFIG.size(), view), EDM_OK);
+    ASSERT_EQ(view->GetConfig()->bNumInterfaces, 2);
+
+    const UsbInterfaceDescriptor *intf = view->GetInterface(1, 0);
+    ASSERT_NE(intf, nullptr);
+    ASSERT_EQ(reinterpret_cast<const uint8_t *>(intf), TEST_CONFIG.data() + 40);
+    intf = view->GetInterface(1, 1);
+    ASSERT_NE(intf, nullptr);
+    ASSERT_EQ(intf->bNumEndpoints, 2);
+    ASSERT_NE(view->GetInterface(0, 0), nullptr);
+    ASSERT_EQ(view->GetInterface(0, 1), nullptr);
+    ASSERT_EQ(view->GetInterface(2, 0), nullptr);
+
+    const UsbEndpointDescriptor *endpoint = view->GetEndpoint(1, 1, 0x81);
+    ASSERT_NE(endpoint, nullptr);
+    ASSERT_EQ(endpoint->wMaxPacketSize, 0x400);
+    endpoint = view->GetEndpoint(1, 1, 0x01);
+    ASSERT_NE(endpoint, nullptr);
+    ASSERT_EQ(endpoint->wMaxPacketSize, 0x200);
+    ASSERT_EQ(view->GetEndpoint(1, 0, 0x81), nullptr);
+    ASSERT_EQ(view->GetEndpoint(1, 1, 0x82), nullptr);
+}
+
+HWTEST_F(UsbDdkDescriptorViewTest, IteratorTest, TestSize.Level1)
+{
+    std::unique_ptr<UsbDdkDescriptorView> view;
+    ASSERT_EQ(UsbDdkDescriptorView::Create(TEST_CONFIG.data(), TEST_CONFIG.size(), view), EDM_OK);
+
+    UsbDescriptorIterator iter;
+    view->InitIterator(UsbDdkDescriptorView::ALL_DESCRIPTOR_TYPES, iter);
+    uint32_t count = 0;
+    for (const uint8_t *desc = view->Next(iter); desc != nullptr; desc = view->Next(iter)) {
+        ++count;
+    }
+    ASSERT_EQ(count, 9);
+
+    view->InitIterator(TEST_CS_INTERFACE, iter);
+    const uint8_t *desc = view->Next(iter);
+    ASSERT_NE(desc, nullptr);
+    ASSERT_EQ(desc[2], 0x01);
+    desc = view->Next(iter);
+    ASSERT_NE(desc, nullptr);
+    ASSERT_EQ(desc[2], 0x02);
+    ASSERT_EQ(view->Next(iter), nullptr);
+
+    // the scope of an alternate setting ends at the next interface descriptor
+    ASSERT_TRUE(view->InitIterator(1, 0, TEST_CS_INTERFACE, iter));
+    desc = view->Next(iter);
+    ASSERT_NE(desc, nullptr);
+    ASSERT_EQ(desc[2], 0x01);
+    ASSERT_EQ(view->Next(iter), nullptr);
+    ASSERT_FALSE(view->InitIterator(3, 0, TEST_CS_INTERFACE, iter));
+}
+
+HWTEST_F(UsbDdkDescriptorViewTest, InvalidConfigTest, TestSize.Level1)
+{
+    std::unique_ptr<UsbDdkDescriptorView> view;
+    ASSERT_EQ(UsbDdkDescriptorView::Create(TEST_CONFIG.data(), 5, view), USB_DDK_INVALID_OPERATION);
+    ASSERT_EQ(UsbDdkDescriptorView::Create(TEST_CONFIG.data() + 9, TEST_CONFIG.size() - 9, view),
+        USB_DDK_INVALID_OPERATION);
+
+    // a truncated descriptor ends the index
+    std::vector<uint8_t> truncated(TEST_CONFIG.begin(), TEST_CONFIG.begin() + 30);
+    ASSERT_EQ(UsbDdkDescriptorView::Create(truncated.data(), truncated.size(), view), EDM_OK);
+    ASSERT_NE(view->GetInterface(1, 1), nullptr);
+    ASSERT_EQ(view->GetEndpoint(1, 1, 0x81), nullptr);
+}
+
+HWTEST_F(UsbDdkDescriptorViewTest, ParsedInterfaceTest, TestSize.Level1)
+{
+    std::unique_ptr<UsbDdkDescriptorView> view;
+    ASSERT_EQ(UsbDdkDescriptorView::Create(TEST_CONFIG.data(), TEST_CONFIG.size(), view), EDM_OK);
+
+    const UsbDdkInterface *intf = nullptr;
+    ASSERT_EQ(view->GetParsedInterface(1, intf), EDM_OK);
+    ASSERT_NE(intf, nullptr);
+    ASSERT_EQ(intf->numAltsetting, 2);
+    const UsbDdkInterfaceDescriptor &alt1 = intf->altsetting[0];
+    ASSERT_EQ(alt1.interfaceDescriptor.bAlternateSetting, 1);
+    ASSERT_EQ(alt1.interfaceDescriptor.bNumEndpoints, 2);
+    ASSERT_EQ(alt1.endPoint[0].endpointDescriptor.wMaxPacketSize, 0x400);
+    ASSERT_EQ(alt1.endPoint[1].endpointDescriptor.bEndpointAddress, 0x01);
+    const UsbDdkInterfaceDescriptor &alt0 = intf->altsetting[1];
+    ASSERT_EQ(alt0.interfaceDescriptor.bAlternateSetting, 0);
+    ASSERT_EQ(alt0.extra, TEST_CONFIG.data() + 49);
+    ASSERT_EQ(alt0.extraLength, 3);
+
+    const UsbDdkInterface *again = nullptr;
+    ASSERT_EQ(view->GetParsedInterface(1, again), EDM_OK);
+    ASSERT_EQ(again, intf);
+
+    ASSERT_EQ(view->GetParsedInterface(0, intf), EDM_OK);
+    ASSERT_NE(intf, nullptr);
+    ASSERT_EQ(intf->numAltsetting, 1);
+    ASSERT_EQ(intf->altsetting[0].extraLength, 4);
+    ASSERT_EQ(view->GetParsedInterface(2, intf), EDM_OK);
+    ASSERT_EQ(intf, nullptr);
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <mutex>
+#include <vector>
+#include "edm_errors.h"
+#include "hilog_wrapper.h"
+#include "usb_ddk_iso_stream.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+using namespace testing::ext;
+
+constexpr uint32_t TEST_BUFFER_SIZE = 4096;
+constexpr uint32_t TEST_PACKET_SIZE = 64;
+constexpr uint32_t TEST_PACKETS_PER_TRANSFER = 4;
+constexpr uint32_t TEST_TRANSFER_COUNT = 3;
+constexpr uint32_t TEST_TIMEOUT = 1000;
+
+class UsbDdkIsoStreamTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        EDM_LOGD(MODULE_USB_DDK, "UsbDdkIsoStreamTest SetUp");
+    }
+    void TearDown() override
+    {
+        EDM_LOGD(MODULE_USB_DDK, "UsbDdkIsoStreamTest TearDown");
+    }
+
+    uint8_t buffer_[TEST_BUFFER_SIZE] = {0};
+    UsbDeviceMemMap devMmap_ = {buffer_, TEST_BUFFER_SIZE, 0, TEST_BUFFER_SIZE, 0};
+    UsbIsoStreamParams params_ = {TEST_PACKET_SIZE, TEST_PACKETS_PER_TRANSFER, TEST_TRANSFER_COUNT};
+};
+
+HWTEST_F(UsbDdkIsoStreamTest, InStreamTest, TestSize.Level1)
+{
+    constexpr uint32_t shortLength = TEST_PACKET_SIZE + TEST_PACKET_SIZE / 2;
+    std::mutex mutex;
+    uint32_t transferCount = 0;
+    auto transfer = [&](const UsbRequestPipe &pipe, UsbDeviceMemMap &devMmap) {
+        std::lock_guard<std::mutex> lock(mutex);
+        EXPECT_EQ(devMmap.bufferLength, TEST_PACKET_SIZE * TEST_PACKETS_PER_TRANSFER);
+        devMmap.transferedLength = shortLength;
+        buffer_[devMmap.offset] = static_cast<uint8_t>(devMmap.offset);
+        ++transferCount;
+        return static_cast<int32_t>(EDM_OK);
+    };
+    UsbRequestPipe pipe = {0, 0, 0x81};
+    std::unique_ptr<UsbDdkIsoStream> stream;
+    ASSERT_EQ(UsbDdkIsoStream::Create(pipe, transfer, devMmap_, TEST_BUFFER_SIZE, 0, params_, stream), EDM_OK);
+
+    UsbIsoPacketDescriptor *last = nullptr;
+    for (uint32_t i = 0; i < TEST_TRANSFER_COUNT * 2; ++i) {
+        UsbIsoPacketDescriptor *packets = nullptr;
+        uint32_t packetCount = 0;
+        ASSERT_EQ(stream->Acquire(TEST_TIMEOUT, packets, packetCount), EDM_OK);
+        ASSERT_EQ(packetCount, TEST_PACKETS_PER_TRANSFER);
+        ASSERT_NE(packets, last);
+        ASSERT_EQ(buffer_[packets[0].offset], static_cast<uint8_t>(packets[0].offset));
+        ASSERT_EQ(packets[0].actualLength, TEST_PACKET_SIZE);
+        ASSERT_EQ(packets[1].actualLength, TEST_PACKET_SIZE / 2);
+        ASSERT_EQ(packets[2].actualLength, 0);
+        ASSERT_EQ(packets[1].offset, packets[0].offset + TEST_PACKET_SIZE);
+        ASSERT_EQ(stream->Submit(packets), EDM_OK);
+        last = packets;
+    }
+}
+
+HWTEST_F(UsbDdkIsoStreamTest, OutStreamTest, TestSize.Level1)
+{
+    std::vector<uint8_t> sent;
+    auto transfer = [&](const UsbRequestPipe &pipe, UsbDeviceMemMap &devMmap) {
+        sent.assign(buffer_ + devMmap.offset, buffer_ + devMmap.offset + devMmap.bufferLength);
+        devMmap.transferedLength = devMmap.bufferLength;
+        return static_cast<int32_t>(EDM_OK);
+    };
+    UsbRequestPipe pipe = {0, 0, 0x01};
+    std::unique_ptr<UsbDdkIsoStream> stream;
+    ASSERT_EQ(UsbDdkIsoStream::Create(pipe, transfer, devMmap_, TEST_BUFFER_SIZE, 0, params_, stream), EDM_OK);
+
+    // all transfers of an OUT stream are held by the driver at first
+    UsbIsoPacketDescriptor *first = nullptr;
+    uint32_t packetCount = 0;
+    ASSERT_EQ(stream->Acquire(0, first, packetCount), EDM_OK);
+    for (uint32_t i = 1; i < TEST_TRANSFER_COUNT; ++i) {
+        UsbIsoPacketDescriptor *packets = nullptr;
+        ASSERT_EQ(stream->Acquire(0, packets, packetCount), EDM_OK);
+    }
+    UsbIsoPacketDescriptor *packets = nullptr;
+    ASSERT_EQ(stream->Acquire(0, packets, packetCount), USB_DDK_INVALID_OPERATION);
+
+    const uint32_t lengths[TEST_PACKETS_PER_TRANSFER] = {3, TEST_PACKET_SIZE, 0, 5};
+    for (uint32_t i = 0; i < TEST_PACKETS_PER_TRANSFER; ++i) {
+        first[i].length = lengths[i];
+        for (uint32_t j = 0; j < lengths[i]; ++j) {
+            buffer_[first[i].offset + j] = static_cast<uint8_t>(i + 1);
+        }
+    }
+    ASSERT_EQ(stream->Submit(first), EDM_OK);
+    ASSERT_EQ(stream->Acquire(TEST_TIMEOUT, packets, packetCount), EDM_OK);
+    ASSERT_EQ(packets, first);
+
+    std::vector<uint8_t> expected;
+    for (uint32_t i = 0; i < TEST_PACKETS_PER_TRANSFER; ++i) {
+        expected.insert(expected.end(), lengths[i], static_cast<uint8_t>(i + 1));
+        ASSERT_EQ(packets[i].actualLength, lengths[i]);
+    }
+    ASSERT_EQ(sent, expected);
+}
+
+HWTEST_F(UsbDdkIsoStreamTest, InvalidParamsTest, TestSize.Level1)
+{
+    auto transfer = [](const UsbRequestPipe &pipe, UsbDeviceMemMap &devMmap) {
+        return static_cast<int32_t>(EDM_OK);
+    };
+    UsbRequestPipe pipe = {0, 0, 0x81};
+    std::unique_ptr<UsbDdkIsoStream> stream;
+    UsbIsoStreamParams params = {TEST_PACKET_SIZE, TEST_PACKETS_PER_TRANSFER, 0};
+    ASSERT_EQ(UsbDdkIsoStream::Create(pipe, transfer, devMmap_, TEST_BUFFER_SIZE, 0, params, stream),
+        USB_DDK_INVALID_PARAMETER);
+    params = {TEST_BUFFER_SIZE, TEST_PACKETS_PER_TRANSFER, TEST_TRANSFER_COUNT};
+    ASSERT_EQ(UsbDdkIsoStream::Create(pipe, transfer, devMmap_, TEST_BUFFER_SIZE, 0, params, stream),
+        USB_DDK_INVALID_PARAMETER);
+    ASSERT_EQ(UsbDdkIsoStream::Create(pipe, transfer, devMmap_, TEST_BUFFER_SIZE, 0, params_, stream), EDM_OK);
+
+    UsbIsoPacketDescriptor packet = {};
+    ASSERT_EQ(stream->Submit(&packet), USB_DDK_INVALID_PARAMETER);
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
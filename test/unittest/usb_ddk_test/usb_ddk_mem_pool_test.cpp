@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "edm_errors.h"
+#include "hilog_wrapper.h"
+#include "usb_ddk_mem_pool.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+using namespace testing::ext;
+
+constexpr uint64_t TEST_DEVICE_ID = 1;
+constexpr uint32_t TEST_SLICE_SIZE = 1000;
+constexpr uint32_t TEST_SLICE_COUNT = 4;
+
+class UsbDdkMemPoolTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        EDM_LOGD(MODULE_USB_DDK, "UsbDdkMemPoolTest SetUp");
+        fd_ = memfd_create("usb_ddk_mem_pool_test", 0);
+        ASSERT_GE(fd_, 0);
+    }
+    void TearDown() override
+    {
+        EDM_LOGD(MODULE_USB_DDK, "UsbDdkMemPoolTest TearDown");
+        close(fd_);
+    }
+
+    int32_t fd_ {-1};
+};
+
+HWTEST_F(UsbDdkMemPoolTest, AllocAndFreeTest, TestSize.Level1)
+{
+    std::unique_ptr<UsbDdkMemMapPool> pool;
+    ASSERT_EQ(UsbDdkMemMapPool::Create(TEST_DEVICE_ID, fd_, TEST_SLICE_SIZE, TEST_SLICE_COUNT, true, pool), EDM_OK);
+
+    UsbDeviceMemMap *devMmaps[TEST_SLICE_COUNT] = {nullptr};
+    for (uint32_t i = 0; i < TEST_SLICE_COUNT; ++i) {
+        ASSERT_EQ(pool->Alloc(devMmaps[i]), EDM_OK);
+        ASSERT_EQ(devMmaps[i]->size, UsbDdkMemMapPool::SLICE_ALIGNMENT);
+        ASSERT_EQ(devMmaps[i]->bufferLength, UsbDdkMemMapPool::SLICE_ALIGNMENT);
+        devMmaps[i]->address[devMmaps[i]->size - 1] = static_cast<uint8_t>(i);
+    }
+    UsbDeviceMemMap *devMmap = nullptr;
+    ASSERT_EQ(pool->Alloc(devMmap), USB_DDK_MEMORY_ERROR);
+
+    pool->Free(devMmaps[1]);
+    ASSERT_EQ(pool->Alloc(devMmap), EDM_OK);
+    ASSERT_EQ(devMmap, devMmaps[1]);
+
+    UsbDeviceMemMapPoolStats stats = {};
+    pool->GetStats(stats);
+    ASSERT_EQ(stats.sliceSize, UsbDdkMemMapPool::SLICE_ALIGNMENT);
+    ASSERT_EQ(stats.sliceCount, TEST_SLICE_COUNT);
+    ASSERT_EQ(stats.inUse, TEST_SLICE_COUNT);
+    ASSERT_EQ(stats.highWaterMark, TEST_SLICE_COUNT);
+    ASSERT_EQ(stats.hits, TEST_SLICE_COUNT + 1);
+    ASSERT_EQ(stats.misses, 1);
+
+    for (uint32_t i = 0; i < TEST_SLICE_COUNT; ++i) {
+        pool->Free(devMmaps[i]);
+    }
+    pool->Free(devMmaps[0]);
+    pool->GetStats(stats);
+    ASSERT_EQ(stats.inUse, 0);
+    ASSERT_EQ(stats.highWaterMark, TEST_SLICE_COUNT);
+}
+
+HWTEST_F(UsbDdkMemPoolTest, TranslateTest, TestSize.Level1)
+{
+    std::unique_ptr<UsbDdkMemMapPool> pool;
+    ASSERT_EQ(UsbDdkMemMapPool::Create(TEST_DEVICE_ID, fd_, TEST_SLICE_SIZE, TEST_SLICE_COUNT, false, pool), EDM_OK);
+
+    UsbDeviceMemMap *first = nullptr;
+    UsbDeviceMemMap *second = nullptr;
+    ASSERT_EQ(pool->Alloc(first), EDM_OK);
+    ASSERT_EQ(pool->Alloc(second), EDM_OK);
+    second->offset = 16;
+
+    uint32_t size = 0;
+    uint32_t offset = 0;
+    ASSERT_TRUE(UsbDdkMemMapPool::Translate(*second, size, offset));
+    ASSERT_EQ(size, UsbDdkMemMapPool::SLICE_ALIGNMENT * TEST_SLICE_COUNT);
+    ASSERT_EQ(offset, static_cast<uint32_t>(second->address - first->address) + second->offset);
+
+    UsbDeviceMemMap other = {nullptr, 0, 0, 0, 0};
+    ASSERT_FALSE(UsbDdkMemMapPool::Translate(other, size, offset));
+
+    // slices are found in the pool they belong to, whatever the order of the pools
+    int32_t otherFd = memfd_create("usb_ddk_mem_pool_test_other", 0);
+    ASSERT_GE(otherFd, 0);
+    std::unique_ptr<UsbDdkMemMapPool> otherPool;
+    ASSERT_EQ(UsbDdkMemMapPool::Create(TEST_DEVICE_ID + 1, otherFd, TEST_SLICE_SIZE, 1, false, otherPool), EDM_OK);
+    UsbDeviceMemMap *third = nullptr;
+    ASSERT_EQ(otherPool->Alloc(third), EDM_OK);
+    ASSERT_TRUE(UsbDdkMemMapPool::Translate(*third, size, offset));
+    ASSERT_EQ(size, UsbDdkMemMapPool::SLICE_ALIGNMENT);
+    ASSERT_EQ(offset, 0);
+    ASSERT_TRUE(UsbDdkMemMapPool::Translate(*first, size, offset));
+    ASSERT_EQ(size, UsbDdkMemMapPool::SLICE_ALIGNMENT * TEST_SLICE_COUNT);
+    ASSERT_EQ(offset, 0);
+    otherPool = nullptr;
+    close(otherFd);
+}
+
+HWTEST_F(UsbDdkMemPoolTest, CreateInvalidTest, TestSize.Level1)
+{
+    std::unique_ptr<UsbDdkMemMapPool> pool;
+    ASSERT_EQ(UsbDdkMemMapPool::Create(TEST_DEVICE_ID, fd_, 0, TEST_SLICE_COUNT, false, pool),
+        USB_DDK_INVALID_PARAMETER);
+    ASSERT_EQ(UsbDdkMemMapPool::Create(TEST_DEVICE_ID, fd_, UINT32_MAX, TEST_SLICE_COUNT, false, pool),
+        USB_DDK_INVALID_PARAMETER);
+    ASSERT_EQ(UsbDdkMemMapPool::Create(TEST_DEVICE_ID, fd_, TEST_SLICE_SIZE, TEST_SLICE_COUNT, false, pool), EDM_OK);
+
+    std::unique_ptr<UsbDdkMemMapPool> other;
+    ASSERT_EQ(UsbDdkMemMapPool::Create(TEST_DEVICE_ID, fd_, TEST_SLICE_SIZE, TEST_SLICE_COUNT, false, other),
+        USB_DDK_DEVICE_BUSY);
+    pool.reset();
+    ASSERT_EQ(UsbDdkMemMapPool::Create(TEST_DEVICE_ID, fd_, TEST_SLICE_SIZE, TEST_SLICE_COUNT, false, other), EDM_OK);
+}
+
+HWTEST_F(UsbDdkMemPoolTest, ResizeDeviceMemoryTest, TestSize.Level1)
+{
+    std::unique_ptr<UsbDdkMemMapPool> pool;
+    ASSERT_EQ(UsbDdkMemMapPool::Create(TEST_DEVICE_ID, fd_, TEST_SLICE_SIZE, TEST_SLICE_COUNT, false, pool), EDM_OK);
+    ASSERT_EQ(UsbDdkMemMapPool::ResizeDeviceMemory(TEST_DEVICE_ID, fd_, TEST_SLICE_SIZE), USB_DDK_DEVICE_BUSY);
+    ASSERT_EQ(lseek(fd_, 0, SEEK_END), UsbDdkMemMapPool::SLICE_ALIGNMENT * TEST_SLICE_COUNT);
+
+    pool.reset();
+    ASSERT_EQ(UsbDdkMemMapPool::ResizeDeviceMemory(TEST_DEVICE_ID, fd_, TEST_SLICE_SIZE), EDM_OK);
+    ASSERT_EQ(lseek(fd_, 0, SEEK_END), TEST_SLICE_SIZE);
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include "edm_errors.h"
+#include "hilog_wrapper.h"
+#include "usb_ddk_read_stream.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+using namespace testing::ext;
+
+constexpr uint32_t TEST_BUFFER_SIZE = 4096;
+constexpr uint32_t TEST_BUFFER_COUNT = 4;
+constexpr uint32_t TEST_TIMEOUT = 1000;
+
+class UsbDdkReadStreamTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        EDM_LOGD(MODULE_USB_DDK, "UsbDdkReadStreamTest SetUp");
+    }
+    void TearDown() override
+    {
+        EDM_LOGD(MODULE_USB_DDK, "UsbDdkReadStreamTest TearDown");
+    }
+
+    uint8_t buffer_[TEST_BUFFER_SIZE] = {0};
+    UsbDeviceMemMap devMmap_ = {buffer_, TEST_BUFFER_SIZE, 0, TEST_BUFFER_SIZE, 0};
+};
+
+HWTEST_F(UsbDdkReadStreamTest, ReadInOrderTest, TestSize.Level1)
+{
+    constexpr uint32_t bufferSize = TEST_BUFFER_SIZE / TEST_BUFFER_COUNT;
+    std::atomic<uint32_t> submitted(0);
+    auto transfer = [&](const UsbRequestPipe &pipe, UsbDeviceMemMap &devMmap) {
+        EXPECT_EQ(devMmap.bufferLength, bufferSize);
+        buffer_[devMmap.offset] = static_cast<uint8_t>(devMmap.offset / bufferSize);
+        devMmap.transferedLength = devMmap.bufferLength / 2;
+        ++submitted;
+        return static_cast<int32_t>(EDM_OK);
+    };
+    UsbRequestPipe pipe = {0, 0, 0x81};
+    std::unique_ptr<UsbDdkReadStream> stream;
+    ASSERT_EQ(UsbDdkReadStream::Create(pipe, transfer, devMmap_, TEST_BUFFER_SIZE, 0, TEST_BUFFER_COUNT, stream),
+        EDM_OK);
+
+    for (uint32_t i = 0; i < TEST_BUFFER_COUNT * 2; ++i) {
+        UsbStreamBuffer buffer = {};
+        ASSERT_EQ(stream->Acquire(TEST_TIMEOUT, buffer), EDM_OK);
+        ASSERT_EQ(buffer.index, i % TEST_BUFFER_COUNT);
+        ASSERT_EQ(buffer.offset, buffer.index * bufferSize);
+        ASSERT_EQ(buffer.transferedLength, bufferSize / 2);
+        ASSERT_EQ(buffer.status, EDM_OK);
+        ASSERT_EQ(buffer_[buffer.offset], buffer.index);
+        ASSERT_EQ(stream->Release(buffer), EDM_OK);
+    }
+    stream.reset();
+    ASSERT_GE(submitted.load(), TEST_BUFFER_COUNT * 2);
+}
+
+HWTEST_F(UsbDdkReadStreamTest, InvalidParamsTest, TestSize.Level1)
+{
+    auto transfer = [](const UsbRequestPipe &pipe, UsbDeviceMemMap &devMmap) {
+        return static_cast<int32_t>(EDM_OK);
+    };
+    std::unique_ptr<UsbDdkReadStream> stream;
+    UsbRequestPipe outPipe = {0, 0, 0x01};
+    ASSERT_EQ(UsbDdkReadStream::Create(outPipe, transfer, devMmap_, TEST_BUFFER_SIZE, 0, TEST_BUFFER_COUNT, stream),
+        USB_DDK_INVALID_PARAMETER);
+    UsbRequestPipe inPipe = {0, 0, 0x81};
+    ASSERT_EQ(UsbDdkReadStream::Create(inPipe, transfer, devMmap_, TEST_BUFFER_SIZE, 0, 0, stream),
+        USB_DDK_INVALID_PARAMETER);
+    ASSERT_EQ(UsbDdkReadStream::Create(inPipe, transfer, devMmap_, TEST_BUFFER_SIZE, 0,
+        UsbDdkRequestQueue::MAX_INFLIGHT_PER_ENDPOINT + 1, stream), USB_DDK_INVALID_PARAMETER);
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
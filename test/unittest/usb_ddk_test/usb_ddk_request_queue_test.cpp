@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <set>
+#include <thread>
+#include "edm_errors.h"
+#include "hilog_wrapper.h"
+#include "usb_ddk_request_queue.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+using namespace testing::ext;
+
+constexpr uint32_t TEST_BUFFER_SIZE = 64;
+constexpr uint32_t TEST_REAP_TIMEOUT = 1000;
+
+class UsbDdkRequestQueueTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        EDM_LOGD(MODULE_USB_DDK, "UsbDdkRequestQueueTest SetUp");
+    }
+    void TearDown() override
+    {
+        EDM_LOGD(MODULE_USB_DDK, "UsbDdkRequestQueueTest TearDown");
+    }
+};
+
+HWTEST_F(UsbDdkRequestQueueTest, SubmitAndReapTest, TestSize.Level1)
+{
+    UsbDdkRequestQueue queue([](const UsbRequestPipe &pipe, UsbDeviceMemMap &devMmap) {
+        devMmap.transferedLength = devMmap.bufferLength;
+        return static_cast<int32_t>(EDM_OK);
+    });
+    uint8_t buffer[TEST_BUFFER_SIZE] = {0};
+    UsbDeviceMemMap devMmap = {buffer, sizeof(buffer), 0, sizeof(buffer), 0};
+    UsbRequestPipe pipe = {0, 0, 0x81};
+    uint64_t requestId = 0;
+    ASSERT_EQ(queue.Submit(pipe, &devMmap, requestId), EDM_OK);
+
+    UsbPipeRequestCompletion completion = {};
+    uint32_t reaped = 0;
+    ASSERT_EQ(queue.Reap(&completion, 1, TEST_REAP_TIMEOUT, reaped), EDM_OK);
+    ASSERT_EQ(reaped, 1);
+    ASSERT_EQ(completion.requestId, requestId);
+    ASSERT_EQ(completion.devMmap, &devMmap);
+    ASSERT_EQ(completion.status, EDM_OK);
+    ASSERT_EQ(completion.transferedLength, sizeof(buffer));
+}
+
+HWTEST_F(UsbDdkRequestQueueTest, ReapWithoutRequestTest, TestSize.Level1)
+{
+    UsbDdkRequestQueue queue([](const UsbRequestPipe &pipe, UsbDeviceMemMap &devMmap) {
+        return static_cast<int32_t>(EDM_OK);
+    });
+    UsbPipeRequestCompletion completion = {};
+    uint32_t reaped = 1;
+    ASSERT_EQ(queue.Reap(&completion, 1, TEST_REAP_TIMEOUT, reaped), EDM_OK);
+    ASSERT_EQ(reaped, 0);
+    ASSERT_EQ(queue.Reap(nullptr, 1, 0, reaped), USB_DDK_INVALID_PARAMETER);
+}
+
+// requests on one endpoint must be able to run at the same time
+HWTEST_F(UsbDdkRequestQueueTest, ConcurrentRequestsTest, TestSize.Level1)
+{
+    constexpr uint32_t requestNum = 8;
+    std::mutex mutex;
+    std::condition_variable cond;
+    uint32_t running = 0;
+    UsbDdkRequestQueue queue([&](const UsbRequestPipe &pipe, UsbDeviceMemMap &devMmap) {
+        std::unique_lock<std::mutex> lock(mutex);
+        ++running;
+        cond.notify_all();
+        bool allRunning = cond.wait_for(lock, std::chrono::milliseconds(TEST_REAP_TIMEOUT),
+            [&running] { return running >= requestNum; });
+        return static_cast<int32_t>(allRunning ? EDM_OK : USB_DDK_TIMEOUT);
+    });
+
+    uint8_t buffer[requestNum][TEST_BUFFER_SIZE] = {};
+    std::vector<UsbDeviceMemMap> devMmaps;
+    for (uint32_t i = 0; i < requestNum; ++i) {
+        devMmaps.push_back({buffer[i], TEST_BUFFER_SIZE, 0, TEST_BUFFER_SIZE, 0});
+    }
+    UsbRequestPipe pipe = {0, 0, 0x02};
+    std::set<uint64_t> requestIds;
+    for (uint32_t i = 0; i < requestNum; ++i) {
+        uint64_t requestId = 0;
+        ASSERT_EQ(queue.Submit(pipe, &devMmaps[i], requestId), EDM_OK);
+        requestIds.insert(requestId);
+    }
+    ASSERT_EQ(requestIds.size(), requestNum);
+
+    uint32_t total = 0;
+    while (total < requestNum) {
+        UsbPipeRequestCompletion completions[requestNum] = {};
+        uint32_t reaped = 0;
+        ASSERT_EQ(queue.Reap(completions, requestNum, TEST_REAP_TIMEOUT, reaped), EDM_OK);
+        for (uint32_t i = 0; i < reaped; ++i) {
+            ASSERT_EQ(completions[i].status, EDM_OK);
+            ASSERT_EQ(requestIds.erase(completions[i].requestId), 1);
+        }
+        total += reaped;
+    }
+}
+
+HWTEST_F(UsbDdkRequestQueueTest, EndpointBusyTest, TestSize.Level1)
+{
+    std::mutex mutex;
+    std::condition_variable cond;
+    bool release = false;
+    UsbDdkRequestQueue queue([&](const UsbRequestPipe &pipe, UsbDeviceMemMap &devMmap) {
+        std::unique_lock<std::mutex> lock(mutex);
+        cond.wait(lock, [&release] { return release; });
+        return static_cast<int32_t>(EDM_OK);
+    });
+
+    uint8_t buffer[TEST_BUFFER_SIZE] = {0};
+    UsbDeviceMemMap devMmap = {buffer, sizeof(buffer), 0, sizeof(buffer), 0};
+    UsbRequestPipe pipe = {0, 0, 0x81};
+    uint64_t requestId = 0;
+    for (uint32_t i = 0; i < UsbDdkRequestQueue::MAX_INFLIGHT_PER_ENDPOINT; ++i) {
+        ASSERT_EQ(queue.Submit(pipe, &devMmap, requestId), EDM_OK);
+    }
+    ASSERT_EQ(queue.Submit(pipe, &devMmap, requestId), USB_DDK_DEVICE_BUSY);
+    UsbRequestPipe otherPipe = {0, 0, 0x82};
+    ASSERT_EQ(queue.Submit(otherPipe, &devMmap, requestId), EDM_OK);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        release = true;
+    }
+    cond.notify_all();
+    queue.Stop();
+    ASSERT_EQ(queue.Submit(pipe, &devMmap, requestId), USB_DDK_INVALID_OPERATION);
+}
+
+// requests dropped by Stop are reaped like the ones that ran
+HWTEST_F(UsbDdkRequestQueueTest, StopCompletesPendingTest, TestSize.Level1)
+{
+    std::mutex mutex;
+    std::condition_variable cond;
+    uint32_t running = 0;
+    bool release = false;
+    UsbDdkRequestQueue queue([&](const UsbRequestPipe &pipe, UsbDeviceMemMap &devMmap) {
+        std::unique_lock<std::mutex> lock(mutex);
+        ++running;
+        cond.notify_all();
+        cond.wait(lock, [&release] { return release; });
+        return static_cast<int32_t>(EDM_OK);
+    });
+
+    uint8_t buffer[TEST_BUFFER_SIZE] = {0};
+    UsbDeviceMemMap devMmap = {buffer, sizeof(buffer), 0, sizeof(buffer), 0};
+    UsbRequestPipe pipe = {0, 0, 0x81};
+    uint64_t requestId = 0;
+    for (uint32_t i = 0; i < UsbDdkRequestQueue::MAX_WORKERS; ++i) {
+        ASSERT_EQ(queue.Submit(pipe, &devMmap, requestId), EDM_OK);
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cond.wait(lock, [&running] { return running == UsbDdkRequestQueue::MAX_WORKERS; });
+    }
+    // every shared worker is busy, but the first request of another endpoint still runs
+    constexpr uint32_t runningNum = UsbDdkRequestQueue::MAX_WORKERS + 1;
+    UsbRequestPipe otherPipe = {0, 0, 0x82};
+    ASSERT_EQ(queue.Submit(otherPipe, &devMmap, requestId), EDM_OK);
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        ASSERT_TRUE(cond.wait_for(lock, std::chrono::milliseconds(TEST_REAP_TIMEOUT),
+            [&running] { return running == runningNum; }));
+    }
+    // the other endpoint has a request running now, so these stay pending
+    constexpr uint32_t pendingNum = 2;
+    std::set<uint64_t> pendingIds;
+    for (uint32_t i = 0; i < pendingNum; ++i) {
+        ASSERT_EQ(queue.Submit(otherPipe, &devMmap, requestId), EDM_OK);
+        pendingIds.insert(requestId);
+    }
+
+    std::thread stopper([&queue] { queue.Stop(); });
+    UsbPipeRequestCompletion completions[pendingNum] = {};
+    uint32_t total = 0;
+    while (total < pendingNum) {
+        uint32_t reaped = 0;
+        ASSERT_EQ(queue.Reap(completions, pendingNum - total, TEST_REAP_TIMEOUT, reaped), EDM_OK);
+        for (uint32_t i = 0; i < reaped; ++i) {
+            ASSERT_EQ(completions[i].status, USB_DDK_INVALID_OPERATION);
+            ASSERT_EQ(completions[i].devMmap, &devMmap);
+            ASSERT_EQ(completions[i].transferedLength, 0);
+            ASSERT_EQ(pendingIds.erase(completions[i].requestId), 1);
+        }
+        total += reaped;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        release = true;
+    }
+    cond.notify_all();
+    stopper.join();
+    // the running requests complete as usual
+    total = 0;
+    UsbPipeRequestCompletion ran[runningNum] = {};
+    while (total < runningNum) {
+        uint32_t reaped = 0;
+        ASSERT_EQ(queue.Reap(ran, runningNum - total, TEST_REAP_TIMEOUT, reaped), EDM_OK);
+        ASSERT_GT(reaped, 0);
+        for (uint32_t i = 0; i < reaped; ++i) {
+            ASSERT_EQ(ran[i].status, EDM_OK);
+        }
+        total += reaped;
+    }
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "edm_errors.h"
+#include "hilog_wrapper.h"
+#include "usb_ddk_transfer_plan.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+using namespace testing::ext;
+
+class UsbDdkTransferPlanTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        EDM_LOGD(MODULE_USB_DDK, "UsbDdkTransferPlanTest SetUp");
+    }
+    void TearDown() override
+    {
+        EDM_LOGD(MODULE_USB_DDK, "UsbDdkTransferPlanTest TearDown");
+    }
+
+    static UsbDdkEndpointDescriptor MakeEndpoint(uint8_t bmAttributes, uint16_t wMaxPacketSize, uint8_t bInterval,
+        const std::vector<uint8_t> &extra = {})
+    {
+        UsbDdkEndpointDescriptor endpoint = {};
+        endpoint.endpointDescriptor = {0x07, 0x05, 0x81, bmAttributes, wMaxPacketSize, bInterval};
+        endpoint.extra = extra.empty() ? nullptr : extra.data();
+        endpoint.extraLength = static_cast<uint32_t>(extra.size());
+        return endpoint;
+    }
+};
+
+HWTEST_F(UsbDdkTransferPlanTest, BulkPlanTest, TestSize.Level1)
+{
+    UsbEndpointTransferPlan plan = {};
+    UsbDdkEndpointDescriptor endpoint = MakeEndpoint(0x02, 0x200, 0);
+    ASSERT_EQ(GetUsbEndpointTransferPlan(endpoint, USB_DDK_SPEED_HIGH, plan), EDM_OK);
+    ASSERT_EQ(plan.transferType, 0x02);
+    ASSERT_EQ(plan.packetSize, 0x200);
+    ASSERT_EQ(plan.intervalUs, 0);
+    ASSERT_EQ(plan.maxBytesPerSecond, 53248000);
+    // one millisecond of a high speed bus, and eight of them in flight
+    ASSERT_EQ(plan.transferSize, 53248);
+    ASSERT_EQ(plan.transferCount, 8);
+
+    // a SuperSpeed endpoint bursts 16 packets, transfers are limited to 256 KiB
+    std::vector<uint8_t> companion = {0x06, 0x30, 0x0f, 0x00, 0x00, 0x00};
+    endpoint = MakeEndpoint(0x02, 0x400, 0, companion);
+    ASSERT_EQ(GetUsbEndpointTransferPlan(endpoint, USB_DDK_SPEED_SUPER, plan), EDM_OK);
+    ASSERT_EQ(plan.packetsPerInterval, 16);
+    ASSERT_EQ(plan.transferSize, 256 * 1024);
+    ASSERT_EQ(plan.transferSize % plan.packetSize, 0);
+    ASSERT_EQ(plan.transferCount, 13);
+}
+
+HWTEST_F(UsbDdkTransferPlanTest, PeriodicPlanTest, TestSize.Level1)
+{
+    // a full speed mouse polled every 10 ms
+    UsbEndpointTransferPlan plan = {};
+    UsbDdkEndpointDescriptor endpoint = MakeEndpoint(0x03, 0x08, 10);
+    ASSERT_EQ(GetUsbEndpointTransferPlan(endpoint, USB_DDK_SPEED_FULL, plan), EDM_OK);
+    ASSERT_EQ(plan.intervalUs, 10000);
+    ASSERT_EQ(plan.maxBytesPerSecond, 800);
+    ASSERT_EQ(plan.transferSize, 8);
+    ASSERT_EQ(plan.transferCount, 2);
+
+    // a high bandwidth isochronous endpoint moves three packets in every microframe
+    endpoint = MakeEndpoint(0x05, 0x1400, 1);
+    ASSERT_EQ(GetUsbEndpointTransferPlan(endpoint, USB_DDK_SPEED_HIGH, plan), EDM_OK);
+    ASSERT_EQ(plan.packetSize, 0x400);
+    ASSERT_EQ(plan.packetsPerInterval, 3);
+    ASSERT_EQ(plan.intervalUs, 125);
+    ASSERT_EQ(plan.maxBytesPerSecond, 24576000);
+    ASSERT_EQ(plan.transferSize, 8 * 3 * 0x400);
+    ASSERT_EQ(plan.transferCount, 8);
+
+    // a SuperSpeed isochronous endpoint is limited by the bytes per interval of its companion descriptor, which
+    // follows a class-specific descriptor here
+    std::vector<uint8_t> extra = {0x03, 0x25, 0x01, 0x06, 0x30, 0x01, 0x01, 0x00, 0x0c};
+    endpoint = MakeEndpoint(0x05, 0x400, 1, extra);
+    ASSERT_EQ(GetUsbEndpointTransferPlan(endpoint, USB_DDK_SPEED_SUPER, plan), EDM_OK);
+    ASSERT_EQ(plan.packetsPerInterval, 4);
+    ASSERT_EQ(plan.maxBytesPerSecond, 0xc00 * 8000);
+    ASSERT_EQ(plan.transferSize, 8 * 4 * 0x400);
+    ASSERT_EQ(plan.transferCount, 7);
+}
+
+HWTEST_F(UsbDdkTransferPlanTest, InvalidEndpointTest, TestSize.Level1)
+{
+    UsbEndpointTransferPlan plan = {};
+    UsbDdkEndpointDescriptor endpoint = MakeEndpoint(0x02, 0x40, 0);
+    ASSERT_EQ(GetUsbEndpointTransferPlan(endpoint, USB_DDK_SPEED_LOW, plan), USB_DDK_INVALID_PARAMETER);
+    ASSERT_EQ(GetUsbEndpointTransferPlan(endpoint, static_cast<UsbDdkSpeed>(0), plan), USB_DDK_INVALID_PARAMETER);
+    endpoint = MakeEndpoint(0x00, 0x40, 0);
+    ASSERT_EQ(GetUsbEndpointTransferPlan(endpoint, USB_DDK_SPEED_FULL, plan), USB_DDK_INVALID_PARAMETER);
+    endpoint = MakeEndpoint(0x03, 0x00, 1);
+    ASSERT_EQ(GetUsbEndpointTransferPlan(endpoint, USB_DDK_SPEED_HIGH, plan), USB_DDK_INVALID_PARAMETER);
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
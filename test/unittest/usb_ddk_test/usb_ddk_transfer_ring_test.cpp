@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <poll.h>
+#include <set>
+#include <thread>
+#include "edm_errors.h"
+#include "hilog_wrapper.h"
+#include "usb_ddk_transfer_ring.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+using namespace testing::ext;
+
+constexpr uint32_t TEST_BUFFER_SIZE = 16384;
+constexpr uint32_t TEST_RING_ENTRIES = 8;
+constexpr uint32_t TEST_DATA_OFFSET = 8192;
+constexpr uint32_t TEST_DATA_LENGTH = 64;
+constexpr int32_t TEST_POLL_TIMEOUT = 1000;
+
+class UsbDdkTransferRingTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        EDM_LOGD(MODULE_USB_DDK, "UsbDdkTransferRingTest SetUp");
+    }
+    void TearDown() override
+    {
+        EDM_LOGD(MODULE_USB_DDK, "UsbDdkTransferRingTest TearDown");
+    }
+
+    alignas(64) uint8_t buffer_[TEST_BUFFER_SIZE] = {0};
+    UsbDeviceMemMap devMmap_ = {buffer_, TEST_BUFFER_SIZE, 0, TEST_DATA_OFFSET, 0};
+};
+
+HWTEST_F(UsbDdkTransferRingTest, SubmitAndCompleteTest, TestSize.Level1)
+{
+    auto transfer = [](const UsbRequestPipe &pipe, UsbDeviceMemMap &devMmap) {
+        devMmap.transferedLength = devMmap.bufferLength;
+        return static_cast<int32_t>(EDM_OK);
+    };
+    std::unique_ptr<UsbDdkTransferRing> ring;
+    ASSERT_EQ(UsbDdkTransferRing::Create(transfer, devMmap_, TEST_BUFFER_SIZE, 0, TEST_RING_ENTRIES, ring), EDM_OK);
+
+    constexpr uint32_t rounds = 4;
+    for (uint32_t round = 0; round < rounds; ++round) {
+        std::set<uint64_t> userData;
+        for (uint32_t i = 0; i < TEST_RING_ENTRIES; ++i) {
+            UsbRingSubmission *submission = nullptr;
+            ASSERT_EQ(ring->GetSubmission(submission), EDM_OK);
+            *submission = {round * TEST_RING_ENTRIES + i, 0, TEST_DATA_OFFSET + i * TEST_DATA_LENGTH,
+                TEST_DATA_LENGTH, 0, 0x81};
+            userData.insert(submission->userData);
+        }
+        ring->Submit();
+
+        while (!userData.empty()) {
+            struct pollfd fds = {ring->GetEventFd(), POLLIN, 0};
+            ASSERT_EQ(poll(&fds, 1, TEST_POLL_TIMEOUT), 1);
+            uint64_t value = 0;
+            (void)read(ring->GetEventFd(), &value, sizeof(value));
+            UsbRingCompletion *completion = nullptr;
+            ring->PeekCompletion(completion);
+            while (completion != nullptr) {
+                ASSERT_EQ(completion->status, EDM_OK);
+                ASSERT_EQ(completion->transferedLength, TEST_DATA_LENGTH);
+                ASSERT_EQ(userData.erase(completion->userData), 1);
+                ring->AdvanceCompletion(1);
+                ring->PeekCompletion(completion);
+            }
+        }
+    }
+}
+
+HWTEST_F(UsbDdkTransferRingTest, RingFullTest, TestSize.Level1)
+{
+    auto transfer = [](const UsbRequestPipe &pipe, UsbDeviceMemMap &devMmap) {
+        return static_cast<int32_t>(EDM_OK);
+    };
+    std::unique_ptr<UsbDdkTransferRing> ring;
+    ASSERT_EQ(UsbDdkTransferRing::Create(transfer, devMmap_, TEST_BUFFER_SIZE, 0, TEST_RING_ENTRIES, ring), EDM_OK);
+
+    // nothing is consumed before the submission, so the ring is full after all entries are obtained
+    UsbRingSubmission *submission = nullptr;
+    for (uint32_t i = 0; i < TEST_RING_ENTRIES; ++i) {
+        ASSERT_EQ(ring->GetSubmission(submission), EDM_OK);
+        *submission = {i, 0, TEST_BUFFER_SIZE, TEST_DATA_LENGTH, 0, 0x81};
+    }
+    ASSERT_EQ(ring->GetSubmission(submission), USB_DDK_DEVICE_BUSY);
+    ring->Submit();
+
+    // the buffers are out of the memory map, so every request is rejected
+    uint32_t completed = 0;
+    while (completed < TEST_RING_ENTRIES) {
+        struct pollfd fds = {ring->GetEventFd(), POLLIN, 0};
+        ASSERT_EQ(poll(&fds, 1, TEST_POLL_TIMEOUT), 1);
+        uint64_t value = 0;
+        (void)read(ring->GetEventFd(), &value, sizeof(value));
+        UsbRingCompletion *completion = nullptr;
+        for (ring->PeekCompletion(completion); completion != nullptr; ring->PeekCompletion(completion)) {
+            ASSERT_EQ(completion->status, USB_DDK_INVALID_PARAMETER);
+            ring->AdvanceCompletion(1);
+            ++completed;
+        }
+    }
+}
+
+// the completion ring never holds more completions than it has room for while the driver does not consume them
+HWTEST_F(UsbDdkTransferRingTest, CompletionRingFullTest, TestSize.Level1)
+{
+    auto transfer = [](const UsbRequestPipe &pipe, UsbDeviceMemMap &devMmap) {
+        devMmap.transferedLength = devMmap.bufferLength;
+        return static_cast<int32_t>(EDM_OK);
+    };
+    std::unique_ptr<UsbDdkTransferRing> ring;
+    ASSERT_EQ(UsbDdkTransferRing::Create(transfer, devMmap_, TEST_BUFFER_SIZE, 0, TEST_RING_ENTRIES, ring), EDM_OK);
+
+    // the completion ring takes twice the entries, the submission ring holds the rest
+    constexpr uint32_t completionEntries = TEST_RING_ENTRIES * 2;
+    constexpr uint32_t total = completionEntries + TEST_RING_ENTRIES;
+    constexpr uint32_t maxRetries = 1000;
+    uint32_t submitted = 0;
+    for (uint32_t retries = 0; submitted < total && retries < maxRetries;) {
+        UsbRingSubmission *submission = nullptr;
+        if (ring->GetSubmission(submission) != EDM_OK) {
+            ring->Submit();
+            ++retries;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        *submission = {submitted, 0, TEST_DATA_OFFSET, TEST_DATA_LENGTH, 0, 0x81};
+        ++submitted;
+    }
+    ring->Submit();
+    ASSERT_EQ(submitted, total);
+
+    // give the worker threads time to overrun the completion ring if they could
+    std::this_thread::sleep_for(std::chrono::milliseconds(TEST_POLL_TIMEOUT / 10));
+
+    // an overwritten completion would be missing and the one that overwrote it would be consumed twice
+    std::set<uint64_t> userData;
+    for (uint64_t i = 0; i < total; ++i) {
+        userData.insert(i);
+    }
+    for (uint32_t retries = 0; !userData.empty() && retries < maxRetries; ++retries) {
+        UsbRingCompletion *completion = nullptr;
+        for (ring->PeekCompletion(completion); completion != nullptr; ring->PeekCompletion(completion)) {
+            ASSERT_EQ(completion->status, EDM_OK);
+            ASSERT_EQ(userData.erase(completion->userData), 1);
+            ring->AdvanceCompletion(1);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_TRUE(userData.empty());
+}
+
+// a buffer inside the rings is rejected, a buffer after them is transferred
+HWTEST_F(UsbDdkTransferRingTest, RingOverlapTest, TestSize.Level1)
+{
+    auto transfer = [](const UsbRequestPipe &pipe, UsbDeviceMemMap &devMmap) {
+        devMmap.transferedLength = devMmap.bufferLength;
+        return static_cast<int32_t>(EDM_OK);
+    };
+    std::unique_ptr<UsbDdkTransferRing> ring;
+    ASSERT_EQ(UsbDdkTransferRing::Create(transfer, devMmap_, TEST_BUFFER_SIZE, 0, TEST_RING_ENTRIES, ring), EDM_OK);
+
+    UsbRingSubmission *submission = nullptr;
+    ASSERT_EQ(ring->GetSubmission(submission), EDM_OK);
+    *submission = {0, 0, 0, TEST_DATA_LENGTH, 0, 0x81};
+    ASSERT_EQ(ring->GetSubmission(submission), EDM_OK);
+    *submission = {1, 0, TEST_DATA_OFFSET, TEST_DATA_LENGTH, 0, 0x81};
+    ring->Submit();
+
+    uint32_t completed = 0;
+    while (completed < 2) {
+        struct pollfd fds = {ring->GetEventFd(), POLLIN, 0};
+        ASSERT_EQ(poll(&fds, 1, TEST_POLL_TIMEOUT), 1);
+        uint64_t value = 0;
+        (void)read(ring->GetEventFd(), &value, sizeof(value));
+        UsbRingCompletion *completion = nullptr;
+        for (ring->PeekCompletion(completion); completion != nullptr; ring->PeekCompletion(completion)) {
+            int32_t status = completion->userData == 0 ? USB_DDK_INVALID_PARAMETER : static_cast<int32_t>(EDM_OK);
+            ASSERT_EQ(completion->status, status);
+            ring->AdvanceCompletion(1);
+            ++completed;
+        }
+    }
+}
+
+// submissions beyond the limit of an endpoint wait for a request of the endpoint to complete instead of failing
+HWTEST_F(UsbDdkTransferRingTest, EndpointLimitTest, TestSize.Level1)
+{
+    std::mutex mutex;
+    std::condition_variable cond;
+    uint32_t running = 0;
+    uint32_t maxRunning = 0;
+    bool release = false;
+    auto transfer = [&](const UsbRequestPipe &pipe, UsbDeviceMemMap &devMmap) {
+        std::unique_lock<std::mutex> lock(mutex);
+        maxRunning = std::max(maxRunning, ++running);
+        cond.notify_all();
+        cond.wait(lock, [&release] { return release; });
+        --running;
+        return static_cast<int32_t>(EDM_OK);
+    };
+    constexpr uint32_t entries = UsbDdkRequestQueue::MAX_INFLIGHT_PER_ENDPOINT * 2;
+    std::unique_ptr<UsbDdkTransferRing> ring;
+    ASSERT_EQ(UsbDdkTransferRing::Create(transfer, devMmap_, TEST_BUFFER_SIZE, 0, entries, ring), EDM_OK);
+
+    constexpr uint32_t total = UsbDdkRequestQueue::MAX_INFLIGHT_PER_ENDPOINT + TEST_RING_ENTRIES;
+    for (uint32_t i = 0; i < total; ++i) {
+        UsbRingSubmission *submission = nullptr;
+        ASSERT_EQ(ring->GetSubmission(submission), EDM_OK);
+        *submission = {i, 0, TEST_DATA_OFFSET, TEST_DATA_LENGTH, 0, 0x81};
+    }
+    ring->Submit();
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        ASSERT_TRUE(cond.wait_for(lock, std::chrono::milliseconds(TEST_POLL_TIMEOUT),
+            [&running] { return running == UsbDdkRequestQueue::MAX_INFLIGHT_PER_ENDPOINT; }));
+    }
+    // give the submitter time to overrun the limit if it could
+    std::this_thread::sleep_for(std::chrono::milliseconds(TEST_POLL_TIMEOUT / 10));
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ASSERT_EQ(maxRunning, UsbDdkRequestQueue::MAX_INFLIGHT_PER_ENDPOINT);
+        release = true;
+    }
+    cond.notify_all();
+
+    uint32_t completed = 0;
+    while (completed < total) {
+        struct pollfd fds = {ring->GetEventFd(), POLLIN, 0};
+        ASSERT_EQ(poll(&fds, 1, TEST_POLL_TIMEOUT), 1);
+        uint64_t value = 0;
+        (void)read(ring->GetEventFd(), &value, sizeof(value));
+        UsbRingCompletion *completion = nullptr;
+        for (ring->PeekCompletion(completion); completion != nullptr; ring->PeekCompletion(completion)) {
+            ASSERT_EQ(completion->status, EDM_OK);
+            ring->AdvanceCompletion(1);
+            ++completed;
+        }
+    }
+}
+
+HWTEST_F(UsbDdkTransferRingTest, InvalidParamsTest, TestSize.Level1)
+{
+    auto transfer = [](const UsbRequestPipe &pipe, UsbDeviceMemMap &devMmap) {
+        return static_cast<int32_t>(EDM_OK);
+    };
+    std::unique_ptr<UsbDdkTransferRing> ring;
+    ASSERT_EQ(UsbDdkTransferRing::Create(transfer, devMmap_, TEST_BUFFER_SIZE, 0, 3, ring),
+        USB_DDK_INVALID_PARAMETER);
+    ASSERT_EQ(UsbDdkTransferRing::Create(transfer, devMmap_, TEST_BUFFER_SIZE, 0, UsbDdkTransferRing::MAX_ENTRIES,
+        ring), USB_DDK_INVALID_PARAMETER);
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
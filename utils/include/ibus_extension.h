@@ -34,6 +34,10 @@ public:
     virtual shared_ptr<DriverInfoExt> ParseDriverInfo(const vector<Metadata> &metadata) = 0;
     virtual shared_ptr<DriverInfoExt> GetNewDriverInfoExtObject() = 0;
     virtual bool MatchDriver(const DriverInfo &driver, const DeviceInfo &device) = 0;
+    // A device matches a driver exactly when the match key of the device is one of the match keys of the driver, so
+    // the devices of a driver are found by key instead of matching every device.
+    virtual bool GetDeviceMatchKey(const DeviceInfo &device, uint64_t &matchKey) = 0;
+    virtual vector<uint64_t> GetDriverMatchKeys(const DriverInfo &driver) = 0;
     virtual int32_t SetDevChangeCallback(shared_ptr<IDevChangeCallback> callback) = 0;
 };
 }